@@ -47,6 +47,11 @@ endif
 export ATMOSPHERE_CXXFLAGS := -fno-rtti -fno-exceptions -std=gnu++23 -Wno-invalid-offsetof
 export ATMOSPHERE_ASFLAGS  :=
 
+# Pass ATMOSPHERE_SF_COMMAND_STATISTICS=1 to record per-command ipc dispatch statistics in stratosphere.
+ifeq ($(ATMOSPHERE_SF_COMMAND_STATISTICS),1)
+export ATMOSPHERE_DEFINES  += -DAMS_SF_COMMAND_STATISTICS_ENABLED=1
+endif
+
 
 ifeq ($(ATMOSPHERE_BOARD),nx-hac-001)
 
@@ -301,6 +301,7 @@ namespace ams::kern {
             u16 m_device_use_count;
             u16 m_device_disable_merge_left_count;
             u16 m_device_disable_merge_right_count;
+            u32 m_subtree_max_free_num_pages;
         public:
             static constexpr ALWAYS_INLINE int Compare(const KMemoryBlock &lhs, const KMemoryBlock &rhs) {
                 if (lhs.GetAddress() < rhs.GetAddress()) {
@@ -311,6 +312,18 @@ namespace ams::kern {
                     return 1;
                 }
             }
+
+            static constexpr ALWAYS_INLINE void Augment(KMemoryBlock &block, const KMemoryBlock *left, const KMemoryBlock *right) {
+                /* Track the largest free block in each subtree, so that free area searches can skip subtrees which are too small. */
+                u32 max_free_num_pages = block.m_memory_state == KMemoryState_Free ? block.m_num_pages : 0;
+                if (left != nullptr) {
+                    max_free_num_pages = std::max(max_free_num_pages, left->m_subtree_max_free_num_pages);
+                }
+                if (right != nullptr) {
+                    max_free_num_pages = std::max(max_free_num_pages, right->m_subtree_max_free_num_pages);
+                }
+                block.m_subtree_max_free_num_pages = max_free_num_pages;
+            }
         public:
             constexpr KProcessAddress GetAddress() const {
                 return m_address;
@@ -336,6 +349,10 @@ namespace ams::kern {
                 return m_memory_state;
             }
 
+            constexpr size_t GetSubtreeMaxFreeNumPages() const {
+                return m_subtree_max_free_num_pages;
+            }
+
             constexpr u16 GetIpcLockCount() const {
                 return m_ipc_lock_count;
             }
@@ -382,7 +399,8 @@ namespace ams::kern {
             constexpr KMemoryBlock(util::ConstantInitializeTag, KProcessAddress addr, u32 np, KMemoryState ms, KMemoryPermission p, KMemoryAttribute attr)
                 : util::IntrusiveRedBlackTreeBaseNode<KMemoryBlock>(util::ConstantInitialize), m_permission(p), m_original_permission(KMemoryPermission_None),
                   m_attribute(attr), m_disable_merge_attribute(), m_address(addr), m_num_pages(np), m_memory_state(ms), m_ipc_lock_count(0),
-                  m_ipc_disable_merge_count(), m_device_use_count(0), m_device_disable_merge_left_count(), m_device_disable_merge_right_count()
+                  m_ipc_disable_merge_count(), m_device_use_count(0), m_device_disable_merge_left_count(), m_device_disable_merge_right_count(),
+                  m_subtree_max_free_num_pages(ms == KMemoryState_Free ? np : 0)
             {
                 /* ... */
             }
@@ -398,6 +416,7 @@ namespace ams::kern {
                 m_device_use_count                 = 0;
                 m_permission                       = p;
                 m_original_permission              = KMemoryPermission_None;
+                m_subtree_max_free_num_pages       = ms == KMemoryState_Free ? np : 0;
                 m_attribute                        = attr;
                 m_disable_merge_attribute          = KMemoryBlockDisableMergeAttribute_None;
             }
@@ -472,6 +491,7 @@ namespace ams::kern {
                 MESOSPHERE_ASSERT(this->Contains(addr));
                 MESOSPHERE_ASSERT(util::IsAligned(GetInteger(addr), PageSize));
 
+                /* NOTE: The new block is inserted as our predecessor, which refreshes our subtree max free page count. */
                 block->m_address                          = m_address;
                 block->m_num_pages                        = (addr - this->GetAddress()) / PageSize;
                 block->m_memory_state                     = m_memory_state;
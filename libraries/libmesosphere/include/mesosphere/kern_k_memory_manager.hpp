@@ -15,7 +15,9 @@
  */
 #pragma once
 #include <mesosphere/kern_common.hpp>
+#include <mesosphere/kern_select_cpu.hpp>
 #include <mesosphere/kern_k_light_lock.hpp>
+#include <mesosphere/kern_k_spin_lock.hpp>
 #include <mesosphere/kern_k_memory_layout.hpp>
 #include <mesosphere/kern_k_page_heap.hpp>
 
@@ -50,7 +52,65 @@ namespace ams::kern {
             };
 
             static constexpr size_t MaxManagerCount = 10;
+
+            struct PageCacheStatistics {
+                size_t cached_size;
+                size_t hit_count;
+                size_t refill_count;
+                size_t drain_count;
+            };
         private:
+            class PageCache {
+                public:
+                    /* Cache single pages and the next block size up; anything larger goes straight to the heap. */
+                    static constexpr s32 NumBlockIndices = 2;
+                    static constexpr size_t Capacities[NumBlockIndices] = { 32, 4 };
+                    static constexpr size_t Offsets[NumBlockIndices]    = {  0, 32 };
+                    static constexpr size_t TotalCapacity               = Offsets[NumBlockIndices - 1] + Capacities[NumBlockIndices - 1];
+
+                    static constexpr size_t MaxBatchCount               = Capacities[0] / 2;
+                    static_assert(Capacities[1] / 2 <= MaxBatchCount);
+
+                    static constexpr size_t GetBatchCount(s32 index) {
+                        return Capacities[index] / 2;
+                    }
+
+                    static constexpr s32 GetAllocateBlockIndex(size_t num_pages, size_t align_pages) {
+                        for (s32 i = 0; i < NumBlockIndices; i++) {
+                            if (num_pages == KPageHeap::GetBlockNumPages(i) && align_pages <= KPageHeap::GetBlockNumPages(i)) {
+                                return i;
+                            }
+                        }
+                        return -1;
+                    }
+
+                    static constexpr s32 GetFreeBlockIndex(KPhysicalAddress address, size_t num_pages) {
+                        for (s32 i = 0; i < NumBlockIndices; i++) {
+                            if (num_pages == KPageHeap::GetBlockNumPages(i) && util::IsAligned(GetInteger(address), KPageHeap::GetBlockSize(i))) {
+                                return i;
+                            }
+                        }
+                        return -1;
+                    }
+                private:
+                    KSpinLock m_lock;
+                    size_t m_counts[NumBlockIndices];
+                    size_t m_hit_count;
+                    size_t m_refill_count;
+                    size_t m_drain_count;
+                    KPhysicalAddress m_blocks[TotalCapacity];
+                public:
+                    PageCache() : m_lock(), m_counts(), m_hit_count(), m_refill_count(), m_drain_count() { /* ... */ }
+
+                    KPhysicalAddress Allocate(s32 index);
+                    bool Free(s32 index, KPhysicalAddress block);
+
+                    size_t Refill(s32 index, const KPhysicalAddress *blocks, size_t num_blocks);
+                    size_t Drain(s32 index, KPhysicalAddress *out_blocks, size_t max_blocks);
+
+                    void AddStatistics(PageCacheStatistics *out);
+            };
+
             class Impl {
                 private:
                     using RefCount = u16;
@@ -62,13 +122,14 @@ namespace ams::kern {
                     }
                 private:
                     KPageHeap m_heap;
+                    PageCache m_page_caches[cpu::NumCores];
                     RefCount *m_page_reference_counts;
                     KVirtualAddress m_management_region;
                     Pool m_pool;
                     Impl *m_next;
                     Impl *m_prev;
                 public:
-                    Impl() : m_heap(), m_page_reference_counts(), m_management_region(Null<KVirtualAddress>), m_pool(), m_next(), m_prev() { /* ... */ }
+                    Impl() : m_heap(), m_page_caches(), m_page_reference_counts(), m_management_region(Null<KVirtualAddress>), m_pool(), m_next(), m_prev() { /* ... */ }
 
                     size_t Initialize(KPhysicalAddress address, size_t size, KVirtualAddress management, KVirtualAddress management_end, Pool p);
 
@@ -76,6 +137,12 @@ namespace ams::kern {
                     KPhysicalAddress AllocateAligned(s32 index, size_t num_pages, size_t align_pages) { return m_heap.AllocateAligned(index, num_pages, align_pages); }
                     void Free(KPhysicalAddress addr, size_t num_pages) { m_heap.Free(addr, num_pages); }
 
+                    KPhysicalAddress AllocateFromPageCache(s32 index);
+                    KPhysicalAddress RefillPageCache(s32 index);
+                    void FreeToPageCache(KPhysicalAddress addr, size_t num_pages);
+                    bool FlushPageCaches();
+                    void AddPageCacheStatistics(PageCacheStatistics *out);
+
                     void SetInitialUsedHeapSize(size_t reserved_size) { m_heap.SetInitialUsedSize(reserved_size); }
 
                     void InitializeOptimizedMemory() { std::memset(GetVoidPointer(m_management_region), 0, CalculateOptimizedProcessOverheadSize(m_heap.GetSize())); }
@@ -89,7 +156,7 @@ namespace ams::kern {
                     constexpr size_t GetSize() const { return m_heap.GetSize(); }
                     constexpr KPhysicalAddress GetEndAddress() const { return m_heap.GetEndAddress(); }
 
-                    size_t GetFreeSize() const { return m_heap.GetFreeSize(); }
+                    size_t GetFreeSize();
 
                     void DumpFreeList() const { return m_heap.DumpFreeList(); }
 
@@ -123,7 +190,7 @@ namespace ams::kern {
                         }
                     }
 
-                    void Close(KPhysicalAddress address, size_t num_pages) {
+                    void Close(KPhysicalAddress address, size_t num_pages, bool use_page_cache) {
                         size_t index = this->GetPageOffset(address);
                         const size_t end = index + num_pages;
 
@@ -143,7 +210,7 @@ namespace ams::kern {
                                 }
                             } else {
                                 if (free_count > 0) {
-                                    this->Free(m_heap.GetAddress() + free_start * PageSize, free_count);
+                                    this->Release(m_heap.GetAddress() + free_start * PageSize, free_count, use_page_cache);
                                     free_count = 0;
                                 }
                             }
@@ -152,7 +219,15 @@ namespace ams::kern {
                         }
 
                         if (free_count > 0) {
-                            this->Free(m_heap.GetAddress() + free_start * PageSize, free_count);
+                            this->Release(m_heap.GetAddress() + free_start * PageSize, free_count, use_page_cache);
+                        }
+                    }
+                private:
+                    void Release(KPhysicalAddress address, size_t num_pages, bool use_page_cache) {
+                        if (use_page_cache) {
+                            this->FreeToPageCache(address, num_pages);
+                        } else {
+                            this->Free(address, num_pages);
                         }
                     }
             };
@@ -187,6 +262,11 @@ namespace ams::kern {
             }
 
             Result AllocatePageGroupImpl(KPageGroup *out, size_t num_pages, Pool pool, Direction dir, bool unoptimized, bool random, s32 min_heap_index);
+            Result AllocatePageGroupFromCache(KPageGroup *out, size_t num_pages, Pool pool, Direction dir, s32 min_heap_index);
+
+            KPhysicalAddress AllocateCachedBlockWithoutRefill(Pool pool, Direction dir, s32 index);
+            KPhysicalAddress AllocateCachedBlock(Pool pool, Direction dir, s32 index);
+            bool FlushPageCaches(Pool pool);
         public:
             KMemoryManager()
                 : m_pool_locks(), m_pool_managers_head(), m_pool_managers_tail(), m_managers(), m_num_managers(), m_optimized_process_ids(), m_has_optimized_process(), m_min_heap_indexes()
@@ -247,7 +327,9 @@ namespace ams::kern {
 
                     {
                         KScopedLightLock lk(m_pool_locks[manager.GetPool()]);
-                        manager.Close(address, cur_pages);
+
+                        /* Freed pages go to the page caches, unless the pool is tracking an optimized process. */
+                        manager.Close(address, cur_pages, !m_has_optimized_process[manager.GetPool()]);
                     }
 
                     num_pages -= cur_pages;
@@ -292,6 +374,17 @@ namespace ams::kern {
                 return total;
             }
 
+            void GetPageCacheStatistics(PageCacheStatistics *out, Pool pool) {
+                KScopedLightLock lk(m_pool_locks[pool]);
+
+                *out = {};
+
+                constexpr Direction GetStatisticsDirection = Direction_FromFront;
+                for (auto *manager = this->GetFirstManager(pool, GetStatisticsDirection); manager != nullptr; manager = this->GetNextManager(manager, GetStatisticsDirection)) {
+                    manager->AddPageCacheStatistics(out);
+                }
+            }
+
             void DumpFreeList(Pool pool) {
                 KScopedLightLock lk(m_pool_locks[pool]);
 
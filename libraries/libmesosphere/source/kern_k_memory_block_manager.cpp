@@ -162,18 +162,19 @@ namespace ams::kern {
         KProcessAddress search_start = Null<KProcessAddress>;
         KProcessAddress search_end   = Null<KProcessAddress>;
         if (this->GetRegionForFindFreeArea(std::addressof(search_start), std::addressof(search_end), region_start, region_num_pages, num_pages, alignment, offset, guard_pages)) {
-            /* Iterate over blocks in the search space, looking for a suitable one. */
-            for (const_iterator it = this->FindIterator(search_start); it != m_memory_block_tree.cend(); it++) {
+            /* Only free blocks large enough to hold the pages and their guards can contain a candidate. */
+            /* Each tree node tracks the largest free block beneath it, letting us skip subtrees without one. */
+            const size_t needed_pages = num_pages + 2 * guard_pages;
+            const auto IsCandidateSubtree = [needed_pages](const KMemoryBlock &block) ALWAYS_INLINE_LAMBDA { return block.GetSubtreeMaxFreeNumPages() >= needed_pages; };
+            const auto IsCandidateBlock   = [needed_pages](const KMemoryBlock &block) ALWAYS_INLINE_LAMBDA { return block.GetState() == KMemoryState_Free && block.GetNumPages() >= needed_pages; };
+
+            /* Iterate over candidate blocks in the search space, looking for a suitable one. */
+            for (const_iterator it = m_memory_block_tree.find_augmented(this->FindIterator(search_start), IsCandidateSubtree, IsCandidateBlock); it != m_memory_block_tree.cend(); it = m_memory_block_tree.find_augmented(++it, IsCandidateSubtree, IsCandidateBlock)) {
                 /* If our block is past the end of our search space, we're done. */
                 if (search_end < it->GetAddress()) {
                     break;
                 }
 
-                /* We only want to consider free blocks. */
-                if (it->GetState() != KMemoryState_Free) {
-                    continue;
-                }
-
                 /* Determine the candidate range. */
                 KProcessAddress candidate_start = Null<KProcessAddress>;
                 KProcessAddress candidate_end   = Null<KProcessAddress>;
@@ -215,6 +216,7 @@ namespace ams::kern {
                 KMemoryBlock *block = std::addressof(*it);
                 m_memory_block_tree.erase(it);
                 prev->Add(*block);
+                m_memory_block_tree.update_augmentation(prev);
                 allocator->Free(block);
                 it = prev;
             }
@@ -268,6 +270,7 @@ namespace ams::kern {
 
                 /* Update block state. */
                 it->Update(state, perm, attr, it->GetAddress() == address, set_disable_attr, clear_disable_attr);
+                m_memory_block_tree.update_augmentation(it);
                 cur_address += it->GetSize();
                 remaining_pages -= it->GetNumPages();
             }
@@ -311,6 +314,7 @@ namespace ams::kern {
 
                 /* Update block state. */
                 it->Update(state, perm, attr, it->GetAddress() == address, set_disable_attr, clear_disable_attr);
+                m_memory_block_tree.update_augmentation(it);
                 cur_address     += it->GetSize();
                 remaining_pages -= it->GetNumPages();
             } else {
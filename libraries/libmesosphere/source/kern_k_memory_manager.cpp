@@ -183,6 +183,9 @@ namespace ams::kern {
             manager->InitializeOptimizedMemory();
         }
 
+        /* Return any cached pages to the heap, as the page caches aren't used while allocations are being tracked. */
+        this->FlushPageCaches(pool);
+
         R_SUCCEED();
     }
 
@@ -215,6 +218,20 @@ namespace ams::kern {
         /* Update our alignment. */
         align_pages = std::max(align_pages, min_align_pages);
 
+        /* If we can, allocate from the page caches without taking the pool lock. */
+        if (const s32 cache_index = PageCache::GetAllocateBlockIndex(num_pages, align_pages); cache_index >= 0) {
+            if (const KPhysicalAddress cached_block = this->AllocateCachedBlock(pool, dir, cache_index); cached_block != Null<KPhysicalAddress>) {
+                /* Open the first reference to the pages. */
+                /* NOTE: A cached block comes from a single manager, and until we return it, its pages are unreferenced and owned by us alone. */
+                /* No other core can update their reference counts concurrently, so we don't need to take the pool lock to do so. */
+                auto &manager = this->GetManager(cached_block);
+                MESOSPHERE_ASSERT(num_pages <= manager.GetPageOffsetToEnd(cached_block));
+                manager.OpenFirst(cached_block, num_pages);
+
+                return cached_block;
+            }
+        }
+
         /* Lock the pool that we're allocating from. */
         KScopedLightLock lk(m_pool_locks[pool]);
 
@@ -224,9 +241,16 @@ namespace ams::kern {
         /* Loop, trying to iterate from each block. */
         Impl *chosen_manager = nullptr;
         KPhysicalAddress allocated_block = Null<KPhysicalAddress>;
-        for (chosen_manager = this->GetFirstManager(pool, dir); chosen_manager != nullptr; chosen_manager = this->GetNextManager(chosen_manager, dir)) {
-            allocated_block = chosen_manager->AllocateAligned(heap_index, num_pages, align_pages);
-            if (allocated_block != Null<KPhysicalAddress>) {
+        while (true) {
+            for (chosen_manager = this->GetFirstManager(pool, dir); chosen_manager != nullptr; chosen_manager = this->GetNextManager(chosen_manager, dir)) {
+                allocated_block = chosen_manager->AllocateAligned(heap_index, num_pages, align_pages);
+                if (allocated_block != Null<KPhysicalAddress>) {
+                    break;
+                }
+            }
+
+            /* If we failed, return any pages held by the page caches to the heap and try again. */
+            if (allocated_block != Null<KPhysicalAddress> || !this->FlushPageCaches(pool)) {
                 break;
             }
         }
@@ -270,30 +294,37 @@ namespace ams::kern {
         };
 
         /* Keep allocating until we've allocated all our pages. */
-        for (s32 index = heap_index; index >= min_heap_index && num_pages > 0; index--) {
-            const size_t pages_per_alloc = KPageHeap::GetBlockNumPages(index);
-            for (Impl *cur_manager = this->GetFirstManager(pool, dir); cur_manager != nullptr; cur_manager = this->GetNextManager(cur_manager, dir)) {
-                while (num_pages >= pages_per_alloc) {
-                    /* Allocate a block. */
-                    KPhysicalAddress allocated_block = cur_manager->AllocateBlock(index, random);
-                    if (allocated_block == Null<KPhysicalAddress>) {
-                        break;
+        while (true) {
+            for (s32 index = heap_index; index >= min_heap_index && num_pages > 0; index--) {
+                const size_t pages_per_alloc = KPageHeap::GetBlockNumPages(index);
+                for (Impl *cur_manager = this->GetFirstManager(pool, dir); cur_manager != nullptr; cur_manager = this->GetNextManager(cur_manager, dir)) {
+                    while (num_pages >= pages_per_alloc) {
+                        /* Allocate a block. */
+                        KPhysicalAddress allocated_block = cur_manager->AllocateBlock(index, random);
+                        if (allocated_block == Null<KPhysicalAddress>) {
+                            break;
+                        }
+
+                        /* Ensure we don't leak the block if we fail. */
+                        ON_RESULT_FAILURE { cur_manager->Free(allocated_block, pages_per_alloc); };
+
+                        /* Add the block to our group. */
+                        R_TRY(out->AddBlock(allocated_block, pages_per_alloc));
+
+                        /* Maintain the optimized memory bitmap, if we should. */
+                        if (unoptimized) {
+                            cur_manager->TrackUnoptimizedAllocation(allocated_block, pages_per_alloc);
+                        }
+
+                        num_pages -= pages_per_alloc;
                     }
-
-                    /* Ensure we don't leak the block if we fail. */
-                    ON_RESULT_FAILURE { cur_manager->Free(allocated_block, pages_per_alloc); };
-
-                    /* Add the block to our group. */
-                    R_TRY(out->AddBlock(allocated_block, pages_per_alloc));
-
-                    /* Maintain the optimized memory bitmap, if we should. */
-                    if (unoptimized) {
-                        cur_manager->TrackUnoptimizedAllocation(allocated_block, pages_per_alloc);
-                    }
-
-                    num_pages -= pages_per_alloc;
                 }
             }
+
+            /* If we ran out of memory, return any pages held by the page caches to the heap and try again. */
+            if (num_pages == 0 || !this->FlushPageCaches(pool)) {
+                break;
+            }
         }
 
         /* Only succeed if we allocated as many pages as we wanted. */
@@ -303,6 +334,104 @@ namespace ams::kern {
         R_SUCCEED();
     }
 
+    Result KMemoryManager::AllocatePageGroupFromCache(KPageGroup *out, size_t num_pages, Pool pool, Direction dir, s32 min_heap_index) {
+        /* Adjust our min heap index to the pool minimum if needed. */
+        min_heap_index = std::max(min_heap_index, m_min_heap_indexes[pool]);
+        R_UNLESS(min_heap_index < PageCache::NumBlockIndices, svc::ResultOutOfMemory());
+
+        /* Determine how many blocks of each cached size we need, largest first. Requests that the caches can't hold go to the heap. */
+        size_t num_blocks[PageCache::NumBlockIndices] = {};
+        {
+            size_t remaining_pages = num_pages;
+            for (s32 index = PageCache::NumBlockIndices - 1; index >= min_heap_index; index--) {
+                num_blocks[index] = remaining_pages / KPageHeap::GetBlockNumPages(index);
+                R_UNLESS(num_blocks[index] <= PageCache::Capacities[index], svc::ResultOutOfMemory());
+
+                remaining_pages -= num_blocks[index] * KPageHeap::GetBlockNumPages(index);
+            }
+            R_UNLESS(remaining_pages == 0, svc::ResultOutOfMemory());
+        }
+
+        /* Ensure that we don't leave anything un-freed. */
+        ON_RESULT_FAILURE {
+            KScopedLightLock lk(m_pool_locks[pool]);
+
+            for (const auto &it : *out) {
+                auto &manager = this->GetManager(it.GetAddress());
+                const size_t num_pages = std::min(it.GetNumPages(), (manager.GetEndAddress() - it.GetAddress()) / PageSize);
+                manager.Free(it.GetAddress(), num_pages);
+            }
+            out->Finalize();
+        };
+
+        /* Allocate the blocks from the caches, without refilling them. */
+        /* On the first miss, our caller will allocate the whole group from the heap, which is cheaper than refilling block by block. */
+        for (s32 index = PageCache::NumBlockIndices - 1; index >= min_heap_index; index--) {
+            const size_t pages_per_alloc = KPageHeap::GetBlockNumPages(index);
+            for (size_t i = 0; i < num_blocks[index]; i++) {
+                /* Allocate a block. */
+                const KPhysicalAddress allocated_block = this->AllocateCachedBlockWithoutRefill(pool, dir, index);
+                R_UNLESS(allocated_block != Null<KPhysicalAddress>, svc::ResultOutOfMemory());
+
+                /* Ensure we don't leak the block if we fail. */
+                ON_RESULT_FAILURE {
+                    KScopedLightLock lk(m_pool_locks[pool]);
+                    this->GetManager(allocated_block).Free(allocated_block, pages_per_alloc);
+                };
+
+                /* Add the block to our group. */
+                R_TRY(out->AddBlock(allocated_block, pages_per_alloc));
+            }
+        }
+
+        R_SUCCEED();
+    }
+
+    KPhysicalAddress KMemoryManager::AllocateCachedBlockWithoutRefill(Pool pool, Direction dir, s32 index) {
+        /* Try to allocate from the current core's cache for each manager. */
+        for (auto *manager = this->GetFirstManager(pool, dir); manager != nullptr; manager = this->GetNextManager(manager, dir)) {
+            if (const KPhysicalAddress block = manager->AllocateFromPageCache(index); block != Null<KPhysicalAddress>) {
+                return block;
+            }
+        }
+
+        return Null<KPhysicalAddress>;
+    }
+
+    KPhysicalAddress KMemoryManager::AllocateCachedBlock(Pool pool, Direction dir, s32 index) {
+        /* Try to allocate from the current core's caches. */
+        if (const KPhysicalAddress block = this->AllocateCachedBlockWithoutRefill(pool, dir, index); block != Null<KPhysicalAddress>) {
+            return block;
+        }
+
+        /* Lock the pool, so that we can refill from the heap. */
+        KScopedLightLock lk(m_pool_locks[pool]);
+
+        /* Allocations must be tracked while the pool has an optimized process, so don't cache anything. */
+        if (m_has_optimized_process[pool]) {
+            return Null<KPhysicalAddress>;
+        }
+
+        /* Refill the cache for the first manager that has memory. */
+        for (auto *manager = this->GetFirstManager(pool, dir); manager != nullptr; manager = this->GetNextManager(manager, dir)) {
+            if (const KPhysicalAddress block = manager->RefillPageCache(index); block != Null<KPhysicalAddress>) {
+                return block;
+            }
+        }
+
+        return Null<KPhysicalAddress>;
+    }
+
+    bool KMemoryManager::FlushPageCaches(Pool pool) {
+        MESOSPHERE_ASSERT(m_pool_locks[pool].IsLockedByCurrentThread());
+
+        bool flushed = false;
+        for (auto *manager = this->GetFirstManager(pool, Direction_FromFront); manager != nullptr; manager = this->GetNextManager(manager, Direction_FromFront)) {
+            flushed |= manager->FlushPageCaches();
+        }
+        return flushed;
+    }
+
     Result KMemoryManager::AllocateAndOpen(KPageGroup *out, size_t num_pages, size_t align_pages, u32 option) {
         MESOSPHERE_ASSERT(out != nullptr);
         MESOSPHERE_ASSERT(out->GetNumPages() == 0);
@@ -311,6 +440,7 @@ namespace ams::kern {
         R_SUCCEED_IF(num_pages == 0);
 
         /* Lock the pool that we're allocating from. */
+        /* NOTE: This doesn't use the page caches, as its callers rely on the heap's random block placement. */
         const auto [pool, dir] = DecodeOption(option);
         KScopedLightLock lk(m_pool_locks[pool]);
 
@@ -350,7 +480,10 @@ namespace ams::kern {
 
         /* Allocate the memory. */
         bool optimized;
-        {
+        if (R_SUCCEEDED(this->AllocatePageGroupFromCache(out, num_pages, pool, dir, 0))) {
+            /* The page caches are kept empty while the pool has an optimized process, so there's nothing to track. */
+            optimized = false;
+        } else {
             /* Lock the pool that we're allocating from. */
             KScopedLightLock lk(m_pool_locks[pool]);
 
@@ -512,6 +645,178 @@ namespace ams::kern {
         return any_new;
     }
 
+    size_t KMemoryManager::Impl::GetFreeSize() {
+        /* Cached pages are free, even though the heap considers them allocated. */
+        PageCacheStatistics stats = {};
+        this->AddPageCacheStatistics(std::addressof(stats));
+
+        return m_heap.GetFreeSize() + stats.cached_size;
+    }
+
+    KPhysicalAddress KMemoryManager::Impl::AllocateFromPageCache(s32 index) {
+        return m_page_caches[GetCurrentCoreId()].Allocate(index);
+    }
+
+    KPhysicalAddress KMemoryManager::Impl::RefillPageCache(s32 index) {
+        /* Allocate a batch of blocks from the heap. */
+        KPhysicalAddress blocks[PageCache::MaxBatchCount];
+        size_t num_blocks = 0;
+        while (num_blocks < PageCache::GetBatchCount(index)) {
+            if (const KPhysicalAddress block = m_heap.AllocateBlock(index, true); block != Null<KPhysicalAddress>) {
+                blocks[num_blocks++] = block;
+            } else {
+                break;
+            }
+        }
+
+        /* If we couldn't allocate anything, we're done. */
+        if (num_blocks == 0) {
+            return Null<KPhysicalAddress>;
+        }
+
+        /* Keep the first block for our caller, and cache the rest. */
+        const size_t num_cached = m_page_caches[GetCurrentCoreId()].Refill(index, blocks + 1, num_blocks - 1);
+
+        /* Return anything that didn't fit to the heap. */
+        for (size_t i = 1 + num_cached; i < num_blocks; ++i) {
+            this->Free(blocks[i], KPageHeap::GetBlockNumPages(index));
+        }
+
+        return blocks[0];
+    }
+
+    void KMemoryManager::Impl::FreeToPageCache(KPhysicalAddress addr, size_t num_pages) {
+        /* Only single blocks of a cached size can be cached. */
+        const s32 index = PageCache::GetFreeBlockIndex(addr, num_pages);
+        if (index < 0) {
+            this->Free(addr, num_pages);
+            return;
+        }
+
+        /* Try to add the block to the current core's cache. */
+        auto &cache = m_page_caches[GetCurrentCoreId()];
+        if (cache.Free(index, addr)) {
+            return;
+        }
+
+        /* The cache is full, so drain a batch of its oldest entries back to the heap to make room. */
+        KPhysicalAddress blocks[PageCache::MaxBatchCount];
+        const size_t num_drained = cache.Drain(index, blocks, PageCache::GetBatchCount(index));
+        for (size_t i = 0; i < num_drained; ++i) {
+            this->Free(blocks[i], num_pages);
+        }
+
+        if (!cache.Free(index, addr)) {
+            this->Free(addr, num_pages);
+        }
+    }
+
+    bool KMemoryManager::Impl::FlushPageCaches() {
+        bool flushed = false;
+        for (auto &cache : m_page_caches) {
+            for (s32 index = 0; index < PageCache::NumBlockIndices; ++index) {
+                KPhysicalAddress blocks[PageCache::MaxBatchCount];
+                while (true) {
+                    const size_t num_drained = cache.Drain(index, blocks, PageCache::MaxBatchCount);
+                    if (num_drained == 0) {
+                        break;
+                    }
+
+                    for (size_t i = 0; i < num_drained; ++i) {
+                        this->Free(blocks[i], KPageHeap::GetBlockNumPages(index));
+                    }
+                    flushed = true;
+                }
+            }
+        }
+        return flushed;
+    }
+
+    void KMemoryManager::Impl::AddPageCacheStatistics(PageCacheStatistics *out) {
+        for (auto &cache : m_page_caches) {
+            cache.AddStatistics(out);
+        }
+    }
+
+    KPhysicalAddress KMemoryManager::PageCache::Allocate(s32 index) {
+        /* Lock the cache. */
+        KScopedInterruptDisable di;
+        KScopedSpinLock lk(m_lock);
+
+        /* Take the most recently cached block. */
+        if (m_counts[index] == 0) {
+            return Null<KPhysicalAddress>;
+        }
+
+        ++m_hit_count;
+        return m_blocks[Offsets[index] + (--m_counts[index])];
+    }
+
+    bool KMemoryManager::PageCache::Free(s32 index, KPhysicalAddress block) {
+        /* Lock the cache. */
+        KScopedInterruptDisable di;
+        KScopedSpinLock lk(m_lock);
+
+        /* Add the block, if we have room. */
+        if (m_counts[index] >= Capacities[index]) {
+            return false;
+        }
+
+        m_blocks[Offsets[index] + (m_counts[index]++)] = block;
+        return true;
+    }
+
+    size_t KMemoryManager::PageCache::Refill(s32 index, const KPhysicalAddress *blocks, size_t num_blocks) {
+        /* Lock the cache. */
+        KScopedInterruptDisable di;
+        KScopedSpinLock lk(m_lock);
+
+        /* Add as many blocks as we have room for. */
+        const size_t count = std::min(num_blocks, Capacities[index] - m_counts[index]);
+        for (size_t i = 0; i < count; ++i) {
+            m_blocks[Offsets[index] + (m_counts[index]++)] = blocks[i];
+        }
+
+        ++m_refill_count;
+        return count;
+    }
+
+    size_t KMemoryManager::PageCache::Drain(s32 index, KPhysicalAddress *out_blocks, size_t max_blocks) {
+        /* Lock the cache. */
+        KScopedInterruptDisable di;
+        KScopedSpinLock lk(m_lock);
+
+        /* Remove the least recently cached blocks, keeping the rest in order. */
+        const size_t count = std::min(max_blocks, m_counts[index]);
+        if (count > 0) {
+            KPhysicalAddress *entries = m_blocks + Offsets[index];
+            for (size_t i = 0; i < count; ++i) {
+                out_blocks[i] = entries[i];
+            }
+            for (size_t i = count; i < m_counts[index]; ++i) {
+                entries[i - count] = entries[i];
+            }
+            m_counts[index] -= count;
+
+            ++m_drain_count;
+        }
+
+        return count;
+    }
+
+    void KMemoryManager::PageCache::AddStatistics(PageCacheStatistics *out) {
+        /* Lock the cache. */
+        KScopedInterruptDisable di;
+        KScopedSpinLock lk(m_lock);
+
+        for (s32 index = 0; index < NumBlockIndices; ++index) {
+            out->cached_size += m_counts[index] * KPageHeap::GetBlockSize(index);
+        }
+        out->hit_count    += m_hit_count;
+        out->refill_count += m_refill_count;
+        out->drain_count  += m_drain_count;
+    }
+
     size_t KMemoryManager::Impl::CalculateManagementOverheadSize(size_t region_size) {
         const size_t ref_count_size     = (region_size / PageSize) * sizeof(u16);
         const size_t optimize_map_size  = (util::AlignUp((region_size / PageSize), BITSIZEOF(u64)) / BITSIZEOF(u64)) * sizeof(u64);
@@ -27,13 +27,24 @@ namespace ams::kern {
         constinit size_t g_ktrace_buffer_size = 0;
         constinit u64 g_type_filter = 0;
 
-        struct KTraceHeader {
-            u32 magic;
+        /* Each core records into its own ring, so that tracing does not serialize the cores. */
+        /* Each ring has a single writer (its core), and readers merge the rings by tick. */
+        struct KTraceCoreHeader {
             u32 offset;
             u32 index;
             u32 count;
+            u32 reserved[13];
+        };
+        static_assert(util::is_pod<KTraceCoreHeader>::value);
+        static_assert(sizeof(KTraceCoreHeader) == 0x40);
 
-            static constexpr u32 Magic = util::FourCC<'K','T','R','0'>::Code;
+        struct KTraceHeader {
+            u32 magic;
+            u32 num_cores;
+            u32 reserved[14];
+            KTraceCoreHeader cores[cpu::NumCores];
+
+            static constexpr u32 Magic = util::FourCC<'K','T','R','1'>::Code;
         };
         static_assert(util::is_pod<KTraceHeader>::value);
 
@@ -52,6 +63,14 @@ namespace ams::kern {
             return (g_type_filter & (UINT64_C(1) << (type & (BITSIZEOF(u64) - 1)))) != 0;
         }
 
+        ALWAYS_INLINE KTraceHeader *GetTraceHeader() {
+            return GetPointer<KTraceHeader>(g_ktrace_buffer_address);
+        }
+
+        ALWAYS_INLINE KTraceRecord *GetTraceRecords(const KTraceCoreHeader &core) {
+            return GetPointer<KTraceRecord>(g_ktrace_buffer_address + core.offset);
+        }
+
     }
 
     void KTrace::Initialize(KVirtualAddress address, size_t size) {
@@ -59,48 +78,64 @@ namespace ams::kern {
         if (KTargetSystem::IsDebugMode()) {
             const size_t offset = util::AlignUp(sizeof(KTraceHeader), sizeof(KTraceRecord));
             if (offset < size) {
-                /* Clear the trace buffer. */
-                std::memset(GetVoidPointer(address), 0, size);
-
-                /* Initialize the KTrace header. */
-                KTraceHeader *header = GetPointer<KTraceHeader>(address);
-                header->magic  = KTraceHeader::Magic;
-                header->offset = offset;
-                header->index  = 0;
-                header->count  = (size - offset) / sizeof(KTraceRecord);
-
-                /* Set the global data. */
-                g_ktrace_buffer_address = address;
-                g_ktrace_buffer_size    = size;
-
-                /* Set the filters to defaults. */
-                g_type_filter = ~(UINT64_C(0));
+                /* Determine how many records each core may hold. */
+                const size_t count_per_core = ((size - offset) / sizeof(KTraceRecord)) / cpu::NumCores;
+                if (count_per_core > 0) {
+                    /* Clear the trace buffer. */
+                    std::memset(GetVoidPointer(address), 0, size);
+
+                    /* Initialize the KTrace header. */
+                    KTraceHeader *header = GetPointer<KTraceHeader>(address);
+                    header->magic     = KTraceHeader::Magic;
+                    header->num_cores = cpu::NumCores;
+
+                    /* Initialize the per-core headers. */
+                    for (size_t core_id = 0; core_id < cpu::NumCores; ++core_id) {
+                        header->cores[core_id].offset = offset + core_id * count_per_core * sizeof(KTraceRecord);
+                        header->cores[core_id].index  = 0;
+                        header->cores[core_id].count  = count_per_core;
+                    }
+
+                    /* Set the global data. */
+                    g_ktrace_buffer_address = address;
+                    g_ktrace_buffer_size    = size;
+
+                    /* Set the filters to defaults. */
+                    g_type_filter = ~(UINT64_C(0));
+                }
             }
         }
     }
 
     void KTrace::Start() {
         if (g_ktrace_buffer_address != Null<KVirtualAddress>) {
-            /* Get exclusive access to the trace buffer. */
+            /* Get exclusive access to the trace control state. */
             KScopedInterruptDisable di;
             KScopedSpinLock lk(g_ktrace_lock);
 
-            /* Reset the header. */
-            KTraceHeader *header = GetPointer<KTraceHeader>(g_ktrace_buffer_address);
-            header->index = 0;
+            /* Stop recording while we reset. */
+            /* NOTE: A record pushed by another core concurrently with the reset may survive it; readers order records by tick. */
+            s_is_active = false;
+            cpu::DataMemoryBarrierInnerShareable();
+
+            /* Reset each core's ring. */
+            KTraceHeader *header = GetTraceHeader();
+            for (size_t core_id = 0; core_id < cpu::NumCores; ++core_id) {
+                KTraceCoreHeader &core = header->cores[core_id];
 
-            /* Reset the records. */
-            KTraceRecord *records = GetPointer<KTraceRecord>(g_ktrace_buffer_address + header->offset);
-            std::memset(records, 0, sizeof(*records) * header->count);
+                core.index = 0;
+                std::memset(GetTraceRecords(core), 0, sizeof(KTraceRecord) * core.count);
+            }
 
             /* Note that we're active. */
+            cpu::DataMemoryBarrierInnerShareable();
             s_is_active = true;
         }
     }
 
     void KTrace::Stop() {
         if (g_ktrace_buffer_address != Null<KVirtualAddress>) {
-            /* Get exclusive access to the trace buffer. */
+            /* Get exclusive access to the trace control state. */
             KScopedInterruptDisable di;
             KScopedSpinLock lk(g_ktrace_lock);
 
@@ -110,26 +145,27 @@ namespace ams::kern {
     }
 
     void KTrace::PushRecord(u8 type, u64 param0, u64 param1, u64 param2, u64 param3, u64 param4, u64 param5) {
-        /* Get exclusive access to the trace buffer. */
+        /* Get exclusive access to this core's ring. */
+        /* Only this core writes to its ring, so we need only guard against interrupts. */
         KScopedInterruptDisable di;
-        KScopedSpinLock lk(g_ktrace_lock);
 
         /* Check whether we should push the record to the trace buffer. */
         if (s_is_active && IsTypeFiltered(type)) {
             /* Get the current thread and process. */
             KThread &cur_thread   = GetCurrentThread();
             KProcess *cur_process = GetCurrentProcessPointer();
+            const s32 core_id     = GetCurrentCoreId();
 
-            /* Get the current record index from the header. */
-            KTraceHeader *header = GetPointer<KTraceHeader>(g_ktrace_buffer_address);
-            u32 index = header->index;
+            /* Get the current record index from this core's header. */
+            KTraceCoreHeader &core = GetTraceHeader()->cores[core_id];
+            u32 index = core.index;
 
             /* Get the current record. */
-            KTraceRecord *record = GetPointer<KTraceRecord>(g_ktrace_buffer_address + header->offset + index * sizeof(KTraceRecord));
+            KTraceRecord *record = GetTraceRecords(core) + index;
 
             /* Set the record's data. */
             *record = {
-                .core_id    = static_cast<u8>(GetCurrentCoreId()),
+                .core_id    = static_cast<u8>(core_id),
                 .type       = type,
                 .process_id = static_cast<u16>(cur_process != nullptr ? cur_process->GetId() : ~0),
                 .thread_id  = static_cast<u32>(cur_thread.GetId()),
@@ -138,12 +174,12 @@ namespace ams::kern {
             };
 
             /* Advance the current index. */
-            if ((++index) >= header->count) {
+            if ((++index) >= core.count) {
                 index = 0;
             }
 
             /* Set the next index. */
-            header->index = index;
+            core.index = index;
         }
     }
 
@@ -439,6 +439,38 @@ namespace ams::kern::svc {
                         R_TRY(GetInitialProcessIdRange(out, static_cast<ams::svc::InitialProcessIdRangeInfo>(info_subtype)));
                     }
                     break;
+                case ams::svc::SystemInfoType_MesospherePageCache:
+                    {
+                        /* Verify the input handle is invalid. */
+                        R_UNLESS(handle == ams::svc::InvalidHandle, svc::ResultInvalidHandle());
+
+                        /* Decode the sub-type into a pool and statistic. */
+                        const u64 pool_value = static_cast<u32>(info_subtype);
+                        const auto info      = static_cast<ams::svc::MesospherePageCacheInfo>(info_subtype >> 32);
+                        R_UNLESS(IsValidMemoryPool(pool_value), svc::ResultInvalidCombination());
+
+                        /* Get the page cache statistics for the pool. */
+                        KMemoryManager::PageCacheStatistics stats;
+                        Kernel::GetMemoryManager().GetPageCacheStatistics(std::addressof(stats), static_cast<KMemoryManager::Pool>(pool_value));
+
+                        switch (info) {
+                            case ams::svc::MesospherePageCacheInfo_CachedSize:
+                                *out = stats.cached_size;
+                                break;
+                            case ams::svc::MesospherePageCacheInfo_HitCount:
+                                *out = stats.hit_count;
+                                break;
+                            case ams::svc::MesospherePageCacheInfo_RefillCount:
+                                *out = stats.refill_count;
+                                break;
+                            case ams::svc::MesospherePageCacheInfo_DrainCount:
+                                *out = stats.drain_count;
+                                break;
+                            default:
+                                R_THROW(svc::ResultInvalidCombination());
+                        }
+                    }
+                    break;
                 default:
                     R_THROW(svc::ResultInvalidEnumValue());
             }
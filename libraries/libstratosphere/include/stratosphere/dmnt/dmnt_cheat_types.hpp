@@ -63,4 +63,30 @@ namespace ams::dmnt::cheat {
         FrozenAddressValue value;
     };
 
+    enum MemorySearchCondition : u32 {
+        MemorySearchCondition_Any       = 0,
+        MemorySearchCondition_Equal     = 1,
+        MemorySearchCondition_NotEqual  = 2,
+        MemorySearchCondition_InRange   = 3,
+        MemorySearchCondition_Changed   = 4,
+        MemorySearchCondition_Unchanged = 5,
+        MemorySearchCondition_Increased = 6,
+        MemorySearchCondition_Decreased = 7,
+    };
+
+    struct MemorySearchParameters {
+        u32 condition;
+        u32 width;
+        u64 value;
+        u64 range_max;
+    };
+
+    struct MemorySearchResult {
+        u64 address;
+        u64 value;
+    };
+
+    static_assert(util::is_pod<MemorySearchParameters>::value && sizeof(MemorySearchParameters) == 0x18, "MemorySearchParameters definition!");
+    static_assert(util::is_pod<MemorySearchResult>::value && sizeof(MemorySearchResult) == 0x10, "MemorySearchResult definition!");
+
 }
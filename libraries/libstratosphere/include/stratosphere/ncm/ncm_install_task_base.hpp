@@ -134,6 +134,8 @@ namespace ams::ncm {
             Result PrepareContentMeta(const InstallContentMetaInfo &meta_info, util::optional<ContentMetaKey> key, util::optional<u32> source_version);
             Result PrepareContentMeta(ContentId content_id, s64 size, ContentMetaType meta_type, AutoBuffer *buffer);
             Result WritePlaceHolderBuffer(InstallContentInfo *content_info, const void *data, size_t data_size);
+            Result WritePlaceHolderData(InstallContentInfo *content_info, const void *data, size_t data_size);
+            void UpdatePlaceHolderHash(const void *data, size_t data_size);
             void PrepareAgain();
 
             Result CountInstallContentMetaData(s32 *out_count);
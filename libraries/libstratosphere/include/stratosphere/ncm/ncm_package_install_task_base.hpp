@@ -22,10 +22,33 @@ namespace ams::ncm {
     class PackageInstallTaskBase : public InstallTaskBase {
         private:
             using PackagePath = kvdb::BoundedString<256>;
+
+            static constexpr size_t PipelineBufferCount     = 4;
+            static constexpr size_t PipelineBufferSizeMin   = 64_KB;
+            static constexpr size_t PipelineThreadStackSize = 8_KB;
+
+            /* The write and hash thread stacks are allocated together, while a pipelined write is in progress. */
+            static constexpr size_t PipelineThreadStackMemorySize = 2 * PipelineThreadStackSize + os::ThreadStackAlignment;
         private:
             PackagePath m_package_root;
             void *m_buffer{};
             size_t m_buffer_size{};
+
+            /* Placeholder writes are pipelined: we read chunks from the package, a write thread writes */
+            /* them to the placeholder, and a hash thread hashes the chunks which have been written. */
+            os::SdkMutex m_pipeline_mutex{};
+            os::SdkConditionVariable m_pipeline_cv{};
+            os::ThreadType m_write_thread{};
+            os::ThreadType m_hash_thread{};
+            InstallContentInfo *m_pipeline_content_info{};
+            size_t m_pipeline_buffer_size{};
+            size_t m_pipeline_data_sizes[PipelineBufferCount]{};
+            u64 m_pipeline_read_count{};
+            u64 m_pipeline_written_count{};
+            u64 m_pipeline_hashed_count{};
+            bool m_pipeline_read_finished{};
+            bool m_pipeline_write_finished{};
+            Result m_pipeline_result{};
         public:
             PackageInstallTaskBase() : m_package_root() { /* ... */ }
 
@@ -38,6 +61,17 @@ namespace ams::ncm {
             virtual Result OnWritePlaceHolder(const ContentMetaKey &key, InstallContentInfo *content_info) override;
             virtual Result InstallTicket(const fs::RightsId &rights_id, ContentMetaType meta_type) override;
 
+            Result WritePlaceHolderSequentially(fs::FileHandle file, InstallContentInfo *content_info);
+            Result WritePlaceHolderPipelined(fs::FileHandle file, InstallContentInfo *content_info);
+
+            void *GetPipelineBuffer(u64 index) const { return static_cast<u8 *>(m_buffer) + (index % PipelineBufferCount) * m_pipeline_buffer_size; }
+            void SetPipelineResult(Result result);
+
+            static void WriteThreadFunction(void *arg) { static_cast<PackageInstallTaskBase *>(arg)->WriteThreadBody(); }
+            static void HashThreadFunction(void *arg) { static_cast<PackageInstallTaskBase *>(arg)->HashThreadBody(); }
+            void WriteThreadBody();
+            void HashThreadBody();
+
             void CreateContentMetaPath(PackagePath *out_path, ContentId content_id);
             void CreateContentPath(PackagePath *out_path, ContentId content_id);
             void CreateTicketPath(PackagePath *out_path, fs::RightsId id);
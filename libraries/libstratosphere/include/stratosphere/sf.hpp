@@ -28,6 +28,7 @@
 #include <stratosphere/sf/hipc/sf_hipc_server_session_manager.hpp>
 
 #include <stratosphere/sf/cmif/sf_cmif_inline_context.hpp>
+#include <stratosphere/sf/cmif/sf_cmif_command_statistics.hpp>
 #include <stratosphere/sf/sf_fs_inline_context.hpp>
 
 #include <stratosphere/sf/sf_out.hpp>
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <vapours.hpp>
+#include <stratosphere/os/os_tick.hpp>
+#include <stratosphere/sf/sf_command_statistics_config.hpp>
+
+namespace ams::sf::cmif {
+
+    /* Bucket N counts calls whose latency in ticks has bit width N; the last bucket is open-ended. */
+    constexpr inline size_t CommandStatisticsLatencyBucketCount = 24;
+
+    struct CommandStatistics {
+        u32 interface_id;
+        u32 command_id;
+        u64 call_count;
+        u64 failure_count;
+        u64 forwarded_count;
+        s64 total_ticks;
+        s64 max_ticks;
+        u64 in_bytes;
+        u64 out_bytes;
+        u32 latency_histogram[CommandStatisticsLatencyBucketCount];
+    };
+
+    /* Forwarded calls are mitm commands passed on to the real service; their time includes the forward. */
+    void RecordCommandStatistics(u32 interface_id, u32 command_id, os::Tick elapsed, size_t in_bytes, size_t out_bytes, bool failed, bool forwarded);
+
+    size_t GetCommandStatistics(CommandStatistics *out, size_t max_count, size_t *out_dropped_count);
+    void ClearCommandStatistics();
+
+    /* Writes a text table to path; the containing filesystem must already be mounted. */
+    Result DumpCommandStatistics(const char *path);
+
+}
@@ -43,6 +43,8 @@ namespace ams::sf::hipc {
     Result Receive(bool *out_closed, os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer);
     Result Reply(os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer);
 
+    Result SendSyncRequest(os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer);
+
     Result CreateSession(os::NativeHandle *out_server_handle, os::NativeHandle *out_client_handle);
 
 
@@ -109,10 +109,16 @@ namespace ams::sf::hipc {
             void LinkToDeferredList(os::MultiWaitHolderType *holder);
             void LinkDeferred();
 
-            bool WaitAndProcessImpl();
+            os::MultiWaitHolderType *WaitSignaledImpl();
+            os::MultiWaitHolderType *ReplyAndWaitSignaled(PendingReply *pending_reply, hipc::ReceiveResult *out_recv_result, bool *out_received);
+            void SendPendingReply(PendingReply *pending_reply);
+            void FinishPendingReply(PendingReply *pending_reply);
 
+            bool WaitAndProcessImpl(PendingReply *pending_reply);
+
+            Result ProcessImpl(os::MultiWaitHolderType *holder, PendingReply *pending_reply, const hipc::ReceiveResult *recv_result);
             Result ProcessForServer(os::MultiWaitHolderType *holder);
-            Result ProcessForSession(os::MultiWaitHolderType *holder);
+            Result ProcessForSession(os::MultiWaitHolderType *holder, PendingReply *pending_reply, const hipc::ReceiveResult *recv_result);
 
             #if AMS_SF_MITM_SUPPORTED
             Result ProcessForMitmServer(os::MultiWaitHolderType *holder);
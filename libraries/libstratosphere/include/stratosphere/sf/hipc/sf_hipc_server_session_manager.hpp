@@ -30,6 +30,7 @@ namespace ams::sf::cmif {
 
 namespace ams::sf::hipc {
 
+    class ServerSession;
     class ServerSessionManager;
     class ServerManagerBase;
 
@@ -39,6 +40,13 @@ namespace ams::sf::hipc {
 
     }
 
+    struct PendingReply {
+        ServerSession *session;
+        os::NativeHandle session_handle;
+        cmif::PointerAndSize pointer_buffer;
+        cmif::HandlesToClose handles_to_close;
+    };
+
     class ServerSession : public os::MultiWaitHolderType {
         friend class ServerSessionManager;
         friend class ServerManagerBase;
@@ -49,6 +57,7 @@ namespace ams::sf::hipc {
             cmif::ServiceObjectHolder m_srv_obj_holder;
             cmif::PointerAndSize m_pointer_buffer;
             cmif::PointerAndSize m_saved_message;
+            PendingReply *m_pending_reply;
             #if AMS_SF_MITM_SUPPORTED
             util::TypedStorage<std::shared_ptr<::Service>> m_forward_service;
             #endif
@@ -59,6 +68,7 @@ namespace ams::sf::hipc {
         public:
             ServerSession(os::NativeHandle h, cmif::ServiceObjectHolder &&obj) : m_srv_obj_holder(std::move(obj)), m_session_handle(h), m_has_forward_service(false) {
                 hipc::AttachMultiWaitHolderForReply(this, h);
+                m_pending_reply = nullptr;
                 m_is_closed = false;
                 m_has_received = false;
                 #if AMS_SF_MITM_SUPPORTED
@@ -77,6 +87,7 @@ namespace ams::sf::hipc {
             #if AMS_SF_MITM_SUPPORTED
             ServerSession(os::NativeHandle h, cmif::ServiceObjectHolder &&obj, std::shared_ptr<::Service> &&fsrv) : m_srv_obj_holder(std::move(obj)), m_session_handle(h), m_has_forward_service(true) {
                 hipc::AttachMultiWaitHolderForReply(this, h);
+                m_pending_reply = nullptr;
                 m_is_closed = false;
                 m_has_received = false;
                 util::ConstructAt(m_forward_service, std::move(fsrv));
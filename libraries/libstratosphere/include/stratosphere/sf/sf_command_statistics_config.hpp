@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/* Per-command dispatch statistics are opt-in; build with ATMOSPHERE_SF_COMMAND_STATISTICS=1 to instrument cmif dispatch. */
+#if !defined(AMS_SF_COMMAND_STATISTICS_ENABLED)
+    #define AMS_SF_COMMAND_STATISTICS_ENABLED 0
+#endif
@@ -71,6 +71,7 @@ typedef struct HipcStaticDescriptor {
     u32 address_mid  : 4;
     u32 size         : 16;
     u32 address_low;
+    u32 address_ext; // Host only: address bits 42-63, as host address spaces are larger than 42 bits.
 } HipcStaticDescriptor;
 
 typedef struct HipcBufferDescriptor {
@@ -132,6 +133,7 @@ AMS_SF_HIPC_PARSE_IMPL_CONSTEXPR HipcStaticDescriptor hipcMakeSendStatic(const v
         .address_mid  = (u32)((uintptr_t)buffer >> 32),
         .size         = (u32)size,
         .address_low  = (u32)(uintptr_t)buffer,
+        .address_ext  = (u32)((uint64_t)(uintptr_t)buffer >> 42),
     };
 }
 
@@ -156,7 +158,7 @@ AMS_SF_HIPC_PARSE_IMPL_CONSTEXPR HipcRecvListEntry hipcMakeRecvStatic(void* buff
 
 AMS_SF_HIPC_PARSE_IMPL_CONSTEXPR void* hipcGetStaticAddress(const HipcStaticDescriptor* desc)
 {
-    return (void*)(desc->address_low | ((uintptr_t)desc->address_mid << 32) | ((uintptr_t)desc->address_high << 36));
+    return (void*)(desc->address_low | ((uintptr_t)desc->address_mid << 32) | ((uintptr_t)desc->address_high << 36) | ((uintptr_t)desc->address_ext << 42));
 }
 
 AMS_SF_HIPC_PARSE_IMPL_CONSTEXPR size_t hipcGetStaticSize(const HipcStaticDescriptor* desc)
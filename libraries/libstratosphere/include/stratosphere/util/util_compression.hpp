@@ -20,7 +20,10 @@
 namespace ams::util {
 
     /* Compression utilities. */
+    constexpr inline size_t CompressLZ4WorkBufferSize = 16_KB + 0x20;
+
     int CompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size);
+    int CompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size, void *work, size_t work_size);
 
     /* Decompression utilities. */
     int DecompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size);
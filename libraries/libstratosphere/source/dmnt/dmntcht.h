@@ -58,6 +58,29 @@ typedef struct {
     DmntFrozenAddressValue value;
 } DmntFrozenAddressEntry;
 
+typedef enum {
+    DmntMemorySearchCondition_Any       = 0,
+    DmntMemorySearchCondition_Equal     = 1,
+    DmntMemorySearchCondition_NotEqual  = 2,
+    DmntMemorySearchCondition_InRange   = 3,
+    DmntMemorySearchCondition_Changed   = 4,
+    DmntMemorySearchCondition_Unchanged = 5,
+    DmntMemorySearchCondition_Increased = 6,
+    DmntMemorySearchCondition_Decreased = 7,
+} DmntMemorySearchCondition;
+
+typedef struct {
+    u32 condition;
+    u32 width;
+    u64 value;
+    u64 range_max;
+} DmntMemorySearchParameters;
+
+typedef struct {
+    u64 address;
+    u64 value;
+} DmntMemorySearchResult;
+
 Result dmntchtInitialize(void);
 void dmntchtExit(void);
 Service* dmntchtGetServiceSession(void);
@@ -92,6 +115,12 @@ Result dmntchtGetFrozenAddresses(DmntFrozenAddressEntry *buffer, u64 max_count,
 Result dmntchtGetFrozenAddress(DmntFrozenAddressEntry *out, u64 address);
 Result dmntchtEnableFrozenAddress(u64 address, u64 width, u64 *out_value);
 Result dmntchtDisableFrozenAddress(u64 address);
+Result dmntchtSetFrozenAddressRefreshInterval(u64 interval_ms);
+
+Result dmntchtStartMemorySearch(const DmntMemorySearchParameters *params, u64 *out_count);
+Result dmntchtNarrowMemorySearch(const DmntMemorySearchParameters *params, u64 *out_count);
+Result dmntchtGetMemorySearchResults(DmntMemorySearchResult *buffer, u64 max_count, u64 offset, u64 *out_count);
+Result dmntchtEndMemorySearch(void);
 
 #ifdef __cplusplus
 }
@@ -205,3 +205,23 @@ Result dmntchtEnableFrozenAddress(u64 address, u64 width, u64 *out_value) {
 Result dmntchtDisableFrozenAddress(u64 address) {
     return serviceDispatchIn(&g_dmntchtSrv, 65304, address);
 }
+
+Result dmntchtSetFrozenAddressRefreshInterval(u64 interval_ms) {
+    return serviceDispatchIn(&g_dmntchtSrv, 65305, interval_ms);
+}
+
+Result dmntchtStartMemorySearch(const DmntMemorySearchParameters *params, u64 *out_count) {
+    return serviceDispatchInOut(&g_dmntchtSrv, 65400, *params, *out_count);
+}
+
+Result dmntchtNarrowMemorySearch(const DmntMemorySearchParameters *params, u64 *out_count) {
+    return serviceDispatchInOut(&g_dmntchtSrv, 65401, *params, *out_count);
+}
+
+Result dmntchtGetMemorySearchResults(DmntMemorySearchResult *buffer, u64 max_count, u64 offset, u64 *out_count) {
+    return _dmntchtGetEntries(buffer, sizeof(*buffer) * max_count, offset, out_count, 65402);
+}
+
+Result dmntchtEndMemorySearch(void) {
+    return _dmntchtCmdVoid(&g_dmntchtSrv, 65403);
+}
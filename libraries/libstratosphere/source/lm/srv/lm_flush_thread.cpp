@@ -124,7 +124,18 @@ namespace ams::lm::srv {
 
             /* Do flush loop. */
             do {
-                if (LogBuffer::GetDefaultInstance().Flush()) {
+                /* If the sd card logger is holding data, don't wait for new logs for longer than its flush interval. */
+                bool flushed;
+                if (SdCardLogger::GetInstance().HasPendingData()) {
+                    flushed = LogBuffer::GetDefaultInstance().TimedFlush(SdCardLogger::FlushInterval);
+                    if (!flushed) {
+                        SdCardLogger::GetInstance().FlushPendingData();
+                    }
+                } else {
+                    flushed = LogBuffer::GetDefaultInstance().Flush();
+                }
+
+                if (flushed) {
                     EventLogTransmitter::GetDefaultInstance().PushLogPacketDropCountIfExists();
                 }
             } while (WaitForFlush());
@@ -168,7 +168,7 @@ namespace ams::lm::srv {
         return true;
     }
 
-    bool LogBuffer::FlushImpl(bool blocking) {
+    bool LogBuffer::FlushImpl(bool blocking, util::optional<TimeSpan> timeout) {
         /* Acquire exclusive access to the flush buffer. */
         std::scoped_lock lk(m_flush_buffer_mutex);
 
@@ -185,7 +185,13 @@ namespace ams::lm::srv {
                 }
 
                 /* Wait for us to be ready to flush. */
-                m_cv_flush_ready.Wait(m_push_buffer_mutex);
+                if (timeout.has_value()) {
+                    if (!m_cv_flush_ready.TimedWait(m_push_buffer_mutex, *timeout)) {
+                        return false;
+                    }
+                } else {
+                    m_cv_flush_ready.Wait(m_push_buffer_mutex);
+                }
             }
 
             /* Swap the push buffer and the flush buffer pointers. */
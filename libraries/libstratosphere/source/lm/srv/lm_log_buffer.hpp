@@ -63,11 +63,12 @@ namespace ams::lm::srv {
 
             void CancelPush();
 
-            bool Flush() { return this->FlushImpl(true); }
-            bool TryFlush() { return this->FlushImpl(false); }
+            bool Flush() { return this->FlushImpl(true, util::nullopt); }
+            bool TryFlush() { return this->FlushImpl(false, util::nullopt); }
+            bool TimedFlush(TimeSpan timeout) { return this->FlushImpl(true, timeout); }
         private:
             bool PushImpl(const void *data, size_t size, bool blocking);
-            bool FlushImpl(bool blocking);
+            bool FlushImpl(bool blocking, util::optional<TimeSpan> timeout);
     };
 
 }
@@ -27,10 +27,12 @@ namespace ams::lm::srv {
         constexpr const char SettingName[]               = "lm";
         constexpr const char SettingKeyLoggingEnabled[]  = "enable_sd_card_logging";
         constexpr const char SettingKeyOutputDirectory[] = "sd_card_log_output_directory";
+        constexpr const char SettingKeyCompression[]     = "sd_card_log_compression";
 
-        constexpr inline size_t LogFileHeaderSize = 8;
-        constexpr inline u32 LogFileHeaderMagic   = util::ReverseFourCC<'p','h','p','h'>::Code;
-        constexpr inline u8 LogFileHeaderVersion  = 1;
+        constexpr inline size_t LogFileHeaderSize         = 8;
+        constexpr inline u32 LogFileHeaderMagic           = util::ReverseFourCC<'p','h','p','h'>::Code;
+        constexpr inline u32 LogFileHeaderMagicCompressed = util::ReverseFourCC<'p','h','p','z'>::Code;
+        constexpr inline u8 LogFileHeaderVersion          = 1;
 
         struct LogFileHeader {
             u32 magic;
@@ -39,6 +41,18 @@ namespace ams::lm::srv {
         };
         static_assert(sizeof(LogFileHeader) == LogFileHeaderSize);
 
+        /* Compressed log files contain a sequence of segments, each of which holds LZ4-compressed log packets. */
+        /* A segment with zero compressed size holds its packets uncompressed. */
+        constexpr inline u32 LogSegmentHeaderMagic = util::FourCC<'L','Z','4','S'>::Code;
+
+        struct LogSegmentHeader {
+            u32 magic;
+            u32 size;
+            u32 compressed_size;
+            u32 reserved;
+        };
+        static_assert(sizeof(LogSegmentHeader) == 0x10);
+
         constinit os::SdkMutex g_sd_card_logging_enabled_mutex;
         constinit bool g_determined_sd_card_logging_enabled = false;
         constinit bool g_sd_card_logging_enabled = false;
@@ -73,6 +87,12 @@ namespace ams::lm::srv {
             return g_sd_card_logging_enabled;
         }
 
+        bool GetSdCardLogCompressionEnabled() {
+            u8 enabled;
+            const auto size = settings::fwdbg::GetSettingsItemValue(std::addressof(enabled), sizeof(enabled), SettingName, SettingKeyCompression);
+            return size == sizeof(enabled) && enabled != 0;
+        }
+
         void EnsureSdCardDetectionEventInitialized() {
             if (AMS_UNLIKELY(!g_sd_card_detection_event_initialized)) {
                 std::scoped_lock lk(g_sd_card_detection_event_mutex);
@@ -185,42 +205,13 @@ namespace ams::lm::srv {
             return false;
         }
 
-        Result WriteLogFileHeaderImpl(const char *path) {
-            /* Open the log file. */
-            fs::FileHandle file;
-            R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Write | fs::OpenMode_AllowAppend));
-            ON_SCOPE_EXIT { fs::CloseFile(file); };
-
-            /* Write the log file header. */
-            const LogFileHeader header = {
-                .magic   = LogFileHeaderMagic,
-                .version = LogFileHeaderVersion
-            };
-
-            R_RETURN(fs::WriteFile(file, 0, std::addressof(header), sizeof(header), fs::WriteOption::Flush));
-        }
-
-        bool WriteLogFileHeader(const char *path) {
-            return R_SUCCEEDED(WriteLogFileHeaderImpl(path));
-        }
-
-        Result WriteLogFileBodyImpl(const char *path, s64 offset, const u8 *data, size_t size) {
-            /* Open the log file. */
-            fs::FileHandle file;
-            R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Write | fs::OpenMode_AllowAppend));
-            ON_SCOPE_EXIT { fs::CloseFile(file); };
-
-            /* Write the data. */
-            R_RETURN(fs::WriteFile(file, offset, data, size, fs::WriteOption::Flush));
-        }
-
-        bool WriteLogFileBody(const char *path, s64 offset, const u8 *data, size_t size) {
-            return R_SUCCEEDED(WriteLogFileBodyImpl(path, offset, data, size));
-        }
-
     }
 
-    SdCardLogger::SdCardLogger() : m_logging_observer_mutex(), m_is_enabled(false), m_is_sd_card_mounted(false), m_is_sd_card_status_unknown(false), m_log_file_offset(0), m_logging_observer(nullptr) {
+    SdCardLogger::SdCardLogger()
+        : m_logging_observer_mutex(), m_is_enabled(false), m_is_sd_card_mounted(false), m_is_sd_card_status_unknown(false), m_is_log_file_open(false),
+          m_is_compression_enabled(false), m_log_file(), m_log_file_offset(0), m_buffered_size(0), m_written_size(0), m_segment_size(0), m_pending_tick(0),
+          m_logging_observer(nullptr), m_compression_memory(0), m_segment_buffer(nullptr), m_compression_work_buffer(nullptr)
+    {
         /* ... */
     }
 
@@ -285,33 +276,291 @@ namespace ams::lm::srv {
         m_is_sd_card_mounted = true;
 
         /* Get the output directory. */
-        char output_dir[0x80];
-        if (!GetSdCardLogOutputDirectory(output_dir, sizeof(output_dir))) {
+        if (!GetSdCardLogOutputDirectory(m_log_directory, sizeof(m_log_directory))) {
             return false;
         }
 
         /* Ensure the output directory exists. */
-        if (!EnsureLogDirectory(output_dir)) {
+        if (!EnsureLogDirectory(m_log_directory)) {
+            return false;
+        }
+
+        /* Determine whether we should compress our logs. */
+        /* NOTE: If we can't get memory to compress with, we fall back to writing uncompressed logs. */
+        m_is_compression_enabled = GetSdCardLogCompressionEnabled() && this->EnsureCompressionMemory();
+
+        /* Open a log file to write to. */
+        return this->OpenLogFile();
+    }
+
+    bool SdCardLogger::EnsureCompressionMemory() {
+        /* If we've already allocated our memory, we're done. */
+        if (m_compression_memory != 0) {
+            return true;
+        }
+
+        /* Allocate memory from the heap. */
+        if (R_FAILED(os::SetMemoryHeapSize(CompressionMemorySize))) {
+            return false;
+        }
+
+        if (R_FAILED(os::AllocateMemoryBlock(std::addressof(m_compression_memory), CompressionMemorySize))) {
+            os::SetMemoryHeapSize(0);
             return false;
         }
 
+        /* Carve our buffers out of the memory. */
+        m_segment_buffer          = reinterpret_cast<u8 *>(m_compression_memory);
+        m_compression_work_buffer = reinterpret_cast<void *>(m_compression_memory + SegmentSize);
+
+        return true;
+    }
+
+    void SdCardLogger::FreeCompressionMemory() {
+        /* If we have no memory, there's nothing to do. */
+        if (m_compression_memory == 0) {
+            return;
+        }
+
+        AMS_ASSERT(m_segment_size == 0);
+
+        m_segment_buffer          = nullptr;
+        m_compression_work_buffer = nullptr;
+
+        /* Return the memory to the heap, and release the heap. */
+        os::FreeMemoryBlock(m_compression_memory, CompressionMemorySize);
+        R_ABORT_UNLESS(os::SetMemoryHeapSize(0));
+
+        m_compression_memory = 0;
+    }
+
+    bool SdCardLogger::OpenLogFile() {
+        AMS_ASSERT(!m_is_log_file_open);
+
         /* Ensure that a log file exists for us to write to. */
-        if (!GenerateLogFile(m_log_file_path, sizeof(m_log_file_path), output_dir)) {
+        if (!GenerateLogFile(m_log_file_path, sizeof(m_log_file_path), m_log_directory)) {
             return false;
         }
 
-        /* Write the log file header. */
-        if (!WriteLogFileHeader(m_log_file_path)) {
+        /* Open the log file. */
+        if (R_FAILED(fs::OpenFile(std::addressof(m_log_file), m_log_file_path, fs::OpenMode_Write | fs::OpenMode_AllowAppend))) {
             return false;
         }
 
+        m_is_log_file_open = true;
+
         /* Set our initial offset. */
-        m_log_file_offset = LogFileHeaderSize;
+        m_log_file_offset = 0;
+        m_buffered_size   = 0;
+        m_written_size    = 0;
+        m_segment_size    = 0;
+
+        /* Buffer the log file header, to be written along with the first logs. */
+        const LogFileHeader header = {
+            .magic   = m_is_compression_enabled ? LogFileHeaderMagicCompressed : LogFileHeaderMagic,
+            .version = LogFileHeaderVersion
+        };
+
+        this->Buffer(reinterpret_cast<const u8 *>(std::addressof(header)), sizeof(header));
+
+        return true;
+    }
+
+    void SdCardLogger::CloseLogFile() {
+        if (!m_is_log_file_open) {
+            return;
+        }
+
+        /* Flush the file, so that we may close it even if our last write failed. */
+        fs::FlushFile(m_log_file);
+        fs::CloseFile(m_log_file);
+
+        /* Discard anything we didn't write. */
+        m_is_log_file_open = false;
+        m_buffered_size    = 0;
+        m_written_size     = 0;
+        m_segment_size     = 0;
+    }
+
+    bool SdCardLogger::RotateLogFile() {
+        /* Write out everything for the current log file. */
+        if (!this->FlushWriteBuffer(true)) {
+            return false;
+        }
+
+        /* Close the current log file, and open a new one. */
+        this->CloseLogFile();
+        return this->OpenLogFile();
+    }
+
+    void SdCardLogger::Buffer(const u8 *data, size_t size) {
+        AMS_ASSERT(size <= WriteBufferSize - m_buffered_size);
+
+        /* If this is the oldest data we're holding, note when we received it. */
+        if (!this->HasPendingData()) {
+            m_pending_tick = os::GetSystemTick();
+        }
+
+        std::memcpy(m_write_buffer + m_buffered_size, data, size);
+        m_buffered_size += size;
+    }
+
+    bool SdCardLogger::Append(const u8 *data, size_t size) {
+        /* Buffer the data, writing out the buffer whenever it fills. */
+        while (size > 0) {
+            const size_t cur_size = std::min(size, WriteBufferSize - m_buffered_size);
+            this->Buffer(data, cur_size);
+
+            data += cur_size;
+            size -= cur_size;
+
+            if (m_buffered_size == WriteBufferSize) {
+                if (!this->WriteBufferToFile(false)) {
+                    return false;
+                }
+            }
+        }
 
         return true;
     }
 
+    bool SdCardLogger::AppendToSegment(const u8 *data, size_t size) {
+        /* Collect the data into our segment, compressing the segment whenever it fills. */
+        while (size > 0) {
+            /* If this is the oldest data we're holding, note when we received it. */
+            if (!this->HasPendingData()) {
+                m_pending_tick = os::GetSystemTick();
+            }
+
+            const size_t cur_size = std::min(size, SegmentSize - m_segment_size);
+            std::memcpy(m_segment_buffer + m_segment_size, data, cur_size);
+            m_segment_size += cur_size;
+
+            data += cur_size;
+            size -= cur_size;
+
+            if (m_segment_size == SegmentSize) {
+                if (!this->CompressSegment()) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SdCardLogger::CompressSegment() {
+        /* If we have no segment, there's nothing to do. */
+        if (m_segment_size == 0) {
+            return true;
+        }
+
+        /* Ensure that the write buffer has space for the whole segment. */
+        /* NOTE: Writing leaves less than one alignment unit in the buffer, so this always succeeds in making space. */
+        if (WriteBufferSize - m_buffered_size < sizeof(LogSegmentHeader) + m_segment_size) {
+            if (!this->WriteBufferToFile(false)) {
+                return false;
+            }
+        }
+        AMS_ASSERT(WriteBufferSize - m_buffered_size >= sizeof(LogSegmentHeader) + m_segment_size);
+
+        /* Compress the segment directly into the write buffer. */
+        /* NOTE: We only keep the compressed data if it's smaller than the input, so that segments never grow. */
+        u8 *payload = m_write_buffer + m_buffered_size + sizeof(LogSegmentHeader);
+        const int compressed_size = util::CompressLZ4(payload, m_segment_size - 1, m_segment_buffer, m_segment_size, m_compression_work_buffer, util::CompressLZ4WorkBufferSize);
+        if (compressed_size <= 0) {
+            std::memcpy(payload, m_segment_buffer, m_segment_size);
+        }
+
+        /* Write the segment header. */
+        const LogSegmentHeader header = {
+            .magic           = LogSegmentHeaderMagic,
+            .size            = static_cast<u32>(m_segment_size),
+            .compressed_size = static_cast<u32>(std::max(compressed_size, 0)),
+            .reserved        = 0,
+        };
+        std::memcpy(m_write_buffer + m_buffered_size, std::addressof(header), sizeof(header));
+
+        /* Advance. */
+        m_buffered_size += sizeof(header) + (compressed_size > 0 ? static_cast<size_t>(compressed_size) : m_segment_size);
+        m_segment_size   = 0;
+
+        return true;
+    }
+
+    bool SdCardLogger::FlushWriteBuffer(bool flush) {
+        AMS_ASSERT(m_is_log_file_open);
+
+        /* Compress any partial segment we're holding. */
+        if (!this->CompressSegment()) {
+            return false;
+        }
+
+        return this->WriteBufferToFile(flush);
+    }
+
+    bool SdCardLogger::WriteBufferToFile(bool flush) {
+        AMS_ASSERT(m_is_log_file_open);
+
+        /* If everything we have is written, there's nothing to do. */
+        if (m_written_size == m_buffered_size) {
+            return true;
+        }
+
+        /* Write the buffer. */
+        /* NOTE: The buffer always starts at an aligned offset, so we re-write any partial block left over from our last write. */
+        if (R_FAILED(fs::WriteFile(m_log_file, m_log_file_offset, m_write_buffer, m_buffered_size, flush ? fs::WriteOption::Flush : fs::WriteOption::None))) {
+            return false;
+        }
+
+        /* Keep the trailing partial block, so that our next write starts at an aligned offset. */
+        const size_t aligned_size = util::AlignDown(m_buffered_size, WriteAlignment);
+        std::memmove(m_write_buffer, m_write_buffer + aligned_size, m_buffered_size - aligned_size);
+
+        m_log_file_offset += aligned_size;
+        m_buffered_size   -= aligned_size;
+        m_written_size     = m_buffered_size;
+
+        return true;
+    }
+
+    void SdCardLogger::HandleWriteFailure() {
+        /* Close our log file, and unmount the sd card, since it may have been removed. */
+        this->CloseLogFile();
+
+        if (m_is_sd_card_mounted) {
+            fs::Unmount(SdCardMountName);
+            m_is_sd_card_mounted        = false;
+            m_is_sd_card_status_unknown = true;
+        }
+
+        this->SetEnabled(false);
+    }
+
+    bool SdCardLogger::HasPendingData() const {
+        return m_written_size < m_buffered_size || m_segment_size > 0;
+    }
+
+    void SdCardLogger::FlushPendingData() {
+        /* If we're not logging, there's nothing to flush. */
+        if (!m_is_log_file_open) {
+            return;
+        }
+
+        if (!this->FlushWriteBuffer(true)) {
+            this->HandleWriteFailure();
+        }
+    }
+
     void SdCardLogger::Finalize() {
+        /* Write out anything we're holding, and close our log file. */
+        if (m_is_log_file_open) {
+            this->FlushWriteBuffer(true);
+            this->CloseLogFile();
+        }
+
+        this->FreeCompressionMemory();
+
         this->SetEnabled(false);
         if (m_is_sd_card_mounted) {
             fs::Unmount(SdCardMountName);
@@ -328,12 +577,11 @@ namespace ams::lm::srv {
         /* Ensure we keep our pre and post-conditions in check. */
         bool success = false;
         ON_SCOPE_EXIT {
-            if (!success && m_is_sd_card_mounted) {
-                fs::Unmount(SdCardMountName);
-                m_is_sd_card_mounted        = false;
-                m_is_sd_card_status_unknown = true;
+            if (success) {
+                this->SetEnabled(true);
+            } else {
+                this->HandleWriteFailure();
             }
-            this->SetEnabled(success);
         };
 
         /* Try to initialize. */
@@ -341,13 +589,26 @@ namespace ams::lm::srv {
             return false;
         }
 
-        /* Try to write the log file. */
-        if (!WriteLogFileBody(m_log_file_path, m_log_file_offset, data, size)) {
+        /* If the data would make our log file too large, start a new one. */
+        /* NOTE: We don't split data across log files, so that every log file begins with a complete packet. */
+        const s64 log_file_size = m_log_file_offset + static_cast<s64>(m_buffered_size + m_segment_size);
+        if (log_file_size > static_cast<s64>(LogFileHeaderSize) && log_file_size + static_cast<s64>(size) > MaxLogFileSize) {
+            if (!this->RotateLogFile()) {
+                return false;
+            }
+        }
+
+        /* Buffer the data. */
+        if (!(m_is_compression_enabled ? this->AppendToSegment(data, size) : this->Append(data, size))) {
             return false;
         }
 
-        /* Advance. */
-        m_log_file_offset += size;
+        /* If we've been holding data for long enough, write and flush it. */
+        if (this->HasPendingData() && (os::GetSystemTick() - m_pending_tick).ToTimeSpan() >= FlushInterval) {
+            if (!this->FlushWriteBuffer(true)) {
+                return false;
+            }
+        }
 
         /* We succeeded. */
         success = true;
@@ -18,29 +18,77 @@
 
 namespace ams::lm::srv {
 
+    /* NOTE: The log file is kept open while logging, and writes are batched in a buffer whose contents are written out at aligned offsets. */
+    /* All accesses happen on the flush thread, which is responsible for calling FlushPendingData() when data has been buffered for too long. */
     class SdCardLogger {
         AMS_SINGLETON_TRAITS(SdCardLogger);
         public:
             using LoggingObserver = void (*)(bool available);
+        public:
+            static constexpr inline TimeSpan FlushInterval = TimeSpan::FromSeconds(1);
+        private:
+            static constexpr inline size_t WriteBufferSize = 32_KB;
+            static constexpr inline size_t WriteAlignment  = 4_KB;
+            static constexpr inline s64 MaxLogFileSize     = 64_MB;
+            static_assert(util::IsAligned(WriteBufferSize, WriteAlignment));
+
+            /* When compression is enabled, logs are collected into segments, which are compressed before being written. */
+            static constexpr inline size_t SegmentSize = 16_KB;
+            static_assert(SegmentSize <= WriteBufferSize - WriteAlignment);
+
+            /* The segment and LZ4's work buffer are only needed when compressing, so they're allocated from the memory heap on demand. */
+            static constexpr inline size_t CompressionMemorySize = util::AlignUp(SegmentSize + util::CompressLZ4WorkBufferSize, os::MemoryHeapUnitSize);
         private:
             os::SdkMutex m_logging_observer_mutex;
             bool m_is_enabled;
             bool m_is_sd_card_mounted;
             bool m_is_sd_card_status_unknown;
+            bool m_is_log_file_open;
+            bool m_is_compression_enabled;
+            char m_log_directory[0x80];
             char m_log_file_path[0x80];
+            fs::FileHandle m_log_file;
             s64 m_log_file_offset;
+            size_t m_buffered_size;
+            size_t m_written_size;
+            size_t m_segment_size;
+            os::Tick m_pending_tick;
             LoggingObserver m_logging_observer;
+            uintptr_t m_compression_memory;
+            u8 *m_segment_buffer;
+            void *m_compression_work_buffer;
+            alignas(WriteAlignment) u8 m_write_buffer[WriteBufferSize];
         public:
             void Finalize();
 
             void SetLoggingObserver(LoggingObserver observer);
 
             bool Write(const u8 *data, size_t size);
+
+            bool HasPendingData() const;
+            void FlushPendingData();
         private:
             bool GetEnabled() const;
             void SetEnabled(bool enabled);
 
             bool Initialize();
+
+            bool EnsureCompressionMemory();
+            void FreeCompressionMemory();
+
+            bool OpenLogFile();
+            void CloseLogFile();
+            bool RotateLogFile();
+
+            void Buffer(const u8 *data, size_t size);
+            bool Append(const u8 *data, size_t size);
+            bool AppendToSegment(const u8 *data, size_t size);
+            bool CompressSegment();
+
+            bool WriteBufferToFile(bool flush);
+            bool FlushWriteBuffer(bool flush);
+
+            void HandleWriteFailure();
     };
 
 }
@@ -22,6 +22,7 @@ namespace ams::lmem::impl {
 
         constexpr u16 FreeBlockMagic = 0x4652; /* FR */
         constexpr u16 UsedBlockMagic = 0x5544; /* UD */
+        constexpr u16 PaddingMagic   = 0x5044; /* PD */
 
         constexpr u16 DefaultGroupId = 0x00;
         constexpr u16 MaxGroupId     = 0xFF;
@@ -33,11 +34,44 @@ namespace ams::lmem::impl {
 
         constexpr size_t MinimumFreeBlockSize    = 4;
 
+        /* In segregated fit mode, free blocks are additionally kept in size class bins, indexed by two levels of bitmaps. */
+        /* The first level is the power of two of the block size, and the second level subdivides it linearly. */
+        constexpr size_t BinSecondLevelShift = 3;
+        constexpr size_t BinSecondLevelCount = 1 << BinSecondLevelShift;
+        constexpr size_t BinSmallSizeShift   = 5;
+        constexpr size_t BinSmallSizeMax     = 1 << BinSmallSizeShift;
+
         struct MemoryRegion {
             void *start;
             void *end;
         };
 
+        /* In segregated fit mode, every byte of the heap belongs to some block, so that a block's neighbors can be found in constant time. */
+        /* Binned free blocks store their bin links at the start of their memory, and all free blocks store a pointer to their head at the end. */
+        /* The footer is only ever read when the next block's head says that the block before it is free. */
+        struct ExpHeapFreeBlockLinks {
+            ExpHeapMemoryBlockHead *prev;
+            ExpHeapMemoryBlockHead *next;
+        };
+
+        /* Used blocks with alignment padding mark the start of their region, so that their head can be found from it. */
+        struct ExpHeapPaddingMarker {
+            u16 magic;
+            u16 padding;
+        };
+        static_assert(sizeof(ExpHeapPaddingMarker) == MinimumAlignment);
+
+        constexpr size_t FreeBlockFooterSize    = sizeof(ExpHeapMemoryBlockHead *);
+        constexpr size_t BinnedFreeBlockSizeMin = sizeof(ExpHeapFreeBlockLinks) + FreeBlockFooterSize;
+
+        /* The bin table lives just past the end of the heap, and is followed by the second level bitmaps and the bins themselves. */
+        struct ExpHeapBinTable {
+            u64 first_level_bitmap;
+            u32 first_level_count;
+            u32 table_size;
+        };
+        static_assert(sizeof(ExpHeapBinTable) == 0x10);
+
         inline bool IsValidHeapHandle(HeapHandle handle) {
             return handle->magic == ExpHeapMagic;
         }
@@ -133,6 +167,15 @@ namespace ams::lmem::impl {
             block_head->attributes |= static_cast<decltype(block_head->attributes)>(dir) << 15;
         }
 
+        inline bool IsPreviousMemoryBlockFree(const ExpHeapMemoryBlockHead *block_head) {
+            return ((block_head->attributes >> 16) & 1) != 0;
+        }
+
+        inline void SetPreviousMemoryBlockFree(ExpHeapMemoryBlockHead *block_head, bool is_free) {
+            block_head->attributes &= ~static_cast<decltype(block_head->attributes)>(0x10000);
+            block_head->attributes |= static_cast<decltype(block_head->attributes)>(is_free) << 16;
+        }
+
         inline void GetMemoryBlockRegion(MemoryRegion *out, ExpHeapMemoryBlockHead *head)  {
             out->start = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(head) - GetMemoryBlockAlignmentPadding(head));
             out->end   = GetMemoryBlockEnd(head);
@@ -146,6 +189,264 @@ namespace ams::lmem::impl {
             head->mode = mode;
         }
 
+        inline bool IsSegregatedFit(const ExpHeapHead *head) {
+            return GetAllocationModeImpl(head) == AllocationMode_SegregatedFit;
+        }
+
+        inline size_t GetMinimumFreeBlockSize(const ExpHeapHead *head) {
+            /* In segregated fit mode, free blocks must be able to hold a footer. */
+            return IsSegregatedFit(head) ? FreeBlockFooterSize : MinimumFreeBlockSize;
+        }
+
+        constexpr inline void GetBinIndex(size_t *out_first, size_t *out_second, size_t size) {
+            if (size < BinSmallSizeMax) {
+                *out_first  = 0;
+                *out_second = size >> (BinSmallSizeShift - BinSecondLevelShift);
+            } else {
+                const size_t msb = BITSIZEOF(size_t) - 1 - util::CountLeadingZeros(size);
+                *out_first  = msb - BinSmallSizeShift + 1;
+                *out_second = (size >> (msb - BinSecondLevelShift)) - BinSecondLevelCount;
+            }
+        }
+
+        constexpr inline size_t GetBinSearchSize(size_t size) {
+            /* Round the size up to the start of the next bin, so that any block in the bin we find is large enough. */
+            if (size >= BinSmallSizeMax) {
+                const size_t msb = BITSIZEOF(size_t) - 1 - util::CountLeadingZeros(size);
+                size += (static_cast<size_t>(1) << (msb - BinSecondLevelShift)) - 1;
+            }
+            return size;
+        }
+
+        constexpr inline size_t GetBinTableSize(size_t first_level_count) {
+            return sizeof(ExpHeapBinTable) + util::AlignUp(first_level_count, alignof(ExpHeapMemoryBlockHead *)) + first_level_count * BinSecondLevelCount * sizeof(ExpHeapMemoryBlockHead *);
+        }
+
+        inline ExpHeapBinTable *GetBinTable(const HeapHead *heap) {
+            return reinterpret_cast<ExpHeapBinTable *>(heap->heap_end);
+        }
+
+        inline u8 *GetBinSecondLevelBitmaps(ExpHeapBinTable *table) {
+            return reinterpret_cast<u8 *>(table + 1);
+        }
+
+        inline ExpHeapMemoryBlockHead **GetBin(ExpHeapBinTable *table, size_t first, size_t second) {
+            ExpHeapMemoryBlockHead **bins = reinterpret_cast<ExpHeapMemoryBlockHead **>(GetBinSecondLevelBitmaps(table) + util::AlignUp(table->first_level_count, alignof(ExpHeapMemoryBlockHead *)));
+            return bins + first * BinSecondLevelCount + second;
+        }
+
+        inline ExpHeapFreeBlockLinks *GetFreeBlockLinks(ExpHeapMemoryBlockHead *head) {
+            return reinterpret_cast<ExpHeapFreeBlockLinks *>(GetMemoryBlockStart(head));
+        }
+
+        inline void WriteFreeBlockFooter(ExpHeapMemoryBlockHead *head) {
+            if (head->block_size >= FreeBlockFooterSize) {
+                std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(GetMemoryBlockEnd(head)) - FreeBlockFooterSize), std::addressof(head), sizeof(head));
+            }
+        }
+
+        inline void WriteMemoryBlockPaddingMarker(ExpHeapMemoryBlockHead *head) {
+            if (const u16 padding = GetMemoryBlockAlignmentPadding(head); padding != 0) {
+                const ExpHeapPaddingMarker marker = { .magic = PaddingMagic, .padding = padding };
+                std::memcpy(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(head) - padding), std::addressof(marker), sizeof(marker));
+            }
+        }
+
+        ExpHeapMemoryBlockHead *GetMemoryBlockHeadForRegion(const HeapHead *heap, void *address) {
+            /* There's no block past the end of the heap. */
+            if (reinterpret_cast<uintptr_t>(address) >= reinterpret_cast<uintptr_t>(heap->heap_end)) {
+                return nullptr;
+            }
+
+            /* The region starts either with a block head, or with a padding marker. */
+            ExpHeapPaddingMarker marker;
+            std::memcpy(std::addressof(marker), address, sizeof(marker));
+            if (marker.magic == PaddingMagic) {
+                return reinterpret_cast<ExpHeapMemoryBlockHead *>(reinterpret_cast<uintptr_t>(address) + marker.padding);
+            }
+
+            AMS_ASSERT(marker.magic == FreeBlockMagic || marker.magic == UsedBlockMagic);
+            return reinterpret_cast<ExpHeapMemoryBlockHead *>(address);
+        }
+
+        inline void SetNextMemoryBlockPreviousFree(const HeapHead *heap, ExpHeapMemoryBlockHead *head, bool is_free) {
+            if (ExpHeapMemoryBlockHead *next = GetMemoryBlockHeadForRegion(heap, GetMemoryBlockEnd(head)); next != nullptr) {
+                SetPreviousMemoryBlockFree(next, is_free);
+            }
+        }
+
+        void InsertFreeBlockToBin(ExpHeapBinTable *table, ExpHeapMemoryBlockHead *head) {
+            /* Blocks too small to hold bin links are never allocated from in segregated fit mode. */
+            if (head->block_size < BinnedFreeBlockSizeMin) {
+                return;
+            }
+
+            size_t first, second;
+            GetBinIndex(std::addressof(first), std::addressof(second), head->block_size);
+            AMS_ASSERT(first < table->first_level_count);
+
+            /* Link the block at the head of its bin. */
+            ExpHeapMemoryBlockHead **bin = GetBin(table, first, second);
+            ExpHeapFreeBlockLinks *links = GetFreeBlockLinks(head);
+            links->prev = nullptr;
+            links->next = *bin;
+            if (*bin != nullptr) {
+                GetFreeBlockLinks(*bin)->prev = head;
+            }
+            *bin = head;
+
+            /* Mark the bin as non-empty. */
+            GetBinSecondLevelBitmaps(table)[first] |= static_cast<u8>(1u << second);
+            table->first_level_bitmap              |= static_cast<u64>(1) << first;
+        }
+
+        void RemoveFreeBlockFromBin(ExpHeapBinTable *table, ExpHeapMemoryBlockHead *head) {
+            if (head->block_size < BinnedFreeBlockSizeMin) {
+                return;
+            }
+
+            size_t first, second;
+            GetBinIndex(std::addressof(first), std::addressof(second), head->block_size);
+
+            /* Unlink the block. */
+            ExpHeapMemoryBlockHead **bin = GetBin(table, first, second);
+            ExpHeapFreeBlockLinks *links = GetFreeBlockLinks(head);
+            if (links->prev != nullptr) {
+                GetFreeBlockLinks(links->prev)->next = links->next;
+            } else {
+                *bin = links->next;
+            }
+            if (links->next != nullptr) {
+                GetFreeBlockLinks(links->next)->prev = links->prev;
+            }
+
+            /* If the bin is now empty, clear its bits. */
+            if (*bin == nullptr) {
+                u8 &second_level_bitmap = GetBinSecondLevelBitmaps(table)[first];
+                second_level_bitmap &= ~static_cast<u8>(1u << second);
+                if (second_level_bitmap == 0) {
+                    table->first_level_bitmap &= ~(static_cast<u64>(1) << first);
+                }
+            }
+        }
+
+        ExpHeapMemoryBlockHead *FindFreeBlockInBins(ExpHeapBinTable *table, size_t size) {
+            /* Find the first bin whose blocks are all at least the requested size. */
+            size_t first, second;
+            GetBinIndex(std::addressof(first), std::addressof(second), GetBinSearchSize(size));
+            if (first >= table->first_level_count) {
+                return nullptr;
+            }
+
+            /* Look for a non-empty bin in the same first level, and otherwise in the next non-empty first level. */
+            u32 second_level_bitmap = GetBinSecondLevelBitmaps(table)[first] & (~0u << second);
+            if (second_level_bitmap == 0) {
+                const u64 first_level_bitmap = (first + 1 < BITSIZEOF(u64)) ? (table->first_level_bitmap & (~static_cast<u64>(0) << (first + 1))) : 0;
+                if (first_level_bitmap == 0) {
+                    return nullptr;
+                }
+
+                first               = util::CountTrailingZeros(first_level_bitmap);
+                second_level_bitmap = GetBinSecondLevelBitmaps(table)[first];
+            }
+
+            return *GetBin(table, first, util::CountTrailingZeros(second_level_bitmap));
+        }
+
+        void *GetAllocationAddress(ExpHeapMemoryBlockHead *block_head, size_t size, s32 alignment, AllocationDirection direction) {
+            /* Place the allocation at the aligned start of the block, or at the aligned end when allocating from the back. */
+            const uintptr_t block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(block_head));
+            const uintptr_t block_end   = reinterpret_cast<uintptr_t>(GetMemoryBlockEnd(block_head));
+            if (block_head->block_size < size) {
+                return nullptr;
+            }
+
+            const uintptr_t address = direction == AllocationDirection_Front ? util::AlignUp(block_start, alignment) : util::AlignDown(block_end - size, alignment);
+            if (address < block_start || address + size > block_end) {
+                return nullptr;
+            }
+
+            return reinterpret_cast<void *>(address);
+        }
+
+        ExpHeapMemoryBlockHead *FindFittingFreeBlockInBins(ExpHeapBinTable *table, void **out_address, size_t size, size_t required_size, s32 alignment, AllocationDirection direction) {
+            /* The rounded search skips the bins which hold both blocks that fit and blocks that don't, so check those blocks individually. */
+            size_t first, second, last_first, last_second;
+            GetBinIndex(std::addressof(first), std::addressof(second), size);
+            GetBinIndex(std::addressof(last_first), std::addressof(last_second), required_size);
+            if (last_first >= table->first_level_count) {
+                last_first  = table->first_level_count - 1;
+                last_second = BinSecondLevelCount - 1;
+            }
+
+            for (size_t bin_index = first * BinSecondLevelCount + second; bin_index <= last_first * BinSecondLevelCount + last_second; ++bin_index) {
+                const size_t cur_first  = bin_index / BinSecondLevelCount;
+                const size_t cur_second = bin_index % BinSecondLevelCount;
+                if ((GetBinSecondLevelBitmaps(table)[cur_first] & (1u << cur_second)) == 0) {
+                    continue;
+                }
+
+                for (ExpHeapMemoryBlockHead *block_head = *GetBin(table, cur_first, cur_second); block_head != nullptr; block_head = GetFreeBlockLinks(block_head)->next) {
+                    if (void *address = GetAllocationAddress(block_head, size, alignment, direction); address != nullptr) {
+                        *out_address = address;
+                        return block_head;
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+
+        ExpHeapMemoryBlockHead *FindFreeBlockStartingAt(const HeapHead *heap, void *address) {
+            /* Check that a block head could fit at the address. */
+            const uintptr_t block = reinterpret_cast<uintptr_t>(address);
+            if (block + sizeof(ExpHeapMemoryBlockHead) > reinterpret_cast<uintptr_t>(heap->heap_end)) {
+                return nullptr;
+            }
+
+            /* Check that the head is a free block within the heap. */
+            ExpHeapMemoryBlockHead *head = reinterpret_cast<ExpHeapMemoryBlockHead *>(address);
+            if (head->magic != FreeBlockMagic || reinterpret_cast<uintptr_t>(GetMemoryBlockEnd(head)) > reinterpret_cast<uintptr_t>(heap->heap_end)) {
+                return nullptr;
+            }
+
+            return head;
+        }
+
+        ExpHeapMemoryBlockHead *GetPreviousFreeMemoryBlock(void *region_start) {
+            /* Read the footer written by the free block before the region. */
+            ExpHeapMemoryBlockHead *head;
+            std::memcpy(std::addressof(head), reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(region_start) - FreeBlockFooterSize), sizeof(head));
+
+            AMS_ASSERT(head->magic == FreeBlockMagic);
+            AMS_ASSERT(GetMemoryBlockEnd(head) == region_start);
+            return head;
+        }
+
+        ExpHeapMemoryBlockList::iterator InsertFreeMemoryBlock(ExpHeapHead *head, ExpHeapMemoryBlockList::const_iterator pos, ExpHeapMemoryBlockHead *block) {
+            if (IsSegregatedFit(head)) {
+                WriteFreeBlockFooter(block);
+                InsertFreeBlockToBin(GetBinTable(GetHeapHead(head)), block);
+
+                /* Blocks too small to hold a footer can't be found from the block after them. */
+                SetNextMemoryBlockPreviousFree(GetHeapHead(head), block, block->block_size >= FreeBlockFooterSize);
+            }
+
+            return head->free_list.insert(pos, *block);
+        }
+
+        ExpHeapMemoryBlockList::iterator EraseFreeMemoryBlock(ExpHeapHead *head, ExpHeapMemoryBlockHead *block) {
+            if (IsSegregatedFit(head)) {
+                RemoveFreeBlockFromBin(GetBinTable(GetHeapHead(head)), block);
+                SetNextMemoryBlockPreviousFree(GetHeapHead(head), block, false);
+            }
+
+            /* Clear the magic, so that the stale head is never mistaken for a free block. */
+            auto it = head->free_list.erase(head->free_list.iterator_to(*block));
+            block->magic = 0;
+            return it;
+        }
+
         inline ExpHeapMemoryBlockHead *InitializeMemoryBlock(const MemoryRegion &region, u16 magic) {
             /* Construct the block. */
             ExpHeapMemoryBlockHead *block = std::construct_at(reinterpret_cast<ExpHeapMemoryBlockHead *>(region.start));
@@ -185,13 +486,57 @@ namespace ams::lmem::impl {
             /* Initialize memory block. */
             {
                 MemoryRegion region{ .start = heap_head->heap_start, .end = heap_head->heap_end, };
-                exp_heap_head->free_list.push_back(*InitializeFreeMemoryBlock(region));
+                InsertFreeMemoryBlock(exp_heap_head, exp_heap_head->free_list.end(), InitializeFreeMemoryBlock(region));
             }
 
             return heap_head;
         }
 
-        bool CoalesceFreedRegion(ExpHeapHead *head, const MemoryRegion *region) {
+        bool CoalesceFreedRegionWithBins(ExpHeapHead *head, const MemoryRegion *region, bool is_previous_free) {
+            HeapHead *heap = GetHeapHead(head);
+            MemoryRegion free_region = *region;
+
+            /* Without a neighbor to take the place of, new blocks go at the end of the free list. */
+            auto insertion_it = head->free_list.end();
+
+            /* Coalesce block after, if possible. */
+            if (ExpHeapMemoryBlockHead *next_free_block = FindFreeBlockStartingAt(heap, region->end); next_free_block != nullptr) {
+                free_region.end = GetMemoryBlockEnd(next_free_block);
+                insertion_it = EraseFreeMemoryBlock(head, next_free_block);
+
+                /* Fill the memory with a pattern, for debug. */
+                FillUnallocatedMemory(heap, next_free_block, sizeof(ExpHeapMemoryBlockHead));
+            }
+
+            /* Coalesce block before, if possible. */
+            if (is_previous_free) {
+                ExpHeapMemoryBlockHead *prev_free_block = GetPreviousFreeMemoryBlock(region->start);
+                free_region.start = prev_free_block;
+                insertion_it = EraseFreeMemoryBlock(head, prev_free_block);
+            }
+
+            /* Ensure region is big enough for a block. */
+            /* NOTE: Blocks allocated in other modes may be too small to hold a footer once freed. We still make a block of them, so that no memory is left unowned; */
+            /* it just can't be found from the block after it. */
+            if (GetPointerDifference(free_region.start, free_region.end) < sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
+                return false;
+            }
+
+            /* Fill the memory with a pattern, for debug. */
+            FillFreedMemory(heap, free_region.start, GetPointerDifference(free_region.start, free_region.end));
+
+            /* Insert the new memory block. */
+            InsertFreeMemoryBlock(head, insertion_it, InitializeFreeMemoryBlock(free_region));
+
+            return true;
+        }
+
+        bool CoalesceFreedRegion(ExpHeapHead *head, const MemoryRegion *region, bool is_previous_free) {
+            /* In segregated fit mode, we can find our neighbors without walking the free list. */
+            if (IsSegregatedFit(head)) {
+                return CoalesceFreedRegionWithBins(head, region, is_previous_free);
+            }
+
             auto prev_free_block_it = head->free_list.end();
             MemoryRegion free_region = *region;
 
@@ -207,7 +552,7 @@ namespace ams::lmem::impl {
                 /* Coalesce block after, if possible. */
                 if (cur_free_block == region->end) {
                     free_region.end = GetMemoryBlockEnd(cur_free_block);
-                    it = head->free_list.erase(it);
+                    it = EraseFreeMemoryBlock(head, cur_free_block);
 
                     /* Fill the memory with a pattern, for debug. */
                     FillUnallocatedMemory(GetHeapHead(head), cur_free_block, sizeof(ExpHeapMemoryBlockHead));
@@ -223,7 +568,7 @@ namespace ams::lmem::impl {
                 if (GetMemoryBlockEnd(std::addressof(*prev_free_block_it)) == region->start) {
                     /* We can coalesce, so do so. */
                     free_region.start = std::addressof(*prev_free_block_it);
-                    insertion_it = head->free_list.erase(prev_free_block_it);
+                    insertion_it = EraseFreeMemoryBlock(head, std::addressof(*prev_free_block_it));
                 } else {
                     /* We can't coalesce, so just select the next iterator. */
                     insertion_it = (++prev_free_block_it);
@@ -241,12 +586,73 @@ namespace ams::lmem::impl {
             FillFreedMemory(GetHeapHead(head), free_region.start, GetPointerDifference(free_region.start, free_region.end));
 
             /* Insert the new memory block. */
-            head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(free_region));
+            InsertFreeMemoryBlock(head, insertion_it, InitializeFreeMemoryBlock(free_region));
 
             return true;
         }
 
+        void *ConvertFreeBlockToUsedBlockWithBins(ExpHeapHead *head, ExpHeapMemoryBlockHead *block_head, void *block, size_t size, AllocationDirection direction) {
+            /* Calculate freed memory regions. */
+            MemoryRegion free_region_front;
+            GetMemoryBlockRegion(std::addressof(free_region_front), block_head);
+            MemoryRegion free_region_back{ .start = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) + size), .end = free_region_front.end, };
+
+            /* Adjust end of head region. */
+            free_region_front.end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) - sizeof(ExpHeapMemoryBlockHead));
+
+            /* Remove the old block. */
+            auto old_block_it = EraseFreeMemoryBlock(head, block_head);
+
+            /* If the front margins are big enough (and we're allowed to do so), make a new block. */
+            /* Otherwise, the margin becomes the used block's alignment padding. */
+            const bool has_front_block = !((GetPointerDifference(free_region_front.start, free_region_front.end) < sizeof(ExpHeapMemoryBlockHead) + FreeBlockFooterSize) ||
+                                           (direction == AllocationDirection_Front && !head->use_alignment_margins && GetPointerDifference(free_region_front.start, free_region_front.end) < MaximumPaddingalignment));
+            if (!has_front_block) {
+                free_region_front.end = free_region_front.start;
+            }
+
+            /* If the back margins are big enough (and we're allowed to do so), make a new block. */
+            /* Otherwise, give the margin to the used block, rather than leaving a hole that we couldn't find neighbors across. */
+            const bool has_back_block = !((GetPointerDifference(free_region_back.start, free_region_back.end) < sizeof(ExpHeapMemoryBlockHead) + FreeBlockFooterSize) ||
+                                          (direction == AllocationDirection_Back && !head->use_alignment_margins && GetPointerDifference(free_region_back.start, free_region_back.end) < MaximumPaddingalignment));
+            if (!has_back_block) {
+                free_region_back.start = free_region_back.end;
+            }
+
+            /* Fill the memory with a pattern, for debug. */
+            FillAllocatedMemory(GetHeapHead(head), free_region_front.end, GetPointerDifference(free_region_front.end, free_region_back.start));
+
+            {
+                /* Create the used block */
+                MemoryRegion used_region{ .start = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) - sizeof(ExpHeapMemoryBlockHead)), .end = free_region_back.start };
+
+                ExpHeapMemoryBlockHead *used_block = InitializeUsedMemoryBlock(used_region);
+
+                /* Insert it into the used list. */
+                head->used_list.push_back(*used_block);
+                SetMemoryBlockAllocationDirection(used_block, direction);
+                SetMemoryBlockAlignmentPadding(used_block, static_cast<u16>(GetPointerDifference(free_region_front.end, used_block)));
+                SetMemoryBlockGroupId(used_block, head->group_id);
+                WriteMemoryBlockPaddingMarker(used_block);
+            }
+
+            /* Make the new free blocks, now that the used block is there to be told about the one before it. */
+            if (has_front_block) {
+                InsertFreeMemoryBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_front));
+            }
+            if (has_back_block) {
+                InsertFreeMemoryBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_back));
+            }
+
+            return block;
+        }
+
         void *ConvertFreeBlockToUsedBlock(ExpHeapHead *head, ExpHeapMemoryBlockHead *block_head, void *block, size_t size, AllocationDirection direction) {
+            /* In segregated fit mode, margins must stay part of some block. */
+            if (IsSegregatedFit(head)) {
+                return ConvertFreeBlockToUsedBlockWithBins(head, block_head, block, size, direction);
+            }
+
             /* Calculate freed memory regions. */
             MemoryRegion free_region_front;
             GetMemoryBlockRegion(std::addressof(free_region_front), block_head);
@@ -365,6 +771,186 @@ namespace ams::lmem::impl {
             return ConvertFreeBlockToUsedBlock(exp_heap_head, found_block_head, found_block, size, AllocationDirection_Back);
         }
 
+        void *AllocateFromBins(HeapHead *heap, size_t size, s32 alignment, AllocationDirection direction) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Requests larger than the heap can never succeed. */
+            if (size > GetPointerDifference(heap->heap_start, heap->heap_end)) {
+                return nullptr;
+            }
+
+            /* Any block this large can satisfy the allocation, wherever its start falls relative to the alignment. */
+            const size_t required_size = size + (static_cast<size_t>(alignment) - MinimumAlignment);
+
+            /* Choose a block, preferring one from a bin whose blocks are all large enough. */
+            void *found_block = nullptr;
+            ExpHeapMemoryBlockHead *found_block_head = FindFreeBlockInBins(GetBinTable(heap), required_size);
+            if (found_block_head != nullptr) {
+                found_block = GetAllocationAddress(found_block_head, size, alignment, direction);
+                AMS_ASSERT(found_block != nullptr);
+            } else {
+                found_block_head = FindFittingFreeBlockInBins(GetBinTable(heap), std::addressof(found_block), size, required_size, alignment, direction);
+                if (found_block_head == nullptr) {
+                    return nullptr;
+                }
+            }
+
+            return ConvertFreeBlockToUsedBlock(exp_heap_head, found_block_head, found_block, size, direction);
+        }
+
+        bool GiveFreeBlockToUsedNeighbor(ExpHeapHead *head, ExpHeapMemoryBlockHead *block) {
+            const void *block_end = GetMemoryBlockEnd(block);
+
+            for (auto &used_block : head->used_list) {
+                /* Extend the used block before the free block, if there is one. */
+                if (GetMemoryBlockEnd(std::addressof(used_block)) == block) {
+                    used_block.block_size += GetPointerDifference(block, block_end);
+                    return true;
+                }
+
+                /* Otherwise, extend the alignment padding of the used block after it, if it can be represented. */
+                MemoryRegion used_region;
+                GetMemoryBlockRegion(std::addressof(used_region), std::addressof(used_block));
+                if (used_region.start == block_end) {
+                    const size_t padding = GetPointerDifference(block, std::addressof(used_block));
+                    if (padding <= 0x7F) {
+                        SetMemoryBlockAlignmentPadding(std::addressof(used_block), static_cast<u16>(padding));
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        void *GetNextMemoryBlockRegionStart(HeapHead *heap, void *address) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Find the first region at or after the address, which is the end of the heap if there are none. */
+            void *next = heap->heap_end;
+            for (auto &block : exp_heap_head->free_list) {
+                if (address <= std::addressof(block) && std::addressof(block) < next) {
+                    next = std::addressof(block);
+                }
+            }
+            for (auto &block : exp_heap_head->used_list) {
+                MemoryRegion region;
+                GetMemoryBlockRegion(std::addressof(region), std::addressof(block));
+                if (address <= region.start && region.start < next) {
+                    next = region.start;
+                }
+            }
+
+            return next;
+        }
+
+        void CloseMemoryBlockGaps(HeapHead *heap) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Other modes leave margins too small for a block unowned. Give each one to the block before it. */
+            /* NOTE: A margin at the start of the heap has no block before it, but also never needs to be found from one. */
+            for (auto &block : exp_heap_head->free_list) {
+                block.block_size = GetPointerDifference(GetMemoryBlockStart(std::addressof(block)), GetNextMemoryBlockRegionStart(heap, GetMemoryBlockEnd(std::addressof(block))));
+            }
+            for (auto &block : exp_heap_head->used_list) {
+                block.block_size = GetPointerDifference(GetMemoryBlockStart(std::addressof(block)), GetNextMemoryBlockRegionStart(heap, GetMemoryBlockEnd(std::addressof(block))));
+            }
+        }
+
+        bool EnableBins(HeapHead *heap) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Determine how large our bin table needs to be to bin a block spanning the whole heap. */
+            size_t first, second;
+            GetBinIndex(std::addressof(first), std::addressof(second), GetPointerDifference(heap->heap_start, heap->heap_end));
+            const size_t first_level_count = first + 1;
+            const size_t table_size        = GetBinTableSize(first_level_count);
+
+            /* The table is carved from the end of the last free block, which must end the heap. */
+            if (exp_heap_head->free_list.empty()) {
+                return false;
+            }
+
+            ExpHeapMemoryBlockHead *last_block = std::addressof(exp_heap_head->free_list.back());
+            if (GetNextMemoryBlockRegionStart(heap, GetMemoryBlockEnd(last_block)) != heap->heap_end || GetPointerDifference(GetMemoryBlockStart(last_block), heap->heap_end) < table_size + FreeBlockFooterSize) {
+                return false;
+            }
+
+            /* Make sure that every block is followed directly by the next one. */
+            CloseMemoryBlockGaps(heap);
+
+            last_block->block_size -= table_size;
+            heap->heap_end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap->heap_end) - table_size);
+
+            /* Initialize the table. */
+            ExpHeapBinTable *table = GetBinTable(heap);
+            std::memset(table, 0, table_size);
+            table->first_level_count = first_level_count;
+            table->table_size        = table_size;
+
+            /* Free blocks too small to hold a footer can't be found by the block after them when it's freed, and would never be coalesced. */
+            /* Give their memory to a neighboring used block instead, so that it's returned along with that block. */
+            for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); /* ... */) {
+                ExpHeapMemoryBlockHead *block = std::addressof(*it);
+                if (block->block_size < FreeBlockFooterSize && GiveFreeBlockToUsedNeighbor(exp_heap_head, block)) {
+                    it = EraseFreeMemoryBlock(exp_heap_head, block);
+                } else {
+                    ++it;
+                }
+            }
+
+            /* Mark where our used blocks' regions start, and forget anything left over from the last time we had bins. */
+            for (auto &block : exp_heap_head->used_list) {
+                SetPreviousMemoryBlockFree(std::addressof(block), false);
+                WriteMemoryBlockPaddingMarker(std::addressof(block));
+            }
+            for (auto &block : exp_heap_head->free_list) {
+                SetPreviousMemoryBlockFree(std::addressof(block), false);
+            }
+
+            /* Add all our free blocks to the bins. */
+            SetAllocationModeImpl(exp_heap_head, AllocationMode_SegregatedFit);
+            for (auto &block : exp_heap_head->free_list) {
+                WriteFreeBlockFooter(std::addressof(block));
+                InsertFreeBlockToBin(table, std::addressof(block));
+                SetNextMemoryBlockPreviousFree(heap, std::addressof(block), block.block_size >= FreeBlockFooterSize);
+            }
+
+            return true;
+        }
+
+        void DisableBins(HeapHead *heap, AllocationMode new_mode) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+            const size_t table_size = GetBinTable(heap)->table_size;
+
+            /* Other modes rely on the free list being in address order, which we don't maintain with bins. */
+            /* Blocks are almost always already in order, so an insertion sort from the back is cheap. */
+            {
+                ExpHeapMemoryBlockList sorted_list;
+                while (!exp_heap_head->free_list.empty()) {
+                    ExpHeapMemoryBlockHead &block = exp_heap_head->free_list.front();
+                    exp_heap_head->free_list.pop_front();
+
+                    auto it = sorted_list.end();
+                    while (it != sorted_list.begin() && std::addressof(*std::prev(it)) > std::addressof(block)) {
+                        --it;
+                    }
+                    sorted_list.insert(it, block);
+                }
+                exp_heap_head->free_list.splice(exp_heap_head->free_list.end(), sorted_list);
+            }
+
+            SetAllocationModeImpl(exp_heap_head, new_mode);
+
+            /* Return the table's memory to the heap. */
+            MemoryRegion region{ .start = heap->heap_end, .end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap->heap_end) + table_size) };
+            heap->heap_end = region.end;
+
+            const bool coalesced = CoalesceFreedRegion(exp_heap_head, std::addressof(region), false);
+            AMS_ASSERT(coalesced);
+            AMS_UNUSED(coalesced);
+        }
+
     }
 
     HeapHandle CreateExpHeap(void *address, size_t size, u32 option) {
@@ -390,27 +976,40 @@ namespace ams::lmem::impl {
         HeapHead *heap_head = handle;
         ExpHeapHead *exp_heap_head = GetExpHeapHead(heap_head);
 
-        /* If there's no free blocks, we can't do anything. */
-        if (exp_heap_head->free_list.empty()) {
-            return MakeMemoryRange(handle->heap_end, 0);
+        /* In segregated fit mode, our bin table lives past the end of the heap, and must move with it. */
+        const bool has_bins = IsSegregatedFit(exp_heap_head);
+        const size_t bin_table_size = has_bins ? GetBinTable(heap_head)->table_size : 0;
+        void * const heap_end = heap_head->heap_end;
+
+        /* Get the last memory block, make sure it really is the last block. */
+        /* NOTE: In segregated fit mode, the free list isn't kept in address order. */
+        ExpHeapMemoryBlockHead *block = nullptr;
+        if (has_bins) {
+            for (auto &it : exp_heap_head->free_list) {
+                if (GetMemoryBlockEnd(std::addressof(it)) == heap_end) {
+                    block = std::addressof(it);
+                    break;
+                }
+            }
+        } else if (!exp_heap_head->free_list.empty()) {
+            block = std::addressof(exp_heap_head->free_list.back());
         }
 
-        /* Get the memory block end, make sure it really is the last block. */
-        ExpHeapMemoryBlockHead *block = std::addressof(exp_heap_head->free_list.back());
-        void * const block_start = GetMemoryBlockStart(block);
-        const size_t block_size = block->block_size;
-        void * const block_end   = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block_start) + block_size);
-
-        if (block_end != handle->heap_end) {
-            return MakeMemoryRange(handle->heap_end, 0);
+        /* If there's no free block at the end of the heap, we can't do anything. */
+        if (block == nullptr || GetMemoryBlockEnd(block) != heap_end) {
+            return MakeMemoryRange(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_end) + bin_table_size), 0);
         }
 
         /* Remove the memory block. */
-        exp_heap_head->free_list.pop_back();
+        const size_t freed_size = block->block_size + sizeof(ExpHeapMemoryBlockHead);
+        EraseFreeMemoryBlock(exp_heap_head, block);
+
+        heap_head->heap_end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_end) - freed_size);
+        if (has_bins) {
+            std::memmove(heap_head->heap_end, heap_end, bin_table_size);
+        }
 
-        const size_t freed_size = block_size + sizeof(ExpHeapMemoryBlockHead);
-        heap_head->heap_end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_head->heap_end) - freed_size);
-        return MakeMemoryRange(heap_head->heap_end, freed_size);
+        return MakeMemoryRange(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_head->heap_end) + bin_table_size), freed_size);
     }
 
     void *AllocateFromExpHeap(HeapHandle handle, size_t size, s32 alignment) {
@@ -435,6 +1034,17 @@ namespace ams::lmem::impl {
         }
         size = util::AlignUp(size, MinimumAlignment);
 
+        /* In segregated fit mode, blocks must be able to hold a footer once freed. */
+        if (IsSegregatedFit(GetExpHeapHead(handle))) {
+            size = std::max(size, FreeBlockFooterSize);
+
+            if (alignment >= 0) {
+                return AllocateFromBins(handle, size, alignment, AllocationDirection_Front);
+            } else {
+                return AllocateFromBins(handle, size, -alignment, AllocationDirection_Back);
+            }
+        }
+
         /* Allocate a memory block. */
         void *allocated_memory = nullptr;
         if (alignment >= 0) {
@@ -464,7 +1074,7 @@ namespace ams::lmem::impl {
         exp_heap_head->used_list.erase(exp_heap_head->used_list.iterator_to(*block));
 
         /* Coalesce with adjacent blocks. */
-        const bool coalesced = CoalesceFreedRegion(exp_heap_head, std::addressof(region));
+        const bool coalesced = CoalesceFreedRegion(exp_heap_head, std::addressof(region), IsPreviousMemoryBlockFree(block));
         AMS_ASSERT(coalesced);
         AMS_UNUSED(coalesced);
     }
@@ -480,6 +1090,9 @@ namespace ams::lmem::impl {
 
         /* It's possible that there's no actual resizing being done. */
         size = util::AlignUp(size, MinimumAlignment);
+        if (IsSegregatedFit(exp_heap_head)) {
+            size = std::max(size, FreeBlockFooterSize);
+        }
         if (size == original_block_size) {
             return size;
         }
@@ -492,10 +1105,14 @@ namespace ams::lmem::impl {
             void * const cur_block_end = GetMemoryBlockEnd(block_head);
             ExpHeapMemoryBlockHead *next_block_head = nullptr;
 
-            for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); it++) {
-                if (std::addressof(*it) == cur_block_end) {
-                    next_block_head = std::addressof(*it);
-                    break;
+            if (IsSegregatedFit(exp_heap_head)) {
+                next_block_head = FindFreeBlockStartingAt(handle, cur_block_end);
+            } else {
+                for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); it++) {
+                    if (std::addressof(*it) == cur_block_end) {
+                        next_block_head = std::addressof(*it);
+                        break;
+                    }
                 }
             }
 
@@ -511,7 +1128,8 @@ namespace ams::lmem::impl {
                 GetMemoryBlockRegion(std::addressof(new_free_region), next_block_head);
 
                 /* Remove the next block from the free list. */
-                auto insertion_it = exp_heap_head->free_list.erase(exp_heap_head->free_list.iterator_to(*next_block_head));
+                auto insertion_it = EraseFreeMemoryBlock(exp_heap_head, next_block_head);
+                const size_t min_free_block_size = GetMinimumFreeBlockSize(exp_heap_head);
 
                 /* Figure out the new block extents. */
                 void *old_start = new_free_region.start;
@@ -520,14 +1138,14 @@ namespace ams::lmem::impl {
                 /* Only maintain the new free region as a memory block candidate if it can hold a header. */
                 /* NOTE: Nintendo does not check against minimum block size here, only header size. */
                 /* We will check against minimum block size, to avoid the creation of zero-size blocks. */
-                if (GetPointerDifference(new_free_region.start, new_free_region.end) < sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
+                if (GetPointerDifference(new_free_region.start, new_free_region.end) < sizeof(ExpHeapMemoryBlockHead) + min_free_block_size) {
                     new_free_region.start = new_free_region.end;
                 }
 
                 /* Adjust block sizes. */
                 block_head->block_size = GetPointerDifference(mem_block, new_free_region.start);
-                if (GetPointerDifference(new_free_region.start, new_free_region.end) >= sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
-                    exp_heap_head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(new_free_region));
+                if (GetPointerDifference(new_free_region.start, new_free_region.end) >= sizeof(ExpHeapMemoryBlockHead) + min_free_block_size) {
+                    InsertFreeMemoryBlock(exp_heap_head, insertion_it, InitializeFreeMemoryBlock(new_free_region));
                 }
 
                 /* Fill the memory with a pattern, for debug. */
@@ -537,9 +1155,14 @@ namespace ams::lmem::impl {
             /* We're shrinking the block. Nice and easy. */
             MemoryRegion new_free_region{ .start = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(mem_block)+ size), .end = GetMemoryBlockEnd(block_head) };
 
+            /* In segregated fit mode, don't leave behind a free block too small to be found from the block after it. */
+            if (IsSegregatedFit(exp_heap_head) && GetPointerDifference(new_free_region.start, new_free_region.end) < sizeof(ExpHeapMemoryBlockHead) + FreeBlockFooterSize && FindFreeBlockStartingAt(handle, new_free_region.end) == nullptr) {
+                return original_block_size;
+            }
+
             /* Try to free the new memory. */
             block_head->block_size = size;
-            if (!CoalesceFreedRegion(exp_heap_head, std::addressof(new_free_region))) {
+            if (!CoalesceFreedRegion(exp_heap_head, std::addressof(new_free_region), false)) {
                 /* We didn't shrink the block successfully, so restore the size. */
                 block_head->block_size = original_block_size;
             }
@@ -596,7 +1219,17 @@ namespace ams::lmem::impl {
 
         ExpHeapHead *exp_heap_head = GetExpHeapHead(handle);
         const AllocationMode old_mode = GetAllocationModeImpl(exp_heap_head);
-        SetAllocationModeImpl(exp_heap_head, new_mode);
+
+        /* Entering or leaving segregated fit mode requires building or releasing our bins. */
+        /* NOTE: If there's no room for the bins at the end of the heap, the mode is left unchanged. */
+        if (old_mode != AllocationMode_SegregatedFit && new_mode == AllocationMode_SegregatedFit) {
+            EnableBins(handle);
+        } else if (old_mode == AllocationMode_SegregatedFit && new_mode != AllocationMode_SegregatedFit) {
+            DisableBins(handle, new_mode);
+        } else {
+            SetAllocationModeImpl(exp_heap_head, new_mode);
+        }
+
         return old_mode;
     }
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::ncm {
+
+    /* Sorted in-memory index of the content ids present in a content storage. */
+    /* If we ever fail to allocate memory for it, the index is invalidated, and callers fall back to traversing the filesystem. */
+    /* The failure is remembered until the content storage next changes, so that we don't retry the build on every call. */
+    class ContentIdIndex {
+        NON_COPYABLE(ContentIdIndex);
+        NON_MOVEABLE(ContentIdIndex);
+        private:
+            static constexpr size_t InitialCapacity = 0x100;
+        private:
+            std::unique_ptr<ContentId[]> m_ids;
+            size_t m_count;
+            size_t m_capacity;
+            bool m_is_built;
+            bool m_is_allocation_failed;
+        public:
+            ContentIdIndex() : m_ids(), m_count(0), m_capacity(0), m_is_built(false), m_is_allocation_failed(false) { /* ... */ }
+
+            bool IsBuilt() const { return m_is_built; }
+            bool IsAllocationFailed() const { return m_is_allocation_failed; }
+
+            void Invalidate() {
+                m_ids.reset();
+                m_count                = 0;
+                m_capacity             = 0;
+                m_is_built             = false;
+                m_is_allocation_failed = false;
+            }
+
+            bool Append(const ContentId &content_id) {
+                AMS_ASSERT(!m_is_built);
+
+                if (!this->Reserve(m_count + 1)) {
+                    this->InvalidateForAllocationFailure();
+                    return false;
+                }
+
+                m_ids[m_count++] = content_id;
+                return true;
+            }
+
+            void FinishBuild() {
+                std::sort(m_ids.get(), m_ids.get() + m_count, Less);
+                m_is_built = true;
+            }
+
+            void Insert(const ContentId &content_id) {
+                /* If the index isn't built, there's nothing to update, but we may try to build it again. */
+                if (!m_is_built) {
+                    m_is_allocation_failed = false;
+                    return;
+                }
+
+                /* Find where the content id belongs. */
+                ContentId *it = this->LowerBound(content_id);
+                if (it != this->end() && *it == content_id) {
+                    return;
+                }
+
+                /* Make space for the content id. If we can't, we'll need to rebuild later. */
+                const size_t index = it - this->begin();
+                if (!this->Reserve(m_count + 1)) {
+                    this->InvalidateForAllocationFailure();
+                    return;
+                }
+
+                /* Insert the content id. */
+                std::memmove(m_ids.get() + index + 1, m_ids.get() + index, (m_count - index) * sizeof(ContentId));
+                m_ids[index] = content_id;
+                ++m_count;
+            }
+
+            void Erase(const ContentId &content_id) {
+                /* If the index isn't built, there's nothing to update, but we may try to build it again. */
+                if (!m_is_built) {
+                    m_is_allocation_failed = false;
+                    return;
+                }
+
+                /* Remove the content id, if present. */
+                if (ContentId *it = this->LowerBound(content_id); it != this->end() && *it == content_id) {
+                    std::memmove(it, it + 1, (this->end() - (it + 1)) * sizeof(ContentId));
+                    --m_count;
+                }
+            }
+
+            s32 GetCount() const {
+                AMS_ASSERT(m_is_built);
+                return static_cast<s32>(m_count);
+            }
+
+            s32 List(ContentId *out, size_t max_count, s32 offset) const {
+                AMS_ASSERT(m_is_built);
+                AMS_ASSERT(offset >= 0);
+
+                if (static_cast<size_t>(offset) >= m_count) {
+                    return 0;
+                }
+
+                const size_t count = std::min(max_count, m_count - offset);
+                std::memcpy(out, m_ids.get() + offset, count * sizeof(ContentId));
+                return static_cast<s32>(count);
+            }
+        private:
+            static bool Less(const ContentId &lhs, const ContentId &rhs) {
+                return std::memcmp(std::addressof(lhs), std::addressof(rhs), sizeof(ContentId)) < 0;
+            }
+
+            void InvalidateForAllocationFailure() {
+                this->Invalidate();
+                m_is_allocation_failed = true;
+            }
+
+            ContentId *begin() { return m_ids.get(); }
+            ContentId *end() { return m_ids.get() + m_count; }
+
+            ContentId *LowerBound(const ContentId &content_id) {
+                return std::lower_bound(this->begin(), this->end(), content_id, Less);
+            }
+
+            bool Reserve(size_t count) {
+                /* If we have enough space, we're done. */
+                if (count <= m_capacity) {
+                    return true;
+                }
+
+                /* Allocate a larger array. */
+                const size_t new_capacity = std::max(InitialCapacity, m_capacity * 2);
+                std::unique_ptr<ContentId[]> new_ids(new (std::nothrow) ContentId[new_capacity]);
+                if (new_ids == nullptr) {
+                    return false;
+                }
+
+                /* Move our content ids over. */
+                if (m_count > 0) {
+                    std::memcpy(new_ids.get(), m_ids.get(), m_count * sizeof(ContentId));
+                }
+
+                m_ids      = std::move(new_ids);
+                m_capacity = new_capacity;
+                return true;
+            }
+    };
+
+}
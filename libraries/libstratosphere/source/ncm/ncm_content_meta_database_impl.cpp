@@ -49,9 +49,59 @@ namespace ams::ncm {
         R_SUCCEED();
     }
 
+    void ContentMetaDatabaseImpl::EnsureContentMetaIndex() {
+        /* If our index is already built, or we couldn't build it since the database last changed, we're done. */
+        if (m_content_meta_index.IsBuilt() || m_content_meta_index.IsBuildFailed()) {
+            return;
+        }
+
+        /* Count the entries we'll need, so that the index is allocated exactly once. */
+        size_t content_count = 0;
+        for (const auto &entry : *m_kvs) {
+            content_count += ContentMetaReader(entry.GetValuePointer(), entry.GetValueSize()).GetContentCount();
+        }
+
+        /* If the index would be too large, or we can't allocate it, callers scan the key-value store. */
+        if (!m_content_meta_index.BeginBuild(content_count, m_kvs->GetCount())) {
+            return;
+        }
+
+        /* Add all entries to the index. */
+        for (auto &entry : *m_kvs) {
+            if (!m_content_meta_index.Append(entry.GetKey(), entry.GetValuePointer(), entry.GetValueSize())) {
+                return;
+            }
+        }
+
+        m_content_meta_index.FinishBuild();
+    }
+
+    void ContentMetaDatabaseImpl::EraseFromContentMetaIndex(const ContentMetaKey &key) {
+        /* If our index isn't built, there's nothing to update. */
+        if (!m_content_meta_index.IsBuilt()) {
+            return;
+        }
+
+        /* Erase the entries for the key's current content meta, if it has one. */
+        const void *meta;
+        size_t meta_size;
+        if (R_SUCCEEDED(this->GetContentMetaPointer(&meta, &meta_size, key))) {
+            m_content_meta_index.Erase(key, meta, meta_size);
+        }
+    }
+
     Result ContentMetaDatabaseImpl::Set(const ContentMetaKey &key, const sf::InBuffer &value) {
         R_TRY(this->EnsureEnabled());
-        R_RETURN(m_kvs->Set(key, value.GetPointer(), value.GetSize()));
+
+        /* Any existing content meta for the key will be replaced, so remove it from our index. */
+        this->EraseFromContentMetaIndex(key);
+        ON_RESULT_FAILURE { m_content_meta_index.Invalidate(); };
+
+        R_TRY(m_kvs->Set(key, value.GetPointer(), value.GetSize()));
+
+        /* Add the new content meta to our index. */
+        m_content_meta_index.Insert(key, value.GetPointer(), value.GetSize());
+        R_SUCCEED();
     }
 
     Result ContentMetaDatabaseImpl::Get(sf::Out<u64> out_size, const ContentMetaKey &key, const sf::OutBuffer &out_value) {
@@ -70,6 +120,15 @@ namespace ams::ncm {
     Result ContentMetaDatabaseImpl::Remove(const ContentMetaKey &key) {
         R_TRY(this->EnsureEnabled());
 
+        /* Find the content meta. If there isn't any, neither the store nor our index change. */
+        const void *meta;
+        size_t meta_size;
+        R_TRY(this->GetContentMetaPointer(&meta, &meta_size, key));
+
+        /* Remove the content meta from our index. The store is only modified if removal succeeds, so restore the index otherwise. */
+        m_content_meta_index.Erase(key, meta, meta_size);
+        ON_RESULT_FAILURE { m_content_meta_index.Insert(key, meta, meta_size); };
+
         R_TRY_CATCH(m_kvs->Remove(key)) {
             R_CONVERT(kvdb::ResultKeyNotFound, ncm::ResultContentMetaNotFound())
         } R_END_TRY_CATCH;
@@ -109,12 +168,46 @@ namespace ams::ncm {
         size_t entries_total = 0;
         size_t entries_written = 0;
 
+        auto IsMatch = [&](const ContentMetaKey &key) ALWAYS_INLINE_LAMBDA {
+            return (meta_type == ContentMetaType::Unknown || key.type == meta_type) && (min <= key.id && key.id <= max) && (install_type == ContentInstallType::Unknown || key.install_type == install_type);
+        };
+
+        auto WriteEntry = [&](const ContentMetaKey &key) ALWAYS_INLINE_LAMBDA {
+            if (entries_written < out_info.GetSize()) {
+                out_info[entries_written++] = key;
+            }
+            entries_total++;
+        };
+
+        /* If filtering by application id, use our index to find the keys for the application, along with those without an application id. */
+        if (application_id != InvalidApplicationId) {
+            this->EnsureContentMetaIndex();
+            if (m_content_meta_index.IsBuilt()) {
+                auto [app_it, app_end]     = m_content_meta_index.GetApplicationEntries(application_id);
+                auto [other_it, other_end] = m_content_meta_index.GetApplicationEntries(util::nullopt);
+
+                /* Both ranges are ordered by key, so merge them to output keys in the same order as the key-value store. */
+                while (app_it != app_end || other_it != other_end) {
+                    const bool use_app = other_it == other_end || (app_it != app_end && app_it->key < other_it->key);
+                    const ContentMetaKey &key = use_app ? (app_it++)->key : (other_it++)->key;
+
+                    if (IsMatch(key)) {
+                        WriteEntry(key);
+                    }
+                }
+
+                out_entries_total.SetValue(entries_total);
+                out_entries_written.SetValue(entries_written);
+                R_SUCCEED();
+            }
+        }
+
         /* Iterate over all entries. */
         for (auto &entry : *m_kvs) {
             const ContentMetaKey key = entry.GetKey();
 
             /* Check if this entry matches the given filters. */
-            if (!((meta_type == ContentMetaType::Unknown || key.type == meta_type) && (min <= key.id && key.id <= max) && (install_type == ContentInstallType::Unknown || key.install_type == install_type))) {
+            if (!IsMatch(key)) {
                 continue;
             }
 
@@ -135,10 +228,7 @@ namespace ams::ncm {
             }
 
             /* Write the entry to the output buffer. */
-            if (entries_written < out_info.GetSize()) {
-                out_info[entries_written++] = key;
-            }
-            entries_total++;
+            WriteEntry(key);
         }
 
         out_entries_total.SetValue(entries_total);
@@ -177,6 +267,28 @@ namespace ams::ncm {
         size_t entries_total = 0;
         size_t entries_written = 0;
 
+        /* If we have an index, use it to avoid parsing every content meta. */
+        this->EnsureContentMetaIndex();
+        if (m_content_meta_index.IsBuilt()) {
+            const auto [begin, end] = m_content_meta_index.GetAllApplicationEntries();
+            for (auto it = begin; it != end; ++it) {
+                /* Check if this entry matches the given filters. */
+                if (!(type == ContentMetaType::Unknown || it->key.type == type)) {
+                    continue;
+                }
+
+                /* Write the entry to the output buffer. */
+                if (entries_written < out_keys.GetSize()) {
+                    out_keys[entries_written++] = { it->key, it->application_id };
+                }
+                entries_total++;
+            }
+
+            out_entries_total.SetValue(entries_total);
+            out_entries_written.SetValue(entries_written);
+            R_SUCCEED();
+        }
+
         /* Iterate over all entries. */
         for (auto &entry : *m_kvs) {
             const ContentMetaKey key = entry.GetKey();
@@ -306,6 +418,7 @@ namespace ams::ncm {
 
     Result ContentMetaDatabaseImpl::DisableForcibly() {
         m_disabled = true;
+        m_content_meta_index.Invalidate();
         R_SUCCEED();
     }
 
@@ -318,6 +431,16 @@ namespace ams::ncm {
             out_orphaned[i] = true;
         }
 
+        /* If we have an index, look up each content id directly. */
+        this->EnsureContentMetaIndex();
+        if (m_content_meta_index.IsBuilt()) {
+            for (size_t i = 0; i < content_ids.GetSize(); i++) {
+                out_orphaned[i] = !m_content_meta_index.HasContent(content_ids[i]);
+            }
+
+            R_SUCCEED();
+        }
+
         auto IsOrphanedContent = [](const sf::InArray<ContentId> &list, const ncm::ContentId &id) ALWAYS_INLINE_LAMBDA -> util::optional<size_t> {
             /* Check if any input content ids match our found content id. */
             for (size_t i = 0; i < list.GetSize(); i++) {
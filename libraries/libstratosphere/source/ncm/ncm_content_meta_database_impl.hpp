@@ -16,15 +16,21 @@
 #pragma once
 #include <stratosphere.hpp>
 #include "ncm_content_meta_database_impl_base.hpp"
+#include "ncm_content_meta_index.hpp"
 
 namespace ams::ncm {
 
     class ContentMetaDatabaseImpl : public ContentMetaDatabaseImplBase {
+        private:
+            ContentMetaIndex m_content_meta_index;
         public:
-            ContentMetaDatabaseImpl(ContentMetaKeyValueStore *kvs, const char *mount_name) : ContentMetaDatabaseImplBase(kvs, mount_name) { /* ... */ }
-            ContentMetaDatabaseImpl(ContentMetaKeyValueStore *kvs) : ContentMetaDatabaseImplBase(kvs) { /* ... */ }
+            ContentMetaDatabaseImpl(ContentMetaKeyValueStore *kvs, const char *mount_name) : ContentMetaDatabaseImplBase(kvs, mount_name), m_content_meta_index() { /* ... */ }
+            ContentMetaDatabaseImpl(ContentMetaKeyValueStore *kvs) : ContentMetaDatabaseImplBase(kvs), m_content_meta_index() { /* ... */ }
         private:
             /* Helpers. */
+            void EnsureContentMetaIndex();
+            void EraseFromContentMetaIndex(const ContentMetaKey &key);
+
             Result GetContentInfoImpl(ContentInfo *out, const ContentMetaKey &key, ContentType type, util::optional<u8> id_offset) const;
 
             Result GetContentIdImpl(ContentId *out, const ContentMetaKey &key, ContentType type, util::optional<u8> id_offset) const {
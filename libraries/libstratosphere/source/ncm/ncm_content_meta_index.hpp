@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::ncm {
+
+    /* In-memory indices over the entries of a content meta database, mapping content ids to the keys that own them, and application ids to their keys. */
+    /* The indices are sized once when built, with a little headroom for insertions, and are rebuilt rather than grown if an insertion doesn't fit. */
+    /* If they would be too large or we fail to allocate memory for them, callers fall back to scanning the key-value store. */
+    /* That failure is remembered until the content meta database next changes, so that we don't retry the build on every call. */
+    class ContentMetaIndex {
+        NON_COPYABLE(ContentMetaIndex);
+        NON_MOVEABLE(ContentMetaIndex);
+        public:
+            struct ContentEntry {
+                ContentId content_id;
+                ContentMetaKey key;
+
+                bool operator<(const ContentEntry &rhs) const {
+                    if (const auto cmp = std::memcmp(std::addressof(this->content_id), std::addressof(rhs.content_id), sizeof(ContentId)); cmp != 0) {
+                        return cmp < 0;
+                    }
+                    return this->key < rhs.key;
+                }
+
+                bool operator==(const ContentEntry &rhs) const {
+                    return this->content_id == rhs.content_id && this->key == rhs.key;
+                }
+            };
+
+            /* Keys without an application id are kept in the index too, ordered before all keys which have one. */
+            struct ApplicationEntry {
+                ContentMetaKey key;
+                ApplicationId application_id;
+                bool has_application_id;
+
+                bool operator<(const ApplicationEntry &rhs) const {
+                    if (this->has_application_id != rhs.has_application_id) {
+                        return !this->has_application_id;
+                    }
+                    if (this->application_id != rhs.application_id) {
+                        return this->application_id.value < rhs.application_id.value;
+                    }
+                    return this->key < rhs.key;
+                }
+
+                bool operator==(const ApplicationEntry &rhs) const {
+                    return this->has_application_id == rhs.has_application_id && this->application_id == rhs.application_id && this->key == rhs.key;
+                }
+            };
+        private:
+            template<typename Entry>
+            class SortedArray {
+                NON_COPYABLE(SortedArray);
+                NON_MOVEABLE(SortedArray);
+                private:
+                    std::unique_ptr<Entry[]> m_entries;
+                    size_t m_count;
+                    size_t m_capacity;
+                public:
+                    SortedArray() : m_entries(), m_count(0), m_capacity(0) { /* ... */ }
+
+                    const Entry *begin() const { return m_entries.get(); }
+                    const Entry *end() const { return m_entries.get() + m_count; }
+
+                    const Entry *LowerBound(const Entry &entry) const {
+                        return std::lower_bound(this->begin(), this->end(), entry);
+                    }
+
+                    void Clear() {
+                        m_entries.reset();
+                        m_count    = 0;
+                        m_capacity = 0;
+                    }
+
+                    bool Allocate(size_t capacity) {
+                        AMS_ASSERT(m_entries == nullptr);
+
+                        if (capacity > 0) {
+                            m_entries.reset(new (std::nothrow) Entry[capacity]);
+                            if (m_entries == nullptr) {
+                                return false;
+                            }
+                        }
+
+                        m_capacity = capacity;
+                        return true;
+                    }
+
+                    bool Append(const Entry &entry) {
+                        if (m_count >= m_capacity) {
+                            return false;
+                        }
+
+                        m_entries[m_count++] = entry;
+                        return true;
+                    }
+
+                    void Sort() {
+                        std::sort(m_entries.get(), m_entries.get() + m_count);
+                    }
+
+                    bool Insert(const Entry &entry) {
+                        /* Find where the entry belongs. */
+                        const size_t index = this->LowerBound(entry) - this->begin();
+                        if (index < m_count && m_entries[index] == entry) {
+                            return true;
+                        }
+
+                        /* Make sure there's space for the entry. */
+                        if (m_count >= m_capacity) {
+                            return false;
+                        }
+
+                        /* Insert the entry. */
+                        std::memmove(m_entries.get() + index + 1, m_entries.get() + index, (m_count - index) * sizeof(Entry));
+                        m_entries[index] = entry;
+                        ++m_count;
+                        return true;
+                    }
+
+                    void Erase(const Entry &entry) {
+                        const size_t index = this->LowerBound(entry) - this->begin();
+                        if (index < m_count && m_entries[index] == entry) {
+                            std::memmove(m_entries.get() + index, m_entries.get() + index + 1, (m_count - (index + 1)) * sizeof(Entry));
+                            --m_count;
+                        }
+                    }
+            };
+        private:
+            /* NOTE: ncm's heap is small, and shared by all of its databases. */
+            static constexpr size_t MaxIndexSize = 128_KB;
+
+            static constexpr size_t ExtraContentEntryCount     = 0x20;
+            static constexpr size_t ExtraApplicationEntryCount = 0x8;
+        private:
+            SortedArray<ContentEntry> m_content_entries;
+            SortedArray<ApplicationEntry> m_application_entries;
+            bool m_is_built;
+            bool m_is_build_failed;
+        public:
+            ContentMetaIndex() : m_content_entries(), m_application_entries(), m_is_built(false), m_is_build_failed(false) { /* ... */ }
+
+            bool IsBuilt() const { return m_is_built; }
+            bool IsBuildFailed() const { return m_is_build_failed; }
+
+            void Invalidate() {
+                m_content_entries.Clear();
+                m_application_entries.Clear();
+                m_is_built        = false;
+                m_is_build_failed = false;
+            }
+
+            bool BeginBuild(size_t content_count, size_t application_count) {
+                AMS_ASSERT(!m_is_built);
+
+                /* Allocate as many entries as the database needs plus some headroom, if it isn't too large. */
+                content_count     += ExtraContentEntryCount;
+                application_count += ExtraApplicationEntryCount;
+                if (content_count * sizeof(ContentEntry) + application_count * sizeof(ApplicationEntry) > MaxIndexSize ||
+                    !m_content_entries.Allocate(content_count) || !m_application_entries.Allocate(application_count)) {
+                    this->Invalidate();
+                    m_is_build_failed = true;
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool Append(const ContentMetaKey &key, const void *meta, size_t meta_size) {
+                AMS_ASSERT(!m_is_built);
+
+                if (!this->Update(key, meta, meta_size, [](auto &array, const auto &entry) { return array.Append(entry); })) {
+                    this->Invalidate();
+                    return false;
+                }
+
+                return true;
+            }
+
+            void FinishBuild() {
+                m_content_entries.Sort();
+                m_application_entries.Sort();
+                m_is_built = true;
+            }
+
+            void Insert(const ContentMetaKey &key, const void *meta, size_t meta_size) {
+                /* If the index isn't built, there's nothing to update, but we may try to build it again. */
+                if (!m_is_built) {
+                    m_is_build_failed = false;
+                    return;
+                }
+
+                /* Insert the entries. If they don't fit, we'll rebuild at the new size later. */
+                if (!this->Update(key, meta, meta_size, [](auto &array, const auto &entry) { return array.Insert(entry); })) {
+                    this->Invalidate();
+                }
+            }
+
+            void Erase(const ContentMetaKey &key, const void *meta, size_t meta_size) {
+                /* If the index isn't built, there's nothing to update, but we may try to build it again. */
+                if (!m_is_built) {
+                    m_is_build_failed = false;
+                    return;
+                }
+
+                this->Update(key, meta, meta_size, [](auto &array, const auto &entry) { array.Erase(entry); return true; });
+            }
+
+            bool HasContent(const ContentId &content_id) const {
+                AMS_ASSERT(m_is_built);
+
+                /* Keys order after the zero key, so this finds the first entry for the content id. */
+                const auto it = m_content_entries.LowerBound(ContentEntry{ content_id, {} });
+                return it != m_content_entries.end() && it->content_id == content_id;
+            }
+
+            std::pair<const ApplicationEntry *, const ApplicationEntry *> GetApplicationEntries(util::optional<ApplicationId> application_id) const {
+                AMS_ASSERT(m_is_built);
+
+                /* Find the range of entries with the given application id, or without one. */
+                const ApplicationEntry first = { {}, application_id.value_or(ApplicationId{}), application_id.has_value() };
+                const auto begin = m_application_entries.LowerBound(first);
+
+                auto end = begin;
+                while (end != m_application_entries.end() && end->has_application_id == first.has_application_id && end->application_id == first.application_id) {
+                    ++end;
+                }
+
+                return { begin, end };
+            }
+
+            std::pair<const ApplicationEntry *, const ApplicationEntry *> GetAllApplicationEntries() const {
+                AMS_ASSERT(m_is_built);
+
+                /* Entries with application ids order after all those without one. */
+                return { m_application_entries.LowerBound(ApplicationEntry{ {}, ApplicationId{}, true }), m_application_entries.end() };
+            }
+        private:
+            static bool HasContentIdBefore(const ContentMetaReader &reader, size_t index, const ContentId &content_id) {
+                for (size_t i = 0; i < index; i++) {
+                    if (reader.GetContentInfo(i)->GetId() == content_id) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            template<typename F>
+            bool Update(const ContentMetaKey &key, const void *meta, size_t meta_size, F f) {
+                ContentMetaReader reader(meta, meta_size);
+
+                /* Update the content entries, once for each distinct content id. */
+                for (size_t i = 0; i < reader.GetContentCount(); i++) {
+                    const ContentId content_id = reader.GetContentInfo(i)->GetId();
+                    if (HasContentIdBefore(reader, i, content_id)) {
+                        continue;
+                    }
+
+                    if (!f(m_content_entries, ContentEntry{ content_id, key })) {
+                        return false;
+                    }
+                }
+
+                /* Update the application entry. */
+                const auto application_id = reader.GetApplicationId(key);
+                return f(m_application_entries, ApplicationEntry{ key, application_id.value_or(ApplicationId{}), application_id.has_value() });
+            }
+    };
+
+}
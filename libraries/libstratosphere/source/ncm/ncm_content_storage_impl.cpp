@@ -356,6 +356,41 @@ namespace ams::ncm {
         m_content_iterator = util::nullopt;
     }
 
+    Result ContentStorageImpl::EnsureContentIdIndex() {
+        /* If our index is already built, or we couldn't allocate it since the last change, we're done. */
+        R_SUCCEED_IF(m_content_id_index.IsBuilt() || m_content_id_index.IsAllocationFailed());
+
+        /* Obtain the content base directory path. */
+        PathString path;
+        MakeBaseContentDirectoryPath(std::addressof(path), m_root_path);
+
+        /* Traverse the content base directory, adding all content ids to the index. */
+        bool allocated = true;
+        ON_RESULT_FAILURE { m_content_id_index.Invalidate(); };
+        R_TRY(TraverseDirectory(path, GetHierarchicalContentDirectoryDepth(m_make_content_path_func), [&](bool *should_continue, bool *should_retry_dir_read, const char *current_path, const fs::DirectoryEntry &entry) -> Result {
+            AMS_UNUSED(current_path);
+
+            *should_continue = true;
+            *should_retry_dir_read = false;
+
+            if (entry.type == fs::DirectoryEntryType_File) {
+                if (auto content_id = GetContentIdFromString(entry.name, std::strlen(entry.name)); content_id.has_value()) {
+                    /* If we run out of memory, stop, and leave the index unbuilt. */
+                    allocated = m_content_id_index.Append(*content_id);
+                    *should_continue = allocated;
+                }
+            }
+
+            R_SUCCEED();
+        }));
+
+        if (allocated) {
+            m_content_id_index.FinishBuild();
+        }
+
+        R_SUCCEED();
+    }
+
     Result ContentStorageImpl::OpenContentIdFile(ContentId content_id) {
         /* If the file is the currently cached one, we've nothing to do. */
         R_SUCCEED_IF(m_cached_content_id == content_id);
@@ -446,13 +481,21 @@ namespace ams::ncm {
             R_CONVERT(fs::ResultPathAlreadyExists, ncm::ResultContentAlreadyExists())
         } R_END_TRY_CATCH;
 
+        /* Add the content to our index. */
+        m_content_id_index.Insert(content_id);
+
         R_SUCCEED();
     }
 
     Result ContentStorageImpl::Delete(ContentId content_id) {
         R_TRY(this->EnsureEnabled());
         this->InvalidateFileCache();
-        R_RETURN(DeleteContentFile(content_id, m_make_content_path_func, m_root_path));
+        R_TRY(DeleteContentFile(content_id, m_make_content_path_func, m_root_path));
+
+        /* Remove the content from our index. */
+        m_content_id_index.Erase(content_id);
+
+        R_SUCCEED();
     }
 
     Result ContentStorageImpl::Has(sf::Out<bool> out, ContentId content_id) {
@@ -552,6 +595,13 @@ namespace ams::ncm {
     Result ContentStorageImpl::GetContentCount(sf::Out<s32> out_count) {
         R_TRY(this->EnsureEnabled());
 
+        /* If we can, use our index. */
+        R_TRY(this->EnsureContentIdIndex());
+        if (m_content_id_index.IsBuilt()) {
+            out_count.SetValue(m_content_id_index.GetCount());
+            R_SUCCEED();
+        }
+
         /* Obtain the content base directory path. */
         PathString path;
         MakeBaseContentDirectoryPath(std::addressof(path), m_root_path);
@@ -582,6 +632,13 @@ namespace ams::ncm {
         R_UNLESS(offset >= 0, ncm::ResultInvalidOffset());
         R_TRY(this->EnsureEnabled());
 
+        /* If we can, use our index. */
+        R_TRY(this->EnsureContentIdIndex());
+        if (m_content_id_index.IsBuilt()) {
+            out_count.SetValue(m_content_id_index.List(out.GetPointer(), out.GetSize(), offset));
+            R_SUCCEED();
+        }
+
         if (!m_content_iterator.has_value() || !m_last_content_offset.has_value() || m_last_content_offset != offset) {
             /* Create and initialize the content cache. */
             m_content_iterator.emplace();
@@ -658,6 +715,7 @@ namespace ams::ncm {
         m_disabled = true;
         this->InvalidateFileCache();
         m_placeholder_accessor.InvalidateAll();
+        m_content_id_index.Invalidate();
         R_SUCCEED();
     }
 
@@ -687,6 +745,9 @@ namespace ams::ncm {
             R_CONVERT(fs::ResultPathAlreadyExists, ncm::ResultContentAlreadyExists())
         } R_END_TRY_CATCH;
 
+        /* The old content is no longer present. */
+        m_content_id_index.Erase(old_content_id);
+
         R_SUCCEED();
     }
 
@@ -18,6 +18,7 @@
 
 #include "ncm_content_storage_impl_base.hpp"
 #include "ncm_placeholder_accessor.hpp"
+#include "ncm_content_id_index.hpp"
 
 namespace ams::ncm {
 
@@ -56,6 +57,7 @@ namespace ams::ncm {
             RightsIdCache *m_rights_id_cache;
             util::optional<ContentIterator> m_content_iterator;
             util::optional<s32> m_last_content_offset;
+            ContentIdIndex m_content_id_index;
         public:
             static Result InitializeBase(const char *root_path);
             static Result CleanupBase(const char *root_path);
@@ -69,6 +71,7 @@ namespace ams::ncm {
             /* Helpers. */
             Result OpenContentIdFile(ContentId content_id);
             void InvalidateFileCache();
+            Result EnsureContentIdIndex();
         public:
             /* Actual commands. */
             virtual Result GeneratePlaceHolderId(sf::Out<PlaceHolderId> out) override;
@@ -535,6 +535,13 @@ namespace ams::ncm {
     }
 
     Result InstallTaskBase::WritePlaceHolderBuffer(InstallContentInfo *content_info, const void *data, size_t data_size) {
+        /* Write the data, and then update the hash for it. */
+        R_TRY(this->WritePlaceHolderData(content_info, data, data_size));
+        this->UpdatePlaceHolderHash(data, data_size);
+        R_SUCCEED();
+    }
+
+    Result InstallTaskBase::WritePlaceHolderData(InstallContentInfo *content_info, const void *data, size_t data_size) {
         R_UNLESS(!this->IsCancelRequested(), ncm::ResultWritePlaceHolderCancelled());
 
         /* Open the content storage for the content info. */
@@ -551,9 +558,12 @@ namespace ams::ncm {
             this->UpdateThroughputMeasurement(data_size);
         }
 
+        R_SUCCEED();
+    }
+
+    void InstallTaskBase::UpdatePlaceHolderHash(const void *data, size_t data_size) {
         /* Update the hash for the new data. */
         m_sha256_generator.Update(data, data_size);
-        R_SUCCEED();
     }
 
     Result InstallTaskBase::WritePlaceHolder(const ContentMetaKey &key, InstallContentInfo *content_info) {
@@ -41,6 +41,15 @@ namespace ams::ncm {
         R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read));
         ON_SCOPE_EXIT { fs::CloseFile(file); };
 
+        /* Pipeline the write, if our buffer is large enough to be split. */
+        if (m_buffer_size >= PipelineBufferCount * PipelineBufferSizeMin) {
+            R_RETURN(this->WritePlaceHolderPipelined(file, content_info));
+        } else {
+            R_RETURN(this->WritePlaceHolderSequentially(file, content_info));
+        }
+    }
+
+    Result PackageInstallTaskBase::WritePlaceHolderSequentially(fs::FileHandle file, InstallContentInfo *content_info) {
         /* Continuously write the file to the placeholder until there is nothing left to write. */
         while (true) {
             /* Read as much of the remainder of the file as possible. */
@@ -59,6 +68,178 @@ namespace ams::ncm {
         R_SUCCEED();
     }
 
+    Result PackageInstallTaskBase::WritePlaceHolderPipelined(fs::FileHandle file, InstallContentInfo *content_info) {
+        /* Reset the pipeline. */
+        m_pipeline_content_info   = content_info;
+        m_pipeline_buffer_size    = util::AlignDown(m_buffer_size / PipelineBufferCount, os::MemoryPageSize);
+        m_pipeline_read_count     = 0;
+        m_pipeline_written_count  = 0;
+        m_pipeline_hashed_count   = 0;
+        m_pipeline_read_finished  = false;
+        m_pipeline_write_finished = false;
+        m_pipeline_result         = ResultSuccess();
+
+        /* Allocate stacks for the write and hash threads. If we can't, write sequentially. */
+        std::unique_ptr<u8[]> stack_memory(new (std::nothrow) u8[PipelineThreadStackMemorySize]);
+        if (stack_memory == nullptr) {
+            R_RETURN(this->WritePlaceHolderSequentially(file, content_info));
+        }
+
+        u8 * const write_thread_stack = reinterpret_cast<u8 *>(util::AlignUp(reinterpret_cast<uintptr_t>(stack_memory.get()), os::ThreadStackAlignment));
+        u8 * const hash_thread_stack  = write_thread_stack + PipelineThreadStackSize;
+
+        /* Create the write and hash threads, at our priority. If we can't, write sequentially. */
+        const s32 priority = os::GetThreadPriority(os::GetCurrentThread());
+        if (R_FAILED(os::CreateThread(std::addressof(m_write_thread), WriteThreadFunction, this, write_thread_stack, PipelineThreadStackSize, priority))) {
+            R_RETURN(this->WritePlaceHolderSequentially(file, content_info));
+        }
+        if (R_FAILED(os::CreateThread(std::addressof(m_hash_thread), HashThreadFunction, this, hash_thread_stack, PipelineThreadStackSize, priority))) {
+            os::DestroyThread(std::addressof(m_write_thread));
+            R_RETURN(this->WritePlaceHolderSequentially(file, content_info));
+        }
+
+        os::StartThread(std::addressof(m_write_thread));
+        os::StartThread(std::addressof(m_hash_thread));
+
+        /* Read the file into the pipeline until there is nothing left to read. */
+        s64 offset = content_info->written;
+        for (u64 index = 0; true; ++index) {
+            /* Wait for the buffer we want to read into to have been written and hashed. */
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                while (index >= m_pipeline_hashed_count + PipelineBufferCount && R_SUCCEEDED(m_pipeline_result)) {
+                    m_pipeline_cv.Wait(m_pipeline_mutex);
+                }
+
+                if (R_FAILED(m_pipeline_result)) {
+                    break;
+                }
+            }
+
+            /* Read as much of the remainder of the file as fits in the buffer. */
+            size_t size_read;
+            if (const Result result = fs::ReadFile(std::addressof(size_read), file, offset, this->GetPipelineBuffer(index), m_pipeline_buffer_size); R_FAILED(result)) {
+                this->SetPipelineResult(result);
+                break;
+            }
+
+            /* There is nothing left to read. */
+            if (size_read == 0) {
+                break;
+            }
+
+            /* Hand the buffer to the write thread. */
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                m_pipeline_data_sizes[index % PipelineBufferCount] = size_read;
+                m_pipeline_read_count = index + 1;
+                m_pipeline_cv.Broadcast();
+            }
+
+            offset += size_read;
+        }
+
+        /* Note that we're done reading. */
+        {
+            std::scoped_lock lk(m_pipeline_mutex);
+
+            m_pipeline_read_finished = true;
+            m_pipeline_cv.Broadcast();
+        }
+
+        /* Wait for the write and hash threads to drain the pipeline. */
+        os::WaitThread(std::addressof(m_write_thread));
+        os::WaitThread(std::addressof(m_hash_thread));
+        os::DestroyThread(std::addressof(m_write_thread));
+        os::DestroyThread(std::addressof(m_hash_thread));
+
+        R_RETURN(m_pipeline_result);
+    }
+
+    void PackageInstallTaskBase::SetPipelineResult(Result result) {
+        std::scoped_lock lk(m_pipeline_mutex);
+
+        /* Keep the first failure, and wake everyone so that they can stop. */
+        if (R_SUCCEEDED(m_pipeline_result)) {
+            m_pipeline_result = result;
+        }
+        m_pipeline_cv.Broadcast();
+    }
+
+    void PackageInstallTaskBase::WriteThreadBody() {
+        for (u64 index = 0; true; ++index) {
+            /* Wait for the buffer to be read. */
+            size_t size;
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                while (index >= m_pipeline_read_count && !m_pipeline_read_finished && R_SUCCEEDED(m_pipeline_result)) {
+                    m_pipeline_cv.Wait(m_pipeline_mutex);
+                }
+
+                if (R_FAILED(m_pipeline_result) || index >= m_pipeline_read_count) {
+                    break;
+                }
+
+                size = m_pipeline_data_sizes[index % PipelineBufferCount];
+            }
+
+            /* Write the buffer to the placeholder. */
+            if (const Result result = this->WritePlaceHolderData(m_pipeline_content_info, this->GetPipelineBuffer(index), size); R_FAILED(result)) {
+                this->SetPipelineResult(result);
+                break;
+            }
+
+            /* Hand the buffer to the hash thread. */
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                m_pipeline_written_count = index + 1;
+                m_pipeline_cv.Broadcast();
+            }
+        }
+
+        /* Note that we're done writing. */
+        std::scoped_lock lk(m_pipeline_mutex);
+
+        m_pipeline_write_finished = true;
+        m_pipeline_cv.Broadcast();
+    }
+
+    void PackageInstallTaskBase::HashThreadBody() {
+        /* We only hash data which has been written, even on failure, so that the saved hash context matches what was written. */
+        for (u64 index = 0; true; ++index) {
+            /* Wait for the buffer to be written. */
+            size_t size;
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                while (index >= m_pipeline_written_count && !m_pipeline_write_finished) {
+                    m_pipeline_cv.Wait(m_pipeline_mutex);
+                }
+
+                if (index >= m_pipeline_written_count) {
+                    break;
+                }
+
+                size = m_pipeline_data_sizes[index % PipelineBufferCount];
+            }
+
+            /* Hash the buffer. */
+            this->UpdatePlaceHolderHash(this->GetPipelineBuffer(index), size);
+
+            /* Release the buffer to be read into again. */
+            {
+                std::scoped_lock lk(m_pipeline_mutex);
+
+                m_pipeline_hashed_count = index + 1;
+                m_pipeline_cv.Broadcast();
+            }
+        }
+    }
+
     Result PackageInstallTaskBase::InstallTicket(const fs::RightsId &rights_id, ContentMetaType meta_type) {
         AMS_UNUSED(meta_type);
 
@@ -59,10 +59,26 @@ namespace ams::os::impl {
                 }
             }
             R_CATCH(svc::ResultReceiveListBroken) {
+                /* If we failed to reply, let our caller decide what to do with the session. */
+                if (index == -1) {
+                    *out_index = MultiWaitImpl::WaitInvalid;
+                    R_THROW(R_CURRENT_RESULT);
+                }
+
                 *out_index = index;
                 R_THROW(os::ResultReceiveListBroken());
             }
-        } R_END_TRY_CATCH_WITH_ABORT_UNLESS;
+            R_CATCH_ALL() {
+                /* Any other failure to receive is unexpected. */
+                if (index != -1) {
+                    R_ABORT_UNLESS(R_CURRENT_RESULT);
+                }
+
+                /* If we failed to reply, let our caller decide what to do with the session. */
+                *out_index = MultiWaitImpl::WaitInvalid;
+                R_THROW(R_CURRENT_RESULT);
+            }
+        } R_END_TRY_CATCH;
 
         *out_index = index;
         R_SUCCEED();
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::sf::cmif {
+
+    #if AMS_SF_COMMAND_STATISTICS_ENABLED
+
+    namespace {
+
+        constexpr inline size_t MaxCommandStatisticsEntries = 256;
+        static_assert(util::IsPowerOfTwo(MaxCommandStatisticsEntries));
+
+        constinit os::SdkMutex g_statistics_lock;
+        constinit CommandStatistics g_statistics[MaxCommandStatisticsEntries] = {};
+        constinit size_t g_statistics_count = 0;
+        constinit size_t g_dropped_count = 0;
+
+        constexpr ALWAYS_INLINE size_t GetStatisticsHash(u32 interface_id, u32 command_id) {
+            return static_cast<size_t>((interface_id ^ (command_id * 0x9E3779B1u)) & (MaxCommandStatisticsEntries - 1));
+        }
+
+        constexpr ALWAYS_INLINE size_t GetLatencyBucket(s64 ticks) {
+            const size_t width = ticks > 0 ? BITSIZEOF(u64) - util::CountLeadingZeros(static_cast<u64>(ticks)) : 0;
+            return std::min(width, CommandStatisticsLatencyBucketCount - 1);
+        }
+
+        CommandStatistics *FindStatistics(u32 interface_id, u32 command_id) {
+            /* Probe linearly from the hashed slot; entries are never removed individually. */
+            for (size_t i = 0, idx = GetStatisticsHash(interface_id, command_id); i < MaxCommandStatisticsEntries; ++i, idx = (idx + 1) & (MaxCommandStatisticsEntries - 1)) {
+                CommandStatistics &entry = g_statistics[idx];
+                if (entry.call_count == 0) {
+                    /* Claim the empty slot, as long as doing so leaves one free for lookups. */
+                    if (g_statistics_count >= MaxCommandStatisticsEntries - 1) {
+                        return nullptr;
+                    }
+
+                    entry = {};
+                    entry.interface_id = interface_id;
+                    entry.command_id   = command_id;
+                    ++g_statistics_count;
+                    return std::addressof(entry);
+                } else if (entry.interface_id == interface_id && entry.command_id == command_id) {
+                    return std::addressof(entry);
+                }
+            }
+
+            return nullptr;
+        }
+
+        size_t FormatStatisticsLine(char *dst, size_t dst_size, const CommandStatistics &entry) {
+            size_t len = std::max(util::TSNPrintf(dst, dst_size, "%08X %u %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRId64 " %" PRId64 " %" PRIu64 " %" PRIu64,
+                                                  entry.interface_id, entry.command_id, entry.call_count, entry.failure_count, entry.forwarded_count, entry.total_ticks, entry.max_ticks, entry.in_bytes, entry.out_bytes), 0);
+            for (size_t i = 0; i < CommandStatisticsLatencyBucketCount && len < dst_size; ++i) {
+                len += std::max(util::TSNPrintf(dst + len, dst_size - len, " %u", entry.latency_histogram[i]), 0);
+            }
+            if (len < dst_size) {
+                len += std::max(util::TSNPrintf(dst + len, dst_size - len, "\n"), 0);
+            }
+
+            return std::min(len, dst_size - 1);
+        }
+
+    }
+
+    void RecordCommandStatistics(u32 interface_id, u32 command_id, os::Tick elapsed, size_t in_bytes, size_t out_bytes, bool failed, bool forwarded) {
+        const s64 ticks = elapsed.GetInt64Value();
+
+        std::scoped_lock lk(g_statistics_lock);
+
+        CommandStatistics *entry = FindStatistics(interface_id, command_id);
+        if (entry == nullptr) {
+            ++g_dropped_count;
+            return;
+        }
+
+        entry->call_count      += 1;
+        entry->failure_count   += failed ? 1 : 0;
+        entry->forwarded_count += forwarded ? 1 : 0;
+        entry->total_ticks     += ticks;
+        entry->max_ticks        = std::max(entry->max_ticks, ticks);
+        entry->in_bytes        += in_bytes;
+        entry->out_bytes       += out_bytes;
+        entry->latency_histogram[GetLatencyBucket(ticks)] += 1;
+    }
+
+    size_t GetCommandStatistics(CommandStatistics *out, size_t max_count, size_t *out_dropped_count) {
+        std::scoped_lock lk(g_statistics_lock);
+
+        size_t count = 0;
+        for (size_t i = 0; i < MaxCommandStatisticsEntries && count < max_count; ++i) {
+            if (g_statistics[i].call_count != 0) {
+                out[count++] = g_statistics[i];
+            }
+        }
+
+        if (out_dropped_count != nullptr) {
+            *out_dropped_count = g_dropped_count;
+        }
+
+        return count;
+    }
+
+    void ClearCommandStatistics() {
+        std::scoped_lock lk(g_statistics_lock);
+
+        std::memset(g_statistics, 0, sizeof(g_statistics));
+        g_statistics_count = 0;
+        g_dropped_count    = 0;
+    }
+
+    Result DumpCommandStatistics(const char *path) {
+        /* Create the file if it doesn't exist, and truncate it otherwise. */
+        R_TRY_CATCH(fs::CreateFile(path, 0)) {
+            R_CATCH(fs::ResultPathAlreadyExists) { /* ... */ }
+        } R_END_TRY_CATCH;
+
+        fs::FileHandle file;
+        R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Write | fs::OpenMode_AllowAppend));
+        ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+        R_TRY(fs::SetFileSize(file, 0));
+
+        size_t dropped_count;
+        {
+            std::scoped_lock lk(g_statistics_lock);
+            dropped_count = g_dropped_count;
+        }
+
+        char line[0x200];
+        s64 offset = 0;
+
+        const size_t header_len = std::min<size_t>(std::max(util::TSNPrintf(line, sizeof(line), "# tick_frequency=%" PRId64 " dropped=%zu\n# interface_id command_id calls failures forwarded total_ticks max_ticks in_bytes out_bytes latency_histogram...\n", os::GetSystemTickFrequency(), dropped_count), 0), sizeof(line) - 1);
+        R_TRY(fs::WriteFile(file, offset, line, header_len, fs::WriteOption::None));
+        offset += header_len;
+
+        /* Copy out one entry at a time, so that we don't hold the lock across filesystem access. */
+        for (size_t i = 0; i < MaxCommandStatisticsEntries; ++i) {
+            CommandStatistics entry;
+            {
+                std::scoped_lock lk(g_statistics_lock);
+                entry = g_statistics[i];
+            }
+
+            if (entry.call_count == 0) {
+                continue;
+            }
+
+            const size_t line_len = FormatStatisticsLine(line, sizeof(line), entry);
+            R_TRY(fs::WriteFile(file, offset, line, line_len, fs::WriteOption::None));
+            offset += line_len;
+        }
+
+        R_RETURN(fs::FlushFile(file));
+    }
+
+    #else
+
+    void RecordCommandStatistics(u32 interface_id, u32 command_id, os::Tick elapsed, size_t in_bytes, size_t out_bytes, bool failed, bool forwarded) {
+        AMS_UNUSED(interface_id, command_id, elapsed, in_bytes, out_bytes, failed, forwarded);
+    }
+
+    size_t GetCommandStatistics(CommandStatistics *out, size_t max_count, size_t *out_dropped_count) {
+        AMS_UNUSED(out, max_count);
+
+        if (out_dropped_count != nullptr) {
+            *out_dropped_count = 0;
+        }
+
+        return 0;
+    }
+
+    void ClearCommandStatistics() {
+        /* ... */
+    }
+
+    Result DumpCommandStatistics(const char *path) {
+        AMS_UNUSED(path);
+        R_THROW(sf::ResultNotSupported());
+    }
+
+    #endif
+
+}
@@ -81,6 +81,52 @@ namespace ams::sf::cmif {
             }
         }
 
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        size_t GetInBytesForStatistics(const ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data) {
+            size_t size = in_raw_data.GetSize();
+            for (size_t i = 0; i < ctx.request.meta.num_send_statics; ++i) {
+                size += hipcGetStaticSize(ctx.request.data.send_statics + i);
+            }
+            for (size_t i = 0; i < ctx.request.meta.num_send_buffers; ++i) {
+                size += hipcGetBufferSize(ctx.request.data.send_buffers + i);
+            }
+            for (size_t i = 0; i < ctx.request.meta.num_exch_buffers; ++i) {
+                size += hipcGetBufferSize(ctx.request.data.exch_buffers + i);
+            }
+            return size;
+        }
+
+        size_t GetOutBytesForStatistics(const ServiceDispatchContext &ctx, bool has_response) {
+            /* Output buffers are counted at their full size, as we can't know how much the command wrote. */
+            size_t size = 0;
+            for (size_t i = 0; i < ctx.request.meta.num_recv_buffers; ++i) {
+                size += hipcGetBufferSize(ctx.request.data.recv_buffers + i);
+            }
+            for (size_t i = 0; i < ctx.request.meta.num_exch_buffers; ++i) {
+                size += hipcGetBufferSize(ctx.request.data.exch_buffers + i);
+            }
+
+            /* If the command produced a response, count its raw data and pointer buffers. */
+            if (has_response) {
+                const HipcResponse response = hipcParseResponse(ctx.out_message_buffer.GetPointer());
+                size += response.num_data_words * sizeof(u32);
+                for (size_t i = 0; i < response.num_statics; ++i) {
+                    size += hipcGetStaticSize(response.statics + i);
+                }
+            }
+            return size;
+        }
+
+        #if AMS_SF_MITM_SUPPORTED
+        Result ForwardRequestWithStatistics(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, u32 interface_id, u32 command_id, os::Tick start_tick) {
+            /* The forward session writes its own response, so only our output buffers are counted. */
+            const Result result = ctx.session->ForwardRequest(ctx);
+            RecordCommandStatistics(interface_id, command_id, os::GetSystemTick() - start_tick, GetInBytesForStatistics(ctx, in_raw_data), GetOutBytesForStatistics(ctx, false), R_FAILED(result), true);
+            R_RETURN(result);
+        }
+        #endif
+        #endif
+
     }
 
     Result impl::ServiceDispatchTableBase::ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count, u32 interface_id_for_debug) const {
@@ -100,14 +146,25 @@ namespace ams::sf::cmif {
         R_UNLESS(cmd_handler != nullptr, sf::cmif::ResultUnknownCommandId());
 
         /* Invoke handler. */
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        const auto start_tick = os::GetSystemTick();
+        #endif
         CmifOutHeader *out_header = nullptr;
         Result command_result = cmd_handler(&out_header, ctx, in_message_raw_data);
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        const auto elapsed_tick = os::GetSystemTick() - start_tick;
+        #endif
 
         /* Forward any meta-context change result. */
         if (sf::impl::ResultRequestContextChanged::Includes(command_result)) {
             R_RETURN(command_result);
         }
 
+        /* Record the command, now that we know it won't be retried. */
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        RecordCommandStatistics(interface_id_for_debug, cmd_id, elapsed_tick, GetInBytesForStatistics(ctx, in_message_raw_data), GetOutBytesForStatistics(ctx, out_header != nullptr), R_FAILED(command_result), false);
+        #endif
+
         /* Otherwise, ensure that we're able to write the output header. */
         if (out_header == nullptr) {
             AMS_ABORT_UNLESS(R_FAILED(command_result));
@@ -136,18 +193,33 @@ namespace ams::sf::cmif {
         /* Find a handler. */
         const auto cmd_handler = FindCommandHandler(entries, entry_count, cmd_id, hos_version);
 
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        const auto start_tick = os::GetSystemTick();
+        #endif
+
         /* If we didn't find a handler, forward the request. */
         if (cmd_handler == nullptr) {
+            #if AMS_SF_COMMAND_STATISTICS_ENABLED
+            R_RETURN(ForwardRequestWithStatistics(ctx, in_message_raw_data, interface_id_for_debug, cmd_id, start_tick));
+            #else
             R_RETURN(ctx.session->ForwardRequest(ctx));
+            #endif
         }
 
         /* Invoke handler. */
         CmifOutHeader *out_header = nullptr;
         Result command_result = cmd_handler(&out_header, ctx, in_message_raw_data);
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        const auto elapsed_tick = os::GetSystemTick() - start_tick;
+        #endif
 
         /* If we should, forward the request to the forward session. */
         if (sm::mitm::ResultShouldForwardToSession::Includes(command_result)) {
+            #if AMS_SF_COMMAND_STATISTICS_ENABLED
+            R_RETURN(ForwardRequestWithStatistics(ctx, in_message_raw_data, interface_id_for_debug, cmd_id, start_tick));
+            #else
             R_RETURN(ctx.session->ForwardRequest(ctx));
+            #endif
         }
 
         /* Forward any meta-context change result. */
@@ -155,6 +227,11 @@ namespace ams::sf::cmif {
             R_RETURN(command_result);
         }
 
+        /* Record the command, now that we know it won't be retried. */
+        #if AMS_SF_COMMAND_STATISTICS_ENABLED
+        RecordCommandStatistics(interface_id_for_debug, cmd_id, elapsed_tick, GetInBytesForStatistics(ctx, in_message_raw_data), GetOutBytesForStatistics(ctx, out_header != nullptr), R_FAILED(command_result), false);
+        #endif
+
         /* Otherwise, ensure that we're able to write the output header. */
         if (out_header == nullptr) {
             AMS_ABORT_UNLESS(R_FAILED(command_result));
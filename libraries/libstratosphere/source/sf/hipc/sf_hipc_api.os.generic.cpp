@@ -37,6 +37,10 @@ namespace ams::sf::hipc {
         AMS_ABORT("TODO: Generic ams::sf::hipc::Reply");
     }
 
+    Result SendSyncRequest(os::NativeHandle, const cmif::PointerAndSize &) {
+        AMS_ABORT("TODO: Generic ams::sf::hipc::SendSyncRequest");
+    }
+
     Result CreateSession(os::NativeHandle *, os::NativeHandle *) {
         AMS_ABORT("TODO: Generic ams::sf::hipc::CreateSession");
     }
@@ -84,6 +84,14 @@ namespace ams::sf::hipc {
         AMS_ABORT_UNLESS(false);
     }
 
+    Result SendSyncRequest(os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer) {
+        if (message_buffer.GetPointer() == hipc::GetMessageBufferOnTls()) {
+            R_RETURN(svc::SendSyncRequest(session_handle));
+        } else {
+            R_RETURN(svc::SendSyncRequestWithUserBuffer(message_buffer.GetAddress(), message_buffer.GetSize(), session_handle));
+        }
+    }
+
     Result CreateSession(os::NativeHandle *out_server_handle, os::NativeHandle *out_client_handle) {
         R_TRY_CATCH(svc::CreateSession(out_server_handle, out_client_handle, 0, 0)) {
             R_CONVERT(svc::ResultOutOfResource, sf::hipc::ResultOutOfSessions());
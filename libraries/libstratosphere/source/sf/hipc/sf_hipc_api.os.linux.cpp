@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+/* NOTE: Sessions are emulated with AF_UNIX seqpacket socket pairs. A message is sent as a single packet, */
+/* so message boundaries are preserved, and each end of the pair is a file descriptor which os::MultiWait can poll. */
+/* Closing one end of the pair wakes the other with POLLHUP, and subsequent receives observe end-of-file. */
+/* Each packet is a PacketHeader, the hipc message, and then the contents of each send static, packed in descriptor order. */
+/* The receiver lays the static contents out in its receive list, as the kernel would, and rewrites the descriptors to refer to them. */
+/* Copy/move handles are transferred as SCM_RIGHTS. Buffer descriptors are passed through untranslated, */
+/* so both ends of a session are expected to share an address space if buffers are used. */
+/* A packet with a non-zero result carries no message, and fails the request it answers with that result. */
+
+namespace ams::sf::hipc {
+
+    namespace {
+
+        constexpr size_t PointerTransferBufferAlignment = 0x10;
+
+        constexpr size_t MaxTransferHandleCount = 2 * ((1u << 4) - 1);
+        constexpr size_t MaxSendStaticCount     = (1u << 4) - 1;
+        constexpr size_t MaxReceiveListCount    = (1u << 4) - 3;
+
+        struct PacketHeader {
+            u32 message_size;
+            u32 static_size;
+            u32 result;
+            u32 reserved;
+        };
+        static_assert(sizeof(PacketHeader) == 0x10);
+
+        struct ReceiveList {
+            HipcRecvListEntry entries[MaxReceiveListCount];
+            size_t count;
+            bool is_single_buffer;
+        };
+
+        union ControlBuffer {
+            struct cmsghdr header;
+            u8 data[CMSG_SPACE(sizeof(s32) * MaxTransferHandleCount)];
+        };
+
+        alignas(PointerTransferBufferAlignment) constinit thread_local u8 g_tls_message_buffer[TlsMessageBufferSize];
+
+        size_t GetMessageSize(const HipcParsedRequest &request) {
+            size_t size = sizeof(HipcHeader);
+            if (request.meta.send_pid || request.meta.num_copy_handles || request.meta.num_move_handles) {
+                size += sizeof(HipcSpecialHeader);
+                size += request.meta.send_pid ? sizeof(u64) : 0;
+                size += sizeof(u32) * (request.meta.num_copy_handles + request.meta.num_move_handles);
+            }
+            size += sizeof(HipcStaticDescriptor) * request.meta.num_send_statics;
+            size += sizeof(HipcBufferDescriptor) * (request.meta.num_send_buffers + request.meta.num_recv_buffers + request.meta.num_exch_buffers);
+            size += sizeof(u32) * request.meta.num_data_words;
+            if (request.meta.num_recv_statics) {
+                size += sizeof(HipcRecvListEntry) * (request.meta.num_recv_statics != HIPC_AUTO_RECV_STATIC ? request.meta.num_recv_statics : 1);
+            }
+            return size;
+        }
+
+        void CloseReceivedHandles(const s32 *handles, size_t num_handles) {
+            for (size_t i = 0; i < num_handles; ++i) {
+                os::CloseNativeHandle(handles[i]);
+            }
+        }
+
+        void SaveReceiveList(ReceiveList *out, const void *message_buf, size_t message_buf_size) {
+            out->count            = 0;
+            out->is_single_buffer = false;
+
+            const auto prepared = hipcParseRequest(const_cast<void *>(message_buf));
+            if (prepared.meta.num_recv_statics == 0 || GetMessageSize(prepared) > message_buf_size) {
+                return;
+            }
+
+            out->is_single_buffer = prepared.meta.num_recv_statics == HIPC_AUTO_RECV_STATIC;
+            out->count            = out->is_single_buffer ? 1 : prepared.meta.num_recv_statics;
+            std::memcpy(out->entries, prepared.data.recv_list, sizeof(HipcRecvListEntry) * out->count);
+        }
+
+        Result GetStaticDestination(void **out, size_t *out_offset, const ReceiveList &recv_list, const HipcStaticDescriptor &desc, size_t size) {
+            /* Select the receive list entry which the static is to be received into. */
+            size_t entry_index = 0;
+            size_t offset      = 0;
+            if (recv_list.is_single_buffer) {
+                offset = util::AlignUp(*out_offset, PointerTransferBufferAlignment);
+            } else {
+                entry_index = desc.index;
+            }
+            R_UNLESS(entry_index < recv_list.count, svc::ResultReceiveListBroken());
+
+            /* Check that the static fits in the entry. */
+            const HipcRecvListEntry &entry = recv_list.entries[entry_index];
+            const uintptr_t address = static_cast<uintptr_t>(entry.address_low) | (static_cast<uintptr_t>(entry.address_high) << 32);
+            R_UNLESS(address != 0,                  svc::ResultReceiveListBroken());
+            R_UNLESS(offset + size <= entry.size,   svc::ResultReceiveListBroken());
+
+            *out        = reinterpret_cast<void *>(address + offset);
+            *out_offset = offset + size;
+            R_SUCCEED();
+        }
+
+        Result ReceiveImpl(bool *out_closed, os::NativeHandle session_handle, void *message_buf, size_t message_buf_size) {
+            /* Save the receive list the caller set up, since the received message will overwrite it. */
+            ReceiveList recv_list;
+            SaveReceiveList(std::addressof(recv_list), message_buf, message_buf_size);
+
+            /* Peek the packet's header and message, so that we can determine where its statics go. */
+            PacketHeader header = {};
+            struct iovec iov[2 + MaxSendStaticCount];
+            iov[0] = { .iov_base = std::addressof(header), .iov_len = sizeof(header) };
+            iov[1] = { .iov_base = message_buf,            .iov_len = message_buf_size };
+
+            struct msghdr msg = {};
+            msg.msg_iov    = iov;
+            msg.msg_iovlen = 2;
+
+            ssize_t res;
+            do {
+                res = ::recvmsg(session_handle, std::addressof(msg), MSG_PEEK);
+            } while (res < 0 && errno == EINTR);
+
+            /* An empty message or a reset connection means that the other end has been closed. */
+            if (res == 0 || (res < 0 && errno == ECONNRESET)) {
+                *out_closed = true;
+                R_SUCCEED();
+            }
+            AMS_ABORT_UNLESS(res > 0);
+
+            /* Lay out the packet. If it's malformed, we still have to consume it below. */
+            const size_t peeked = static_cast<size_t>(res);
+            void *static_dsts[MaxSendStaticCount] = {};
+            const Result layout_result = [&]() -> Result {
+                R_UNLESS(peeked >= sizeof(header), sf::hipc::ResultInvalidRequestSize());
+                R_UNLESS(header.result == 0,       result::impl::MakeResult(header.result));
+
+                R_UNLESS(header.message_size >= sizeof(HipcHeader),     sf::hipc::ResultInvalidRequestSize());
+                R_UNLESS(header.message_size <= message_buf_size,       svc::ResultMessageTooLarge());
+                R_UNLESS(peeked >= sizeof(header) + header.message_size, sf::hipc::ResultInvalidRequestSize());
+
+                const auto request = hipcParseRequest(message_buf);
+                R_UNLESS(GetMessageSize(request) <= header.message_size, sf::hipc::ResultInvalidRequestSize());
+
+                size_t recv_offset = 0;
+                size_t static_size = 0;
+                for (u32 i = 0; i < request.meta.num_send_statics; ++i) {
+                    const size_t size = hipcGetStaticSize(request.data.send_statics + i);
+                    if (size == 0) {
+                        continue;
+                    }
+
+                    R_TRY(GetStaticDestination(static_dsts + i, std::addressof(recv_offset), recv_list, request.data.send_statics[i], size));
+                    static_size += size;
+                }
+                R_UNLESS(static_size == header.static_size, sf::hipc::ResultInvalidRequestSize());
+
+                /* Receive the statics directly into their destinations. */
+                iov[1].iov_len = header.message_size;
+                msg.msg_iovlen = 2;
+                for (u32 i = 0; i < request.meta.num_send_statics; ++i) {
+                    if (static_dsts[i] != nullptr) {
+                        iov[msg.msg_iovlen++] = { .iov_base = static_dsts[i], .iov_len = hipcGetStaticSize(request.data.send_statics + i) };
+                    }
+                }
+
+                R_SUCCEED();
+            }();
+
+            /* Receive the packet. If we couldn't lay it out, only the header is received, and the rest is discarded. */
+            if (R_FAILED(layout_result)) {
+                msg.msg_iovlen = 1;
+            }
+
+            ControlBuffer control;
+            msg.msg_control    = control.data;
+            msg.msg_controllen = sizeof(control.data);
+            msg.msg_flags      = 0;
+
+            do {
+                res = ::recvmsg(session_handle, std::addressof(msg), MSG_CMSG_CLOEXEC);
+            } while (res < 0 && errno == EINTR);
+            AMS_ABORT_UNLESS(res > 0);
+
+            /* Gather any handles which were sent along with the message. */
+            s32 handles[MaxTransferHandleCount];
+            size_t num_handles = 0;
+            bool too_many_handles = false;
+            for (auto *cmsg = CMSG_FIRSTHDR(std::addressof(msg)); cmsg != nullptr; cmsg = CMSG_NXTHDR(std::addressof(msg), cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                    const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(s32);
+                    for (size_t i = 0; i < count; ++i) {
+                        s32 handle;
+                        std::memcpy(std::addressof(handle), CMSG_DATA(cmsg) + sizeof(s32) * i, sizeof(handle));
+                        if (num_handles < MaxTransferHandleCount) {
+                            handles[num_handles++] = handle;
+                        } else {
+                            os::CloseNativeHandle(handle);
+                            too_many_handles = true;
+                        }
+                    }
+                }
+            }
+            ON_RESULT_FAILURE { CloseReceivedHandles(handles, num_handles); };
+
+            R_TRY(layout_result);
+
+            /* Validate the message. */
+            const auto request = hipcParseRequest(message_buf);
+            R_UNLESS((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0,                                        sf::hipc::ResultInvalidRequestSize());
+            R_UNLESS(static_cast<size_t>(res) == sizeof(header) + header.message_size + header.static_size, sf::hipc::ResultInvalidRequestSize());
+            R_UNLESS(!too_many_handles,                                                                      sf::hipc::ResultInvalidRequestSize());
+            R_UNLESS(num_handles == request.meta.num_copy_handles + request.meta.num_move_handles,           sf::hipc::ResultInvalidRequestSize());
+
+            /* Translate the handle words to the descriptors we received, copy handles first. */
+            for (u32 i = 0; i < request.meta.num_copy_handles; ++i) {
+                request.data.copy_handles[i] = handles[i];
+            }
+            for (u32 i = 0; i < request.meta.num_move_handles; ++i) {
+                request.data.move_handles[i] = handles[request.meta.num_copy_handles + i];
+            }
+
+            /* Fill in the sender's process id. */
+            if (request.meta.send_pid) {
+                struct ucred cred;
+                socklen_t cred_size = sizeof(cred);
+                AMS_ABORT_UNLESS(::getsockopt(session_handle, SOL_SOCKET, SO_PEERCRED, std::addressof(cred), std::addressof(cred_size)) == 0);
+
+                const u64 pid = static_cast<u64>(cred.pid);
+                std::memcpy(static_cast<u8 *>(message_buf) + sizeof(HipcHeader) + sizeof(HipcSpecialHeader), std::addressof(pid), sizeof(pid));
+            }
+
+            /* Point the static descriptors at their received contents. */
+            for (u32 i = 0; i < request.meta.num_send_statics; ++i) {
+                HipcStaticDescriptor * const desc = request.data.send_statics + i;
+                *desc = hipcMakeSendStatic(static_dsts[i], hipcGetStaticSize(desc), desc->index);
+            }
+
+            *out_closed = false;
+            R_SUCCEED();
+        }
+
+        Result SendImpl(bool *out_closed, os::NativeHandle session_handle, void *message_buf, size_t message_buf_size) {
+            const auto request = hipcParseRequest(message_buf);
+
+            /* Move handles belong to the recipient once sent, and are released even if the message can't be delivered. */
+            ON_SCOPE_EXIT {
+                for (u32 i = 0; i < request.meta.num_move_handles; ++i) {
+                    os::CloseNativeHandle(request.data.move_handles[i]);
+                }
+            };
+
+            const size_t message_size = GetMessageSize(request);
+            R_UNLESS(message_size <= message_buf_size, sf::hipc::ResultInvalidRequestSize());
+
+            /* Prepare the packet. */
+            PacketHeader header = { .message_size = static_cast<u32>(message_size), .static_size = 0, .result = 0, .reserved = 0 };
+
+            struct iovec iov[2 + MaxSendStaticCount];
+            iov[0] = { .iov_base = std::addressof(header), .iov_len = sizeof(header) };
+            iov[1] = { .iov_base = message_buf,            .iov_len = message_size };
+
+            struct msghdr msg = {};
+            msg.msg_iov    = iov;
+            msg.msg_iovlen = 2;
+
+            for (u32 i = 0; i < request.meta.num_send_statics; ++i) {
+                const HipcStaticDescriptor * const desc = request.data.send_statics + i;
+                if (const size_t size = hipcGetStaticSize(desc); size > 0) {
+                    iov[msg.msg_iovlen++] = { .iov_base = hipcGetStaticAddress(desc), .iov_len = size };
+                    header.static_size += size;
+                }
+            }
+
+            ControlBuffer control;
+            if (const size_t num_handles = request.meta.num_copy_handles + request.meta.num_move_handles; num_handles > 0) {
+                msg.msg_control    = control.data;
+                msg.msg_controllen = CMSG_SPACE(sizeof(s32) * num_handles);
+
+                auto *cmsg = CMSG_FIRSTHDR(std::addressof(msg));
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type  = SCM_RIGHTS;
+                cmsg->cmsg_len   = CMSG_LEN(sizeof(s32) * num_handles);
+
+                u8 *dst = CMSG_DATA(cmsg);
+                std::memcpy(dst, request.data.copy_handles, sizeof(s32) * request.meta.num_copy_handles);
+                std::memcpy(dst + sizeof(s32) * request.meta.num_copy_handles, request.data.move_handles, sizeof(s32) * request.meta.num_move_handles);
+            }
+
+            /* Send the packet. */
+            ssize_t res;
+            do {
+                res = ::sendmsg(session_handle, std::addressof(msg), MSG_NOSIGNAL);
+            } while (res < 0 && errno == EINTR);
+
+            if (res < 0) {
+                /* A closed peer means there's no one left to receive the message. */
+                if (errno == EPIPE || errno == ECONNRESET) {
+                    *out_closed = true;
+                    R_SUCCEED();
+                }
+
+                R_UNLESS(errno != EMSGSIZE,                    sf::hipc::ResultInvalidRequestSize());
+                R_UNLESS(errno != ENOBUFS && errno != ENOMEM,  svc::ResultOutOfResource());
+                AMS_ABORT("Failed to send session message");
+            }
+            AMS_ABORT_UNLESS(static_cast<size_t>(res) == sizeof(header) + header.message_size + header.static_size);
+
+            *out_closed = false;
+            R_SUCCEED();
+        }
+
+        void SendResultImpl(os::NativeHandle session_handle, Result result) {
+            /* Fail the request being answered; if this can't be delivered, the sender will observe the session closing instead. */
+            PacketHeader header = { .message_size = 0, .static_size = 0, .result = result.GetValue(), .reserved = 0 };
+
+            ssize_t res;
+            do {
+                res = ::send(session_handle, std::addressof(header), sizeof(header), MSG_NOSIGNAL);
+            } while (res < 0 && errno == EINTR);
+        }
+
+    }
+
+    void *GetMessageBufferOnTls() {
+        return g_tls_message_buffer;
+    }
+
+    void AttachMultiWaitHolderForAccept(os::MultiWaitHolderType *holder, os::NativeHandle port) {
+        return os::InitializeMultiWaitHolder(holder, port);
+    }
+
+    void AttachMultiWaitHolderForReply(os::MultiWaitHolderType *holder, os::NativeHandle request) {
+        return os::InitializeMultiWaitHolder(holder, request);
+    }
+
+    Result Receive(ReceiveResult *out_recv_result, os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer) {
+        bool closed;
+        R_TRY_CATCH(ReceiveImpl(std::addressof(closed), session_handle, message_buffer.GetPointer(), message_buffer.GetSize())) {
+            R_CATCH_ALL() {
+                /* Any failure here was caused by what the client sent, so fail its request, as the kernel would, and wait for another. */
+                SendResultImpl(session_handle, R_CURRENT_RESULT);
+                *out_recv_result = ReceiveResult::NeedsRetry;
+                R_SUCCEED();
+            }
+        } R_END_TRY_CATCH;
+
+        *out_recv_result = closed ? ReceiveResult::Closed : ReceiveResult::Success;
+        R_SUCCEED();
+    }
+
+    Result Receive(bool *out_closed, os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer) {
+        R_TRY_CATCH(ReceiveImpl(out_closed, session_handle, message_buffer.GetPointer(), message_buffer.GetSize())) {
+            R_CATCH_ALL() {
+                SendResultImpl(session_handle, R_CURRENT_RESULT);
+                R_THROW(R_CURRENT_RESULT);
+            }
+        } R_END_TRY_CATCH;
+
+        R_SUCCEED();
+    }
+
+    Result Reply(os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer) {
+        /* A closed client end means there's no one left to reply to. */
+        bool closed;
+        R_RETURN(SendImpl(std::addressof(closed), session_handle, message_buffer.GetPointer(), message_buffer.GetSize()));
+    }
+
+    Result SendSyncRequest(os::NativeHandle session_handle, const cmif::PointerAndSize &message_buffer) {
+        /* NOTE: A session carries one request at a time, so concurrent requests on the same client handle must be serialized by the caller. */
+        void * const message_buf      = message_buffer.GetPointer();
+        const size_t message_buf_size = message_buffer.GetSize();
+
+        /* Send the request. */
+        bool closed;
+        R_TRY(SendImpl(std::addressof(closed), session_handle, message_buf, message_buf_size));
+        R_UNLESS(!closed, svc::ResultSessionClosed());
+
+        /* Receive the reply into the same buffer, using the request's receive list for any statics. */
+        R_TRY(ReceiveImpl(std::addressof(closed), session_handle, message_buf, message_buf_size));
+        R_UNLESS(!closed, svc::ResultSessionClosed());
+
+        R_SUCCEED();
+    }
+
+    Result CreateSession(os::NativeHandle *out_server_handle, os::NativeHandle *out_client_handle) {
+        s32 fds[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) {
+            R_UNLESS(errno != EMFILE && errno != ENFILE && errno != ENOMEM && errno != ENOBUFS, sf::hipc::ResultOutOfSessions());
+            AMS_ABORT("Failed to create session socket pair");
+        }
+
+        *out_server_handle = fds[0];
+        *out_client_handle = fds[1];
+        R_SUCCEED();
+    }
+
+}
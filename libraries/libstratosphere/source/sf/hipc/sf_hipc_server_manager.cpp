@@ -18,6 +18,44 @@
 
 namespace ams::sf::hipc {
 
+    namespace {
+
+        #if defined(ATMOSPHERE_OS_HORIZON)
+        constexpr inline bool IsReplyAndReceiveSupported = true;
+        #else
+        constexpr inline bool IsReplyAndReceiveSupported = false;
+        #endif
+
+        void MovePointerBufferData(const cmif::PointerAndSize &message, const cmif::PointerAndSize &src, const cmif::PointerAndSize &dst) {
+            /* If the request was received into its own session's pointer buffer, there's nothing to do. */
+            if (src.GetPointer() == dst.GetPointer()) {
+                return;
+            }
+
+            /* Move each static into the same position in the destination pointer buffer. */
+            const auto request = hipcParseRequest(message.GetPointer());
+            for (u32 i = 0; i < request.meta.num_send_statics; ++i) {
+                HipcStaticDescriptor * const desc = std::addressof(request.data.send_statics[i]);
+
+                const size_t size = hipcGetStaticSize(desc);
+                if (size == 0) {
+                    continue;
+                }
+
+                const uintptr_t address = reinterpret_cast<uintptr_t>(hipcGetStaticAddress(desc));
+                AMS_ABORT_UNLESS(src.GetAddress() <= address && address + size <= src.GetAddress() + src.GetSize());
+
+                const size_t offset = address - src.GetAddress();
+                AMS_ABORT_UNLESS(offset + size <= dst.GetSize());
+
+                void * const moved = reinterpret_cast<void *>(dst.GetAddress() + offset);
+                std::memcpy(moved, reinterpret_cast<const void *>(address), size);
+                *desc = hipcMakeSendStatic(moved, size, desc->index);
+            }
+        }
+
+    }
+
     #if AMS_SF_MITM_SUPPORTED
     Result ServerManagerBase::InstallMitmServerImpl(os::NativeHandle *out_port_handle, sm::ServiceName service_name, ServerManagerBase::MitmQueryFunction query_func) {
         /* Install the Mitm. */
@@ -56,6 +94,10 @@ namespace ams::sf::hipc {
 
     os::MultiWaitHolderType *ServerManagerBase::WaitSignaled() {
         std::scoped_lock lk(m_selection_mutex);
+        return this->WaitSignaledImpl();
+    }
+
+    os::MultiWaitHolderType *ServerManagerBase::WaitSignaledImpl() {
         while (true) {
             this->LinkDeferred();
             auto selected = os::WaitAny(std::addressof(m_multi_wait));
@@ -70,6 +112,107 @@ namespace ams::sf::hipc {
         }
     }
 
+    os::MultiWaitHolderType *ServerManagerBase::ReplyAndWaitSignaled(PendingReply *pending_reply, hipc::ReceiveResult *out_recv_result, bool *out_received) {
+        *out_received = false;
+
+        /* If we have nothing to reply to, just wait. */
+        if (pending_reply->session_handle == os::InvalidNativeHandle) {
+            return this->WaitSignaled();
+        }
+
+        /* If another thread is selecting, we can't know when it will finish, so reply now rather than keep our client waiting. */
+        /* NOTE: This means that when several threads process the same manager, most replies are sent on their own. */
+        if (!m_selection_mutex.TryLock()) {
+            this->SendPendingReply(pending_reply);
+            return this->WaitSignaled();
+        }
+        std::scoped_lock lk(std::adopt_lock, m_selection_mutex);
+
+        /* Wait on the replied session again, so that we can receive its next request as part of the reply. */
+        /* Its notification will be consumed by our first link. */
+        ServerSession * const replied_session = pending_reply->session;
+        this->RegisterServerSessionToWait(replied_session);
+        m_notify_event.Clear();
+
+        /* Close any handles the reply needed once it has been sent. */
+        ON_SCOPE_EXIT { this->FinishPendingReply(pending_reply); };
+
+        os::NativeHandle reply_target = pending_reply->session_handle;
+        while (true) {
+            this->LinkDeferred();
+
+            /* Reply (on the first pass), and wait for a holder to be signaled, receiving any session request into our message buffer. */
+            const bool is_replying = reply_target != os::InvalidNativeHandle;
+
+            os::MultiWaitHolderType *selected = nullptr;
+            const Result result = os::SdkReplyAndReceive(std::addressof(selected), reply_target, std::addressof(m_multi_wait));
+            reply_target = os::InvalidNativeHandle;
+
+            if (selected == nullptr) {
+                /* If the reply itself failed, close the session, as we would have had we replied on its own. */
+                /* NOTE: A timeout means that we replied without waiting, and a closed session will be noticed when we next receive from it. */
+                if (is_replying && R_FAILED(result) && !svc::ResultTimedOut::Includes(result) && !os::ResultSessionClosedForReply::Includes(result)) {
+                    os::UnlinkMultiWaitHolder(replied_session);
+                    this->CloseSessionImpl(replied_session);
+                }
+
+                /* Nothing was received alongside our reply, so wait again. */
+                continue;
+            } else if (selected == std::addressof(m_request_stop_event_holder)) {
+                return nullptr;
+            } else if (selected == std::addressof(m_notify_event_holder)) {
+                m_notify_event.Clear();
+                continue;
+            }
+
+            os::UnlinkMultiWaitHolder(selected);
+
+            if (static_cast<UserDataTag>(os::GetMultiWaitHolderUserData(selected)) == UserDataTag::Session) {
+                ServerSession *session = static_cast<ServerSession *>(selected);
+
+                if (os::ResultReceiveListBroken::Includes(result)) {
+                    /* The kernel has already failed the request back to its client, so just wait on the session again. */
+                    this->RegisterServerSessionToWait(session);
+                    continue;
+                } else if (R_FAILED(result)) {
+                    /* The session was closed, or we otherwise can't receive from it, so close it. */
+                    *out_recv_result = hipc::ReceiveResult::Closed;
+                } else {
+                    /* The request's pointer data was received into the replied session's pointer buffer; move it to the session's own. */
+                    MovePointerBufferData(cmif::PointerAndSize(hipc::GetMessageBufferOnTls(), hipc::TlsMessageBufferSize), pending_reply->pointer_buffer, session->m_pointer_buffer);
+                    *out_recv_result = hipc::ReceiveResult::Success;
+                }
+
+                *out_received = true;
+            }
+
+            return selected;
+        }
+    }
+
+    void ServerManagerBase::SendPendingReply(PendingReply *pending_reply) {
+        if (pending_reply->session_handle != os::InvalidNativeHandle) {
+            ON_SCOPE_EXIT { this->FinishPendingReply(pending_reply); };
+
+            /* As in ProcessRequest, a session we fail to reply to is closed, and is otherwise ready for its next request. */
+            if (R_SUCCEEDED(hipc::Reply(pending_reply->session_handle, cmif::PointerAndSize(hipc::GetMessageBufferOnTls(), hipc::TlsMessageBufferSize)))) {
+                this->RegisterServerSessionToWait(pending_reply->session);
+            } else {
+                this->CloseSessionImpl(pending_reply->session);
+            }
+        }
+    }
+
+    void ServerManagerBase::FinishPendingReply(PendingReply *pending_reply) {
+        for (size_t i = 0; i < pending_reply->handles_to_close.num_handles; i++) {
+            os::CloseNativeHandle(pending_reply->handles_to_close.handles[i]);
+        }
+
+        pending_reply->session                      = nullptr;
+        pending_reply->session_handle               = os::InvalidNativeHandle;
+        pending_reply->handles_to_close.num_handles = 0;
+    }
+
     void ServerManagerBase::ResumeProcessing() {
         m_request_stop_event.Clear();
     }
@@ -114,18 +257,32 @@ namespace ams::sf::hipc {
     }
     #endif
 
-    Result ServerManagerBase::ProcessForSession(os::MultiWaitHolderType *holder) {
+    Result ServerManagerBase::ProcessForSession(os::MultiWaitHolderType *holder, PendingReply *pending_reply, const hipc::ReceiveResult *recv_result) {
         AMS_ABORT_UNLESS(static_cast<UserDataTag>(os::GetMultiWaitHolderUserData(holder)) == UserDataTag::Session);
 
         ServerSession *session = static_cast<ServerSession *>(holder);
 
         cmif::PointerAndSize tls_message(hipc::GetMessageBufferOnTls(), hipc::TlsMessageBufferSize);
+
+        const auto ReceiveRequest = [&]() -> Result {
+            /* If the request was already received alongside a reply, we only need to know whether the session was closed. */
+            if (recv_result != nullptr) {
+                session->m_is_closed = (*recv_result == hipc::ReceiveResult::Closed);
+                R_SUCCEED();
+            }
+
+            R_RETURN(this->ReceiveRequest(session, tls_message));
+        };
+
+        /* Let the session's dispatch leave its reply to us, if we can send it as part of our next wait. */
+        session->m_pending_reply = pending_reply;
+
         if (this->CanDeferInvokeRequest()) {
             const cmif::PointerAndSize &saved_message = session->m_saved_message;
             AMS_ABORT_UNLESS(tls_message.GetSize() == saved_message.GetSize());
 
             if (!session->m_has_received) {
-                R_TRY(this->ReceiveRequest(session, tls_message));
+                R_TRY(ReceiveRequest());
                 session->m_has_received = true;
                 std::memcpy(saved_message.GetPointer(), tls_message.GetPointer(), tls_message.GetSize());
             } else {
@@ -139,7 +296,7 @@ namespace ams::sf::hipc {
             } R_END_TRY_CATCH;
         } else {
             if (!session->m_has_received) {
-                R_TRY(this->ReceiveRequest(session, tls_message));
+                R_TRY(ReceiveRequest());
                 session->m_has_received = true;
 
                 #if AMS_SF_MITM_SUPPORTED
@@ -161,12 +318,12 @@ namespace ams::sf::hipc {
         R_SUCCEED();
     }
 
-    Result ServerManagerBase::Process(os::MultiWaitHolderType *holder) {
+    Result ServerManagerBase::ProcessImpl(os::MultiWaitHolderType *holder, PendingReply *pending_reply, const hipc::ReceiveResult *recv_result) {
         switch (static_cast<UserDataTag>(os::GetMultiWaitHolderUserData(holder))) {
             case UserDataTag::Server:
                 R_RETURN(this->ProcessForServer(holder));
             case UserDataTag::Session:
-                R_RETURN(this->ProcessForSession(holder));
+                R_RETURN(this->ProcessForSession(holder, pending_reply, recv_result));
             #if AMS_SF_MITM_SUPPORTED
             case UserDataTag::MitmServer:
                 AMS_ABORT_UNLESS(this->CanManageMitmServers());
@@ -176,9 +333,25 @@ namespace ams::sf::hipc {
         }
     }
 
-    bool ServerManagerBase::WaitAndProcessImpl() {
-        if (auto *signaled_holder = this->WaitSignaled(); signaled_holder != nullptr) {
-            R_ABORT_UNLESS(this->Process(signaled_holder));
+    Result ServerManagerBase::Process(os::MultiWaitHolderType *holder) {
+        R_RETURN(this->ProcessImpl(holder, nullptr, nullptr));
+    }
+
+    bool ServerManagerBase::WaitAndProcessImpl(PendingReply *pending_reply) {
+        /* If we can't carry a reply into our wait, just wait and process. */
+        if (pending_reply == nullptr) {
+            if (auto *signaled_holder = this->WaitSignaled(); signaled_holder != nullptr) {
+                R_ABORT_UNLESS(this->Process(signaled_holder));
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        hipc::ReceiveResult recv_result;
+        bool received;
+        if (auto *signaled_holder = this->ReplyAndWaitSignaled(pending_reply, std::addressof(recv_result), std::addressof(received)); signaled_holder != nullptr) {
+            R_ABORT_UNLESS(this->ProcessImpl(signaled_holder, pending_reply, received ? std::addressof(recv_result) : nullptr));
             return true;
         } else {
             return false;
@@ -186,13 +359,22 @@ namespace ams::sf::hipc {
     }
 
     void ServerManagerBase::WaitAndProcess() {
-        this->WaitAndProcessImpl();
+        this->WaitAndProcessImpl(nullptr);
     }
 
     void ServerManagerBase::LoopProcess() {
-        while (this->WaitAndProcessImpl()) {
+        /* NOTE: Mitm sessions may have pointer buffers of differing sizes, so we can't receive for them into another session's buffer. */
+        PendingReply pending_reply = { .session = nullptr, .session_handle = os::InvalidNativeHandle, .pointer_buffer = {}, .handles_to_close = {} };
+        PendingReply *fused_reply  = (IsReplyAndReceiveSupported && !this->CanManageMitmServers()) ? std::addressof(pending_reply) : nullptr;
+
+        while (this->WaitAndProcessImpl(fused_reply)) {
             /* ... */
         }
+
+        /* Make sure we don't leave a client waiting. */
+        if (fused_reply != nullptr) {
+            this->SendPendingReply(fused_reply);
+        }
     }
 
 }
@@ -226,6 +226,32 @@ namespace ams::sf::hipc {
             return hdr.type;
         }
 
+        bool SetReceiveListForReply(const cmif::PointerAndSize &message, const cmif::PointerAndSize &pointer_buffer) {
+            /* Without a pointer buffer, a reply is already a valid message to receive into. */
+            if (pointer_buffer.GetPointer() == nullptr) {
+                return true;
+            }
+
+            /* The kernel takes the receive list for the next request from the reply header, so place one after the raw data. */
+            const auto response = hipcParseRequest(message.GetPointer());
+            if (response.meta.num_recv_statics != 0 || response.meta.num_data_words == 0) {
+                return false;
+            }
+
+            HipcRecvListEntry * const recv_list = reinterpret_cast<HipcRecvListEntry *>(response.data.data_words + response.meta.num_data_words);
+            if (reinterpret_cast<uintptr_t>(recv_list + 1) > message.GetAddress() + message.GetSize()) {
+                return false;
+            }
+
+            HipcHeader hdr = {};
+            __builtin_memcpy(std::addressof(hdr), message.GetPointer(), sizeof(hdr));
+            hdr.recv_static_mode = 2;
+            __builtin_memcpy(message.GetPointer(), std::addressof(hdr), sizeof(hdr));
+
+            *recv_list = hipcMakeRecvStatic(pointer_buffer.GetPointer(), pointer_buffer.GetSize());
+            return true;
+        }
+
     }
 
     Result ServerSessionManager::ProcessRequest(ServerSession *session, const cmif::PointerAndSize &message) {
@@ -242,6 +268,8 @@ namespace ams::sf::hipc {
             }
             default:
             {
+                PendingReply * const pending_reply = session->m_pending_reply;
+
                 R_TRY_CATCH(this->ProcessRequestImpl(session, message, message)) {
                     R_CATCH_RETHROW(sf::impl::ResultRequestContextChanged) /* A meta message changing the request context has been sent. */
                     R_CATCH_ALL() {
@@ -252,7 +280,10 @@ namespace ams::sf::hipc {
                 } R_END_TRY_CATCH;
 
                 /* We succeeded, so we can process future messages on this session. */
-                this->RegisterServerSessionToWait(session);
+                /* If our manager is sending the reply, it will do so once it knows whether the reply succeeded. */
+                if (pending_reply == nullptr || pending_reply->session != session) {
+                    this->RegisterServerSessionToWait(session);
+                }
                 R_SUCCEED();
             }
         }
@@ -329,6 +360,17 @@ namespace ams::sf::hipc {
         /* Invoke command handler. */
         R_TRY(obj_holder.ProcessMessage(dispatch_ctx, in_raw_data));
 
+        /* If our manager will reply as part of its next wait, leave the response in the message buffer for it. */
+        if (PendingReply *pending_reply = std::exchange(session->m_pending_reply, nullptr); pending_reply != nullptr) {
+            if (out_message.GetPointer() == hipc::GetMessageBufferOnTls() && SetReceiveListForReply(out_message, session->m_pointer_buffer)) {
+                pending_reply->session          = session;
+                pending_reply->session_handle   = session->m_session_handle;
+                pending_reply->pointer_buffer   = session->m_pointer_buffer;
+                pending_reply->handles_to_close = handles_to_close;
+                R_SUCCEED();
+            }
+        }
+
         /* Reply. */
         {
             ON_SCOPE_EXIT {
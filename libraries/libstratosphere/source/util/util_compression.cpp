@@ -28,6 +28,18 @@ namespace ams::util {
         return LZ4_compress_default(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), static_cast<int>(src_size), static_cast<int>(dst_size));
     }
 
+    int CompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size, void *work, size_t work_size) {
+        /* Size checks. */
+        static_assert(CompressLZ4WorkBufferSize == LZ4_STREAMSIZE);
+        AMS_ABORT_UNLESS(dst_size <= std::numeric_limits<int>::max());
+        AMS_ABORT_UNLESS(src_size <= std::numeric_limits<int>::max());
+        AMS_ABORT_UNLESS(work_size >= CompressLZ4WorkBufferSize);
+        AMS_ABORT_UNLESS(util::IsAligned(reinterpret_cast<uintptr_t>(work), alignof(void *)));
+
+        /* Use the caller's work buffer for LZ4's state, rather than placing it on the stack. */
+        return LZ4_compress_fast_extState(work, reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), static_cast<int>(src_size), static_cast<int>(dst_size), 1);
+    }
+
     /* Decompression utilities. */
     int DecompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size) {
         /* Size checks. */
@@ -150,8 +150,27 @@ namespace ams::freebsd {
         RB_SET_COLOR(red, RBColor::RB_RED);
     }
 
-    template<typename T> requires HasRBEntry<T>
-    constexpr ALWAYS_INLINE void RB_ROTATE_LEFT(RBHead<T> &head, T *elm, T *&tmp) {
+    /* Default augmentation callback, for trees which do not track per-subtree data. */
+    struct RBNoAugment {
+        template<typename T>
+        constexpr ALWAYS_INLINE void operator()(T *) const { /* ... */ }
+    };
+
+    template<typename Augment>
+    constexpr inline bool IsRBAugmented = !std::is_same<Augment, RBNoAugment>::value;
+
+    template<typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr ALWAYS_INLINE void RB_AUGMENT_WALK(T *elm, Augment augment = {}) {
+        if constexpr (IsRBAugmented<Augment>) {
+            while (elm != nullptr) {
+                augment(elm);
+                elm = RB_PARENT(elm);
+            }
+        }
+    }
+
+    template<typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr ALWAYS_INLINE void RB_ROTATE_LEFT(RBHead<T> &head, T *elm, T *&tmp, Augment augment = {}) {
         tmp = RB_RIGHT(elm);
         if (RB_SET_RIGHT(elm, RB_LEFT(tmp)); RB_RIGHT(elm) != nullptr) {
             RB_SET_PARENT(RB_LEFT(tmp), elm);
@@ -169,10 +188,13 @@ namespace ams::freebsd {
 
         RB_SET_LEFT(tmp, elm);
         RB_SET_PARENT(elm, tmp);
+
+        augment(elm);
+        augment(tmp);
     }
 
-    template<typename T> requires HasRBEntry<T>
-    constexpr ALWAYS_INLINE void RB_ROTATE_RIGHT(RBHead<T> &head, T *elm, T *&tmp) {
+    template<typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr ALWAYS_INLINE void RB_ROTATE_RIGHT(RBHead<T> &head, T *elm, T *&tmp, Augment augment = {}) {
         tmp = RB_LEFT(elm);
         if (RB_SET_LEFT(elm, RB_RIGHT(tmp)); RB_LEFT(elm) != nullptr) {
             RB_SET_PARENT(RB_RIGHT(tmp), elm);
@@ -190,17 +212,20 @@ namespace ams::freebsd {
 
         RB_SET_RIGHT(tmp, elm);
         RB_SET_PARENT(elm, tmp);
+
+        augment(elm);
+        augment(tmp);
     }
 
-    template <typename T> requires HasRBEntry<T>
-    constexpr void RB_REMOVE_COLOR(RBHead<T> &head, T *parent, T *elm) {
+    template <typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr void RB_REMOVE_COLOR(RBHead<T> &head, T *parent, T *elm, Augment augment = {}) {
         T *tmp;
         while ((elm == nullptr || RB_IS_BLACK(elm)) && elm != head.Root()) {
             if (RB_LEFT(parent) == elm) {
                 tmp = RB_RIGHT(parent);
                 if (RB_IS_RED(tmp)) {
                     RB_SET_BLACKRED(tmp, parent);
-                    RB_ROTATE_LEFT(head, parent, tmp);
+                    RB_ROTATE_LEFT(head, parent, tmp, augment);
                     tmp = RB_RIGHT(parent);
                 }
 
@@ -217,7 +242,7 @@ namespace ams::freebsd {
                         }
 
                         RB_SET_COLOR(tmp, RBColor::RB_RED);
-                        RB_ROTATE_RIGHT(head, tmp, oleft);
+                        RB_ROTATE_RIGHT(head, tmp, oleft, augment);
                         tmp = RB_RIGHT(parent);
                     }
 
@@ -227,7 +252,7 @@ namespace ams::freebsd {
                         RB_SET_COLOR(RB_RIGHT(tmp), RBColor::RB_BLACK);
                     }
 
-                    RB_ROTATE_LEFT(head, parent, tmp);
+                    RB_ROTATE_LEFT(head, parent, tmp, augment);
                     elm = head.Root();
                     break;
                 }
@@ -235,7 +260,7 @@ namespace ams::freebsd {
                 tmp = RB_LEFT(parent);
                 if (RB_IS_RED(tmp)) {
                     RB_SET_BLACKRED(tmp, parent);
-                    RB_ROTATE_RIGHT(head, parent, tmp);
+                    RB_ROTATE_RIGHT(head, parent, tmp, augment);
                     tmp = RB_LEFT(parent);
                 }
 
@@ -252,7 +277,7 @@ namespace ams::freebsd {
                         }
 
                         RB_SET_COLOR(tmp, RBColor::RB_RED);
-                        RB_ROTATE_LEFT(head, tmp, oright);
+                        RB_ROTATE_LEFT(head, tmp, oright, augment);
                         tmp = RB_LEFT(parent);
                     }
 
@@ -263,7 +288,7 @@ namespace ams::freebsd {
                         RB_SET_COLOR(RB_LEFT(tmp), RBColor::RB_BLACK);
                     }
 
-                    RB_ROTATE_RIGHT(head, parent, tmp);
+                    RB_ROTATE_RIGHT(head, parent, tmp, augment);
                     elm = head.Root();
                     break;
                 }
@@ -275,8 +300,8 @@ namespace ams::freebsd {
         }
     }
 
-    template <typename T> requires HasRBEntry<T>
-    constexpr T *RB_REMOVE(RBHead<T> &head, T *elm) {
+    template <typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr T *RB_REMOVE(RBHead<T> &head, T *elm, Augment augment = {}) {
         T *child      = nullptr;
         T *parent     = nullptr;
         T *old        = elm;
@@ -333,12 +358,10 @@ namespace ams::freebsd {
                 RB_SET_PARENT(RB_RIGHT(old), elm);
             }
 
-            if (parent) {
-                left = parent;
-            }
+            RB_AUGMENT_WALK(parent, augment);
 
             if (color == RBColor::RB_BLACK) {
-                RB_REMOVE_COLOR(head, parent, child);
+                RB_REMOVE_COLOR(head, parent, child, augment);
             }
 
             return old;
@@ -360,15 +383,17 @@ namespace ams::freebsd {
             head.SetRoot(child);
         }
 
+        RB_AUGMENT_WALK(parent, augment);
+
         if (color == RBColor::RB_BLACK) {
-            RB_REMOVE_COLOR(head, parent, child);
+            RB_REMOVE_COLOR(head, parent, child, augment);
         }
 
         return old;
     }
 
-    template<typename T> requires HasRBEntry<T>
-    constexpr void RB_INSERT_COLOR(RBHead<T> &head, T *elm) {
+    template<typename T, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr void RB_INSERT_COLOR(RBHead<T> &head, T *elm, Augment augment = {}) {
         T *parent = nullptr, *tmp = nullptr;
         while ((parent = RB_PARENT(elm)) != nullptr && RB_IS_RED(parent)) {
             T *gparent = RB_PARENT(parent);
@@ -382,14 +407,14 @@ namespace ams::freebsd {
                 }
 
                 if (RB_RIGHT(parent) == elm) {
-                    RB_ROTATE_LEFT(head, parent, tmp);
+                    RB_ROTATE_LEFT(head, parent, tmp, augment);
                     tmp = parent;
                     parent = elm;
                     elm = tmp;
                 }
 
                 RB_SET_BLACKRED(parent, gparent);
-                RB_ROTATE_RIGHT(head, gparent, tmp);
+                RB_ROTATE_RIGHT(head, gparent, tmp, augment);
             } else {
                 tmp = RB_LEFT(gparent);
                 if (tmp && RB_IS_RED(tmp)) {
@@ -400,22 +425,22 @@ namespace ams::freebsd {
                 }
 
                 if (RB_LEFT(parent) == elm) {
-                    RB_ROTATE_RIGHT(head, parent, tmp);
+                    RB_ROTATE_RIGHT(head, parent, tmp, augment);
                     tmp = parent;
                     parent = elm;
                     elm = tmp;
                 }
 
                 RB_SET_BLACKRED(parent, gparent);
-                RB_ROTATE_LEFT(head, gparent, tmp);
+                RB_ROTATE_LEFT(head, gparent, tmp, augment);
             }
         }
 
         RB_SET_COLOR(head.Root(), RBColor::RB_BLACK);
     }
 
-    template <typename T, typename Compare> requires HasRBEntry<T>
-    constexpr ALWAYS_INLINE T *RB_INSERT(RBHead<T> &head, T *elm, Compare cmp) {
+    template <typename T, typename Compare, typename Augment = RBNoAugment> requires HasRBEntry<T>
+    constexpr ALWAYS_INLINE T *RB_INSERT(RBHead<T> &head, T *elm, Compare cmp, Augment augment = {}) {
         T *parent = nullptr;
         T *tmp    = head.Root();
         int comp  = 0;
@@ -444,7 +469,9 @@ namespace ams::freebsd {
             head.SetRoot(elm);
         }
 
-        RB_INSERT_COLOR(head, elm);
+        RB_AUGMENT_WALK(elm, augment);
+
+        RB_INSERT_COLOR(head, elm, augment);
         return nullptr;
     }
 
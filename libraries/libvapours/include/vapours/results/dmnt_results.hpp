@@ -37,14 +37,21 @@ namespace ams::dmnt {
             R_DEFINE_ERROR_RESULT_NS(cheat, CheatCannotDisable,   6506);
 
         R_DEFINE_ABSTRACT_ERROR_RANGE_NS(cheat, FrozenAddressError, 6600, 6699);
-            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressInvalidWidth,  6600);
-            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressAlreadyExists, 6601);
-            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressNotFound,      6602);
-            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressOutOfResource, 6603);
+            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressInvalidWidth,           6600);
+            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressAlreadyExists,          6601);
+            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressNotFound,               6602);
+            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressOutOfResource,          6603);
+            R_DEFINE_ERROR_RESULT_NS(cheat, FrozenAddressInvalidRefreshInterval, 6604);
 
         R_DEFINE_ABSTRACT_ERROR_RANGE_NS(cheat, VirtualMachineError, 6700, 6799);
             R_DEFINE_ERROR_RESULT_NS(cheat, VirtualMachineInvalidConditionDepth, 6700);
 
+        R_DEFINE_ABSTRACT_ERROR_RANGE_NS(cheat, MemorySearchError, 6800, 6899);
+            R_DEFINE_ERROR_RESULT_NS(cheat, MemorySearchInvalidWidth,     6800);
+            R_DEFINE_ERROR_RESULT_NS(cheat, MemorySearchInvalidCondition, 6801);
+            R_DEFINE_ERROR_RESULT_NS(cheat, MemorySearchNotStarted,       6802);
+            R_DEFINE_ERROR_RESULT_NS(cheat, MemorySearchOutOfResource,    6803);
+
     // }
 
 }
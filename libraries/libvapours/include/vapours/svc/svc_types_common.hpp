@@ -217,6 +217,16 @@ namespace ams::svc {
         SystemInfoType_TotalPhysicalMemorySize  = 0,
         SystemInfoType_UsedPhysicalMemorySize   = 1,
         SystemInfoType_InitialProcessIdRange    = 2,
+
+        SystemInfoType_MesospherePageCache      = 65000,
+    };
+
+    /* SystemInfoType_MesospherePageCache takes a PhysicalMemorySystemInfo in the low 32 bits of its sub-type, and this in the high 32 bits. */
+    enum MesospherePageCacheInfo : u64 {
+        MesospherePageCacheInfo_CachedSize  = 0,
+        MesospherePageCacheInfo_HitCount    = 1,
+        MesospherePageCacheInfo_RefillCount = 2,
+        MesospherePageCacheInfo_DrainCount  = 3,
     };
 
     enum InitialProcessIdRangeInfo : u64 {
@@ -248,6 +248,12 @@ namespace ams::util {
     template<typename T, typename Default>
     using RedBlackKeyType = typename std::remove_pointer<decltype(impl::GetRedBlackKeyType<T, Default>())>::type;
 
+    /* A comparator may provide Augment(node, left, right) to maintain per-subtree data on each element. */
+    template<typename T, typename Value>
+    concept HasRedBlackAugment = requires (Value &node, const Value *child) {
+        { T::Augment(node, child, child) } -> std::same_as<void>;
+    };
+
     template<class T, class Traits, class Comparator>
     class IntrusiveRedBlackTree {
         NON_COPYABLE(IntrusiveRedBlackTree);
@@ -343,9 +349,71 @@ namespace ams::util {
                 return Comparator::Compare(key, *Traits::GetParent(rhs));
             }
 
+            static constexpr bool IsAugmented = HasRedBlackAugment<Comparator, value_type>;
+
+            static constexpr ALWAYS_INLINE const_pointer GetParentOrNull(const IntrusiveRedBlackTreeNode *node) {
+                return node != nullptr ? Traits::GetParent(node) : nullptr;
+            }
+
+            struct AugmentImpl {
+                constexpr ALWAYS_INLINE void operator()(IntrusiveRedBlackTreeNode *node) const {
+                    const auto &entry = node->GetRBEntry();
+                    Comparator::Augment(*Traits::GetParent(node), GetParentOrNull(entry.Left()), GetParentOrNull(entry.Right()));
+                }
+            };
+
+            using AugmentType = typename std::conditional<IsAugmented, AugmentImpl, freebsd::RBNoAugment>::type;
+
             /* Define accessors using RB_* functions. */
             constexpr IntrusiveRedBlackTreeNode *InsertImpl(IntrusiveRedBlackTreeNode *node) {
-                return freebsd::RB_INSERT(m_impl.m_root, node, CompareImpl);
+                return freebsd::RB_INSERT(m_impl.m_root, node, CompareImpl, AugmentType{});
+            }
+
+            constexpr ALWAYS_INLINE IntrusiveRedBlackTreeNode *RemoveImpl(IntrusiveRedBlackTreeNode *node) {
+                return freebsd::RB_REMOVE(m_impl.m_root, node, AugmentType{});
+            }
+
+            template<typename SubtreePredicate, typename Predicate>
+            static constexpr IntrusiveRedBlackTreeNode *FindFirstInSubtreeImpl(IntrusiveRedBlackTreeNode *node, SubtreePredicate &subtree_pred, Predicate &pred) {
+                /* The caller guarantees that the subtree rooted at node contains a match. */
+                while (node != nullptr) {
+                    auto &entry = node->GetRBEntry();
+                    if (IntrusiveRedBlackTreeNode *left = entry.Left(); left != nullptr && subtree_pred(*Traits::GetParent(left))) {
+                        node = left;
+                    } else if (pred(*Traits::GetParent(node))) {
+                        return node;
+                    } else if (IntrusiveRedBlackTreeNode *right = entry.Right(); right != nullptr && subtree_pred(*Traits::GetParent(right))) {
+                        node = right;
+                    } else {
+                        return nullptr;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            template<typename SubtreePredicate, typename Predicate>
+            static constexpr IntrusiveRedBlackTreeNode *FindAugmentedImpl(IntrusiveRedBlackTreeNode *node, SubtreePredicate &subtree_pred, Predicate &pred) {
+                while (node != nullptr) {
+                    /* Check the current node. */
+                    if (pred(*Traits::GetParent(node))) {
+                        return node;
+                    }
+
+                    /* Everything in our right subtree follows us, so search it if it can contain a match. */
+                    if (IntrusiveRedBlackTreeNode *right = node->GetRBEntry().Right(); right != nullptr && subtree_pred(*Traits::GetParent(right))) {
+                        return FindFirstInSubtreeImpl(right, subtree_pred, pred);
+                    }
+
+                    /* Otherwise, ascend until we reach the first ancestor which follows us. */
+                    IntrusiveRedBlackTreeNode *parent;
+                    while ((parent = node->GetRBEntry().Parent()) != nullptr && parent->GetRBEntry().Right() == node) {
+                        node = parent;
+                    }
+                    node = parent;
+                }
+
+                return nullptr;
             }
 
             constexpr ALWAYS_INLINE IntrusiveRedBlackTreeNode *FindImpl(IntrusiveRedBlackTreeNode const *node) const {
@@ -429,7 +497,14 @@ namespace ams::util {
             }
 
             constexpr ALWAYS_INLINE iterator erase(iterator it) {
-                return iterator(m_impl.erase(it.GetImplIterator()));
+                if constexpr (IsAugmented) {
+                    auto cur  = it.GetImplIterator().operator->();
+                    auto next = ImplType::GetNext(cur);
+                    this->RemoveImpl(cur);
+                    return iterator(next);
+                } else {
+                    return iterator(m_impl.erase(it.GetImplIterator()));
+                }
             }
 
             constexpr ALWAYS_INLINE iterator insert(reference ref) {
@@ -461,6 +536,19 @@ namespace ams::util {
             constexpr ALWAYS_INLINE iterator find_existing_key(const_key_reference ref) const {
                 return iterator(this->FindExistingKeyImpl(ref));
             }
+
+            /* Augmented tree support. */
+            constexpr ALWAYS_INLINE void update_augmentation(iterator it) requires IsAugmented {
+                /* The element's augmentable data changed in place; refresh it and its ancestors. */
+                freebsd::RB_AUGMENT_WALK(it.GetImplIterator().operator->(), AugmentType{});
+            }
+
+            /* Finds the first element at or after it satisfying pred. subtree_pred receives the root of a subtree, */
+            /* and must hold if (and only if) pred holds for some element in that subtree. */
+            template<typename SubtreePredicate, typename Predicate> requires IsAugmented
+            constexpr iterator find_augmented(const_iterator it, SubtreePredicate subtree_pred, Predicate pred) const {
+                return iterator(FindAugmentedImpl(const_cast<IntrusiveRedBlackTreeNode *>(it.GetImplIterator().operator->()), subtree_pred, pred));
+            }
     };
 
     template<auto T, class Derived = util::impl::GetParentType<T>>
@@ -19,13 +19,29 @@
 
 namespace ams::mitm::bpc {
 
+    namespace {
+
+        void SaveCommandStatistics() {
+            /* If we were built with command statistics, save them before the system goes down. */
+            #if AMS_SF_COMMAND_STATISTICS_ENABLED
+            ams::fs::EnsureDirectory("sdmc:/atmosphere/logs");
+            sf::cmif::DumpCommandStatistics("sdmc:/atmosphere/logs/ams_mitm_command_statistics.log");
+            #endif
+        }
+
+    }
+
     Result BpcMitmService::RebootSystem() {
+        SaveCommandStatistics();
+
         R_UNLESS(bpc::IsRebootManaged(), sm::mitm::ResultShouldForwardToSession());
         bpc::RebootSystem();
         R_SUCCEED();
     }
 
     Result BpcMitmService::ShutdownSystem() {
+        SaveCommandStatistics();
+
         bpc::ShutdownSystem();
         R_SUCCEED();
     }
@@ -125,9 +125,11 @@ namespace ams::mitm::fs {
                     while (it != g_storage_set.end()) {
                         if (it->GetReferenceCount() > 0) {
                             it->SetSecondChanceImpl(true);
+                            it->GetImpl()->TrimCaches();
                             ++it;
                         } else if (it->GetSecondChanceImpl()) {
                             it->SetSecondChanceImpl(false);
+                            it->GetImpl()->TrimCaches();
                             ++it;
                         } else {
                             auto *holder = std::addressof(*it);
@@ -168,6 +170,16 @@ namespace ams::mitm::fs {
             AMS_ABORT_UNLESS(ack == storage_uptr);
         }
 
+        s64 GetBaseStorageOffset(const romfs::SourceInfo &source) {
+            switch (source.source_type) {
+                case romfs::DataSourceType::Storage:
+                    return source.storage_source_info.offset;
+                case romfs::DataSourceType::File:
+                    return source.file_source_info.offset;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
         class LayeredRomfsStorage : public ams::fs::IStorage {
             private:
                 LayeredRomfsStorageImpl *m_impl;
@@ -273,11 +285,17 @@ namespace ams::mitm::fs {
         }
     }
 
-    LayeredRomfsStorageImpl::LayeredRomfsStorageImpl(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id) : m_storage_romfs(std::move(s_r)), m_file_romfs(std::move(f_r)), m_initialize_event(os::EventClearMode_ManualClear), m_program_id(std::move(pr_id)), m_is_initialized(false), m_started_initialize(false) {
+    LayeredRomfsStorageImpl::LayeredRomfsStorageImpl(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id) : m_storage_romfs(std::move(s_r)), m_file_romfs(std::move(f_r)), m_initialize_event(os::EventClearMode_ManualClear), m_program_id(std::move(pr_id)), m_is_initialized(false), m_started_initialize(false), m_loose_file_cache_mutex(), m_loose_file_cache(), m_loose_file_cache_access_count(0), m_read_ahead_mutex(), m_read_ahead_buffer(nullptr), m_read_ahead_offset(0), m_read_ahead_size(0), m_read_ahead_next_offset(-1), m_read_ahead_source_type(romfs::DataSourceType::Storage), m_read_ahead_next_source_type(romfs::DataSourceType::Storage), m_read_ahead_second_chance(false) {
         /* ... */
     }
 
     LayeredRomfsStorageImpl::~LayeredRomfsStorageImpl() {
+        this->CloseLooseFiles();
+
+        if (m_read_ahead_buffer != nullptr) {
+            std::free(m_read_ahead_buffer);
+        }
+
         for (size_t i = 0; i < m_source_infos.size(); i++) {
             m_source_infos[i].Cleanup();
         }
@@ -293,17 +311,22 @@ namespace ams::mitm::fs {
         /* Build new virtual romfs. */
         romfs::Builder builder(m_program_id);
 
+        /* Enumerate the sd card first: this both tells us whether a previous build's index is up to date, and is the first step of a rebuild. */
         if (mitm::IsInitialized()) {
             builder.AddSdFiles();
         }
-        if (m_file_romfs) {
-            builder.AddStorageFiles(m_file_romfs.get(), romfs::DataSourceType::File);
-        }
-        if (m_storage_romfs) {
-            builder.AddStorageFiles(m_storage_romfs.get(), romfs::DataSourceType::Storage);
-        }
 
-        builder.Build(std::addressof(m_source_infos));
+        /* If we have an up to date index from a previous build, we don't need to build anything. */
+        if (!mitm::IsInitialized() || !builder.LoadIndex(std::addressof(m_source_infos), m_file_romfs.get(), m_storage_romfs.get())) {
+            if (m_file_romfs) {
+                builder.AddStorageFiles(m_file_romfs.get(), romfs::DataSourceType::File);
+            }
+            if (m_storage_romfs) {
+                builder.AddStorageFiles(m_storage_romfs.get(), romfs::DataSourceType::Storage);
+            }
+
+            builder.Build(std::addressof(m_source_infos));
+        }
 
         m_is_initialized = true;
         m_initialize_event.Signal();
@@ -340,22 +363,34 @@ namespace ams::mitm::fs {
 
             if (offset < cur_source.virtual_offset + cur_source.size) {
                 const s64 offset_within_source = offset - cur_source.virtual_offset;
-                const size_t cur_read_size = std::min(size - read_so_far, static_cast<size_t>(cur_source.size - offset_within_source));
+                size_t cur_read_size = std::min(size - read_so_far, static_cast<size_t>(cur_source.size - offset_within_source));
                 switch (cur_source.source_type) {
                     case romfs::DataSourceType::Storage:
-                        R_ABORT_UNLESS(m_storage_romfs->Read(cur_source.storage_source_info.offset + offset_within_source, cur_dst, cur_read_size));
-                        break;
                     case romfs::DataSourceType::File:
-                        R_ABORT_UNLESS(m_file_romfs->Read(cur_source.file_source_info.offset + offset_within_source, cur_dst, cur_read_size));
+                        R_ABORT_UNLESS(this->ReadBaseStorage(cur_source.source_type, GetBaseStorageOffset(cur_source) + offset_within_source, cur_dst, cur_read_size, GetBaseStorageOffset(cur_source) + cur_source.size));
                         break;
                     case romfs::DataSourceType::LooseSdFile:
                         {
-                            FsFile file;
-                            R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(std::addressof(file), m_program_id, cur_source.loose_source_info.path, OpenMode_Read));
-                            ON_SCOPE_EXIT { fsFileClose(std::addressof(file)); };
+                            /* Try to use a cached handle, so that streaming a loose file doesn't require an open/close per read. */
+                            FsFile uncached_file;
+                            FsFile *file;
+                            LooseFileCacheEntry *entry = this->AcquireLooseFile(cur_source);
+                            if (entry != nullptr) {
+                                file = std::addressof(entry->file);
+                            } else {
+                                R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(std::addressof(uncached_file), m_program_id, cur_source.loose_source_info.path, OpenMode_Read));
+                                file = std::addressof(uncached_file);
+                            }
+                            ON_SCOPE_EXIT {
+                                if (entry != nullptr) {
+                                    this->ReleaseLooseFile(entry);
+                                } else {
+                                    fsFileClose(std::addressof(uncached_file));
+                                }
+                            };
 
                             u64 out_read = 0;
-                            R_ABORT_UNLESS(fsFileRead(std::addressof(file), offset_within_source, cur_dst, cur_read_size, FsReadOption_None, std::addressof(out_read)));
+                            R_ABORT_UNLESS(fsFileRead(file, offset_within_source, cur_dst, cur_read_size, FsReadOption_None, std::addressof(out_read)));
                             AMS_ABORT_UNLESS(out_read == cur_read_size);
                         }
                         break;
@@ -389,6 +424,154 @@ namespace ams::mitm::fs {
         R_SUCCEED();
     }
 
+    Result LayeredRomfsStorageImpl::ReadBaseStorage(romfs::DataSourceType source_type, s64 offset, void *buffer, size_t size, s64 end_offset) {
+        auto *storage = source_type == romfs::DataSourceType::Storage ? m_storage_romfs.get() : m_file_romfs.get();
+
+        /* Large reads don't benefit from read-ahead. */
+        if (size >= ReadAheadThreshold) {
+            R_RETURN(storage->Read(offset, buffer, size));
+        }
+
+        {
+            std::scoped_lock lk(m_read_ahead_mutex);
+
+            /* Determine whether this read continues the previous one. */
+            const bool is_sequential = m_read_ahead_next_source_type == source_type && m_read_ahead_next_offset == offset;
+            m_read_ahead_next_source_type = source_type;
+            m_read_ahead_next_offset      = offset + size;
+
+            /* If the data is already buffered, copy it out. */
+            if (m_read_ahead_size > 0 && m_read_ahead_source_type == source_type && m_read_ahead_offset <= offset && offset + static_cast<s64>(size) <= m_read_ahead_offset + static_cast<s64>(m_read_ahead_size)) {
+                std::memcpy(buffer, m_read_ahead_buffer + (offset - m_read_ahead_offset), size);
+                m_read_ahead_second_chance = true;
+                R_SUCCEED();
+            }
+
+            /* If the read is sequential, read ahead into our buffer (up to the end of the source). */
+            if (is_sequential) {
+                if (m_read_ahead_buffer == nullptr) {
+                    m_read_ahead_buffer = static_cast<u8 *>(std::malloc(ReadAheadBufferSize));
+                }
+
+                if (m_read_ahead_buffer != nullptr) {
+                    const size_t fill_size = static_cast<size_t>(std::min<s64>(ReadAheadBufferSize, end_offset - offset));
+                    AMS_ABORT_UNLESS(fill_size >= size);
+
+                    m_read_ahead_size = 0;
+                    R_TRY(storage->Read(offset, m_read_ahead_buffer, fill_size));
+
+                    m_read_ahead_source_type   = source_type;
+                    m_read_ahead_offset        = offset;
+                    m_read_ahead_size          = fill_size;
+                    m_read_ahead_second_chance = true;
+
+                    std::memcpy(buffer, m_read_ahead_buffer, size);
+                    R_SUCCEED();
+                }
+            }
+        }
+
+        R_RETURN(storage->Read(offset, buffer, size));
+    }
+
+    LayeredRomfsStorageImpl::LooseFileCacheEntry *LayeredRomfsStorageImpl::AcquireLooseFile(const romfs::SourceInfo &source) {
+        std::scoped_lock lk(m_loose_file_cache_mutex);
+
+        /* Find either the entry for the source, or the least recently used entry which isn't in use. */
+        LooseFileCacheEntry *victim = nullptr;
+        for (auto &entry : m_loose_file_cache) {
+            if (entry.source_info == std::addressof(source)) {
+                ++entry.reference_count;
+                entry.last_access   = ++m_loose_file_cache_access_count;
+                entry.second_chance = true;
+                return std::addressof(entry);
+            }
+
+            if (entry.reference_count == 0) {
+                if (victim == nullptr || (victim->source_info != nullptr && (entry.source_info == nullptr || entry.last_access < victim->last_access))) {
+                    victim = std::addressof(entry);
+                }
+            }
+        }
+
+        /* If every entry is in use, the caller should use an uncached handle. */
+        if (victim == nullptr) {
+            return nullptr;
+        }
+
+        /* Evict the victim, if it holds an open file. */
+        if (victim->source_info != nullptr) {
+            fsFileClose(std::addressof(victim->file));
+            victim->source_info = nullptr;
+        }
+
+        /* Open the file into the entry. */
+        R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(std::addressof(victim->file), m_program_id, source.loose_source_info.path, OpenMode_Read));
+
+        victim->source_info     = std::addressof(source);
+        victim->last_access     = ++m_loose_file_cache_access_count;
+        victim->reference_count = 1;
+        victim->second_chance   = true;
+        return victim;
+    }
+
+    void LayeredRomfsStorageImpl::ReleaseLooseFile(LooseFileCacheEntry *entry) {
+        std::scoped_lock lk(m_loose_file_cache_mutex);
+
+        AMS_ABORT_UNLESS(entry->reference_count > 0);
+        --entry->reference_count;
+    }
+
+    void LayeredRomfsStorageImpl::TrimCaches() {
+        /* Close any handles which haven't been used since the last time we were called. */
+        {
+            std::scoped_lock lk(m_loose_file_cache_mutex);
+
+            for (auto &entry : m_loose_file_cache) {
+                if (entry.source_info == nullptr || entry.reference_count > 0) {
+                    continue;
+                }
+
+                if (entry.second_chance) {
+                    entry.second_chance = false;
+                } else {
+                    fsFileClose(std::addressof(entry.file));
+                    entry.source_info = nullptr;
+                }
+            }
+        }
+
+        /* Free the read-ahead buffer, if it hasn't been used since the last time we were called. */
+        /* NOTE: Readers hold the read-ahead lock across base storage reads, and we're called with the storage set locked. */
+        /* If a read is in progress, the buffer is in use anyway, so skip it rather than blocking every other storage on the read. */
+        if (m_read_ahead_mutex.TryLock()) {
+            ON_SCOPE_EXIT { m_read_ahead_mutex.Unlock(); };
+
+            if (m_read_ahead_buffer != nullptr) {
+                if (m_read_ahead_second_chance) {
+                    m_read_ahead_second_chance = false;
+                } else {
+                    std::free(m_read_ahead_buffer);
+                    m_read_ahead_buffer = nullptr;
+                    m_read_ahead_size   = 0;
+                }
+            }
+        }
+    }
+
+    void LayeredRomfsStorageImpl::CloseLooseFiles() {
+        std::scoped_lock lk(m_loose_file_cache_mutex);
+
+        for (auto &entry : m_loose_file_cache) {
+            if (entry.source_info != nullptr) {
+                AMS_ABORT_UNLESS(entry.reference_count == 0);
+
+                fsFileClose(std::addressof(entry.file));
+                entry.source_info = nullptr;
+            }
+        }
+    }
+
     Result LayeredRomfsStorageImpl::GetSize(s64 *out_size) {
         /* Ensure we're initialized. */
         if (!m_is_initialized) {
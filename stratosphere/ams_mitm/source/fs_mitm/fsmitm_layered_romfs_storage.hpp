@@ -21,6 +21,18 @@
 namespace ams::mitm::fs {
 
     class LayeredRomfsStorageImpl {
+        private:
+            static constexpr size_t LooseFileCacheEntryCount = 4;
+            static constexpr size_t ReadAheadBufferSize      = 64_KB;
+            static constexpr size_t ReadAheadThreshold       = ReadAheadBufferSize / 4;
+
+            struct LooseFileCacheEntry {
+                const romfs::SourceInfo *source_info;
+                ::FsFile file;
+                u64 last_access;
+                u32 reference_count;
+                bool second_chance;
+            };
         private:
             romfs::Builder::SourceInfoVector m_source_infos;
             std::unique_ptr<ams::fs::IStorage> m_storage_romfs;
@@ -29,11 +41,28 @@ namespace ams::mitm::fs {
             ncm::ProgramId m_program_id;
             bool m_is_initialized;
             bool m_started_initialize;
+            os::SdkMutex m_loose_file_cache_mutex;
+            LooseFileCacheEntry m_loose_file_cache[LooseFileCacheEntryCount];
+            u64 m_loose_file_cache_access_count;
+            os::SdkMutex m_read_ahead_mutex;
+            u8 *m_read_ahead_buffer;
+            s64 m_read_ahead_offset;
+            size_t m_read_ahead_size;
+            s64 m_read_ahead_next_offset;
+            romfs::DataSourceType m_read_ahead_source_type;
+            romfs::DataSourceType m_read_ahead_next_source_type;
+            bool m_read_ahead_second_chance;
         protected:
             inline s64 GetSize() const {
                 const auto &back = m_source_infos.back();
                 return back.virtual_offset + back.size;
             }
+        private:
+            LooseFileCacheEntry *AcquireLooseFile(const romfs::SourceInfo &source);
+            void ReleaseLooseFile(LooseFileCacheEntry *entry);
+            void CloseLooseFiles();
+
+            Result ReadBaseStorage(romfs::DataSourceType source_type, s64 offset, void *buffer, size_t size, s64 end_offset);
         public:
             LayeredRomfsStorageImpl(std::unique_ptr<ams::fs::IStorage> s_r, std::unique_ptr<ams::fs::IStorage> f_r, ncm::ProgramId pr_id);
             ~LayeredRomfsStorageImpl();
@@ -43,6 +72,8 @@ namespace ams::mitm::fs {
 
             constexpr ncm::ProgramId GetProgramId() const { return m_program_id; }
 
+            void TrimCaches();
+
             Result Read(s64 offset, void *buffer, size_t size);
             Result GetSize(s64 *out_size);
             Result Flush();
@@ -248,6 +248,7 @@ namespace ams::mitm::fs {
                     case AllocationType_SourceInfo:
                     case AllocationType_Memory:
                     case AllocationType_TableCache:
+                    case AllocationType_ThreadStack:
                         return false;
                     default:
                         return true;
@@ -578,18 +579,168 @@ namespace ams::mitm::fs {
                 }
             }
 
-            constinit os::SdkMutex g_fs_romfs_path_lock;
-            constinit char g_fs_romfs_path_buffer[fs::EntryNameLengthMax + 1];
+            constexpr size_t SdTraversalThreadCount         = 3;
+            constexpr size_t SdTraversalThreadStackSize     = 0x4000;
+            constexpr size_t SdTraversalQueueSize           = 0x100;
+            constexpr size_t SdTraversalDirectoryEntryCount = 8;
 
-            NOINLINE void OpenFileSystemRomfsDirectory(FsDir *out, ncm::ProgramId program_id, BuildDirectoryContext *parent, fs::OpenDirectoryMode mode, FsFileSystem *fs) {
-                std::scoped_lock lk(g_fs_romfs_path_lock);
-                parent->GetPath(g_fs_romfs_path_buffer);
-                R_ABORT_UNLESS(mitm::fs::OpenAtmosphereRomfsDirectory(out, program_id, g_fs_romfs_path_buffer, mode, fs));
+            struct SdTraversalBuffer {
+                ::FsDirectoryEntry entries[SdTraversalDirectoryEntryCount];
+                char path[fs::EntryNameLengthMax + 1];
+            };
+
+            constexpr size_t SdTraversalThreadStackMemorySize = SdTraversalThreadCount * SdTraversalThreadStackSize + os::ThreadStackAlignment;
+
+            os::ThreadType g_sd_traversal_threads[SdTraversalThreadCount];
+
+            NOINLINE void OpenFileSystemRomfsDirectory(FsDir *out, ncm::ProgramId program_id, BuildDirectoryContext *parent, fs::OpenDirectoryMode mode, FsFileSystem *fs, char *path_buffer) {
+                parent->GetPath(path_buffer);
+                R_ABORT_UNLESS(mitm::fs::OpenAtmosphereRomfsDirectory(out, program_id, path_buffer, mode, fs));
+            }
+
+            constexpr const char RomfsMetadataFileName[] = "romfs_metadata.bin";
+            constexpr const char RomfsIndexFileName[]    = "romfs_index.bin";
+
+            constexpr u32 RomfsIndexMagic   = util::FourCC<'R','F','S','I'>::Code;
+            constexpr u32 RomfsIndexVersion = 2;
+
+            struct RomfsIndexHeader {
+                u32 magic;
+                u32 version;
+                u8 fingerprint[crypto::Sha256Generator::HashSize];
+                u32 num_source_infos;
+                u32 reserved;
+            };
+            static_assert(util::is_pod<RomfsIndexHeader>::value && sizeof(RomfsIndexHeader) == 0x30);
+
+            struct RomfsIndexSourceInfo {
+                s64 virtual_offset;
+                s64 size;
+                s64 offset;
+                u32 data_size;
+                DataSourceType source_type;
+                u8 reserved[3];
+            };
+            static_assert(util::is_pod<RomfsIndexSourceInfo>::value && sizeof(RomfsIndexSourceInfo) == 0x20);
+
+            class IndexFileWriter {
+                NON_COPYABLE(IndexFileWriter);
+                NON_MOVEABLE(IndexFileWriter);
+                private:
+                    static constexpr size_t BufferSize = 16_KB;
+                private:
+                    ::FsFile *m_file;
+                    s64 m_offset;
+                    size_t m_buffered_size;
+                    u8 *m_buffer;
+                public:
+                    IndexFileWriter(::FsFile *f, s64 ofs) : m_file(f), m_offset(ofs), m_buffered_size(0) {
+                        m_buffer = static_cast<u8 *>(AllocateTracked(AllocationType_IndexBuffer, BufferSize));
+                        AMS_ABORT_UNLESS(m_buffer != nullptr);
+                    }
+
+                    ~IndexFileWriter() {
+                        FreeTracked(AllocationType_IndexBuffer, m_buffer, BufferSize);
+                    }
+
+                    Result Write(const void *src, size_t size) {
+                        const u8 *cur_src = static_cast<const u8 *>(src);
+                        while (size > 0) {
+                            const size_t cur_size = std::min(size, BufferSize - m_buffered_size);
+                            std::memcpy(m_buffer + m_buffered_size, cur_src, cur_size);
+
+                            m_buffered_size += cur_size;
+                            cur_src         += cur_size;
+                            size            -= cur_size;
+
+                            if (m_buffered_size == BufferSize) {
+                                R_TRY(this->Flush());
+                            }
+                        }
+
+                        R_SUCCEED();
+                    }
+
+                    Result Flush() {
+                        if (m_buffered_size > 0) {
+                            R_TRY(fsFileWrite(m_file, m_offset, m_buffer, m_buffered_size, FsWriteOption_None));
+
+                            m_offset        += m_buffered_size;
+                            m_buffered_size  = 0;
+                        }
+
+                        R_SUCCEED();
+                    }
+            };
+
+            class IndexFileReader {
+                NON_COPYABLE(IndexFileReader);
+                NON_MOVEABLE(IndexFileReader);
+                private:
+                    static constexpr size_t BufferSize = 16_KB;
+                private:
+                    ::FsFile *m_file;
+                    s64 m_offset;
+                    size_t m_buffered_size;
+                    size_t m_buffer_offset;
+                    u8 *m_buffer;
+                public:
+                    IndexFileReader(::FsFile *f, s64 ofs) : m_file(f), m_offset(ofs), m_buffered_size(0), m_buffer_offset(0) {
+                        m_buffer = static_cast<u8 *>(AllocateTracked(AllocationType_IndexBuffer, BufferSize));
+                        AMS_ABORT_UNLESS(m_buffer != nullptr);
+                    }
+
+                    ~IndexFileReader() {
+                        FreeTracked(AllocationType_IndexBuffer, m_buffer, BufferSize);
+                    }
+
+                    Result Read(void *dst, size_t size) {
+                        u8 *cur_dst = static_cast<u8 *>(dst);
+                        while (size > 0) {
+                            /* Refill the buffer, if we need to. */
+                            if (m_buffer_offset == m_buffered_size) {
+                                u64 read_size = 0;
+                                R_TRY(fsFileRead(m_file, m_offset, m_buffer, BufferSize, FsReadOption_None, std::addressof(read_size)));
+                                R_UNLESS(read_size > 0, fs::ResultDataCorrupted());
+
+                                m_offset        += read_size;
+                                m_buffered_size  = read_size;
+                                m_buffer_offset  = 0;
+                            }
+
+                            const size_t cur_size = std::min(size, m_buffered_size - m_buffer_offset);
+                            std::memcpy(cur_dst, m_buffer + m_buffer_offset, cur_size);
+
+                            m_buffer_offset += cur_size;
+                            cur_dst         += cur_size;
+                            size            -= cur_size;
+                        }
+
+                        R_SUCCEED();
+                    }
+            };
+
+            constexpr size_t IndexTableBufferSize = 16_KB;
+
+            bool UpdateIndexFingerprintWithStorageTable(crypto::Sha256Generator *generator, ams::fs::IStorage *storage, s64 offset, s64 size, u8 *buffer) {
+                while (size > 0) {
+                    const size_t cur_size = static_cast<size_t>(std::min<s64>(size, IndexTableBufferSize));
+                    if (R_FAILED(storage->Read(offset, buffer, cur_size))) {
+                        return false;
+                    }
+
+                    generator->Update(buffer, cur_size);
+
+                    offset += cur_size;
+                    size   -= cur_size;
+                }
+
+                return true;
             }
 
         }
 
-        Builder::Builder(ncm::ProgramId pr_id) : m_program_id(pr_id), m_num_dirs(0), m_num_files(0), m_dir_table_size(0), m_file_table_size(0), m_dir_hash_table_size(0), m_file_hash_table_size(0), m_file_partition_size(0) {
+        Builder::Builder(ncm::ProgramId pr_id) : m_program_id(pr_id), m_num_dirs(0), m_num_files(0), m_dir_table_size(0), m_file_table_size(0), m_dir_hash_table_size(0), m_file_hash_table_size(0), m_file_partition_size(0), m_index_fingerprint(), m_has_index_fingerprint(false) {
             /* Ensure only one romfs is built at any time. */
             g_romfs_build_lock.Lock();
 
@@ -646,57 +797,207 @@ namespace ams::mitm::fs {
             m_files.emplace(std::move(file_ctx));
         }
 
-        void Builder::VisitDirectory(FsFileSystem *fs, BuildDirectoryContext *parent) {
-            FsDir dir;
+        class Builder::SdTraversalContext {
+            NON_COPYABLE(SdTraversalContext);
+            NON_MOVEABLE(SdTraversalContext);
+            private:
+                Builder *m_builder;
+                FsFileSystem *m_fs;
+                os::SdkMutex m_mutex;
+                os::SdkConditionVariable m_cv;
+                BuildDirectoryContext *m_queue[SdTraversalQueueSize];
+                size_t m_queue_head;
+                size_t m_queue_count;
+                size_t m_outstanding_count;
+            public:
+                SdTraversalContext(Builder *builder, FsFileSystem *fs) : m_builder(builder), m_fs(fs), m_mutex(), m_cv(), m_queue(), m_queue_head(0), m_queue_count(0), m_outstanding_count(0) {
+                    /* ... */
+                }
 
-            /* Get number of child directories. */
-            s64 num_child_dirs = 0;
-            {
-                OpenFileSystemRomfsDirectory(std::addressof(dir), m_program_id, parent, OpenDirectoryMode_Directory, fs);
-                ON_SCOPE_EXIT { fsDirClose(std::addressof(dir)); };
-                R_ABORT_UNLESS(fsDirGetEntryCount(std::addressof(dir), std::addressof(num_child_dirs)));
-            }
-            AMS_ABORT_UNLESS(num_child_dirs >= 0);
+                void Run(BuildDirectoryContext *root) {
+                    /* Seed the queue with the root directory. */
+                    {
+                        std::scoped_lock lk(m_mutex);
+                        AMS_ABORT_UNLESS(this->TryEnqueue(root));
+                    }
 
-            {
-                BuildDirectoryContext **child_dirs = num_child_dirs != 0 ? reinterpret_cast<BuildDirectoryContext **>(AllocateTracked(AllocationType_DirPointerArray, sizeof(BuildDirectoryContext *) * num_child_dirs)) : nullptr;
-                AMS_ABORT_UNLESS(num_child_dirs == 0 || child_dirs != nullptr);
-                ON_SCOPE_EXIT { if (child_dirs != nullptr) { FreeTracked(AllocationType_DirPointerArray, child_dirs, sizeof(BuildDirectoryContext *) * num_child_dirs); } };
+                    /* Allocate stacks for our worker threads, for the duration of the traversal. */
+                    void *stack_memory = AllocateTracked(AllocationType_ThreadStack, SdTraversalThreadStackMemorySize);
+                    ON_SCOPE_EXIT {
+                        if (stack_memory != nullptr) {
+                            FreeTracked(AllocationType_ThreadStack, stack_memory, SdTraversalThreadStackMemorySize);
+                        }
+                    };
+
+                    /* Start our worker threads. If we can't create one, we'll simply traverse with fewer. */
+                    bool started[SdTraversalThreadCount] = {};
+                    for (size_t i = 0; i < SdTraversalThreadCount && stack_memory != nullptr; ++i) {
+                        void *stack = reinterpret_cast<void *>(util::AlignUp(reinterpret_cast<uintptr_t>(stack_memory), os::ThreadStackAlignment) + i * SdTraversalThreadStackSize);
+                        if (R_SUCCEEDED(os::CreateThread(std::addressof(g_sd_traversal_threads[i]), ThreadFunction, this, stack, SdTraversalThreadStackSize, AMS_GET_SYSTEM_THREAD_PRIORITY(mitm_fs, RomFileSystemTraverseThread)))) {
+                            os::SetThreadNamePointer(std::addressof(g_sd_traversal_threads[i]), AMS_GET_SYSTEM_THREAD_NAME(mitm_fs, RomFileSystemTraverseThread));
+                            os::StartThread(std::addressof(g_sd_traversal_threads[i]));
+                            started[i] = true;
+                        }
+                    }
 
-                s64 cur_child_dir_ind = 0;
-                {
-                    OpenFileSystemRomfsDirectory(std::addressof(dir), m_program_id, parent, OpenDirectoryMode_All, fs);
-                    ON_SCOPE_EXIT { fsDirClose(std::addressof(dir)); };
+                    /* Participate in the traversal ourselves. */
+                    this->ProcessQueue();
+
+                    /* Wait for our worker threads to finish. */
+                    for (size_t i = 0; i < SdTraversalThreadCount; ++i) {
+                        if (started[i]) {
+                            os::WaitThread(std::addressof(g_sd_traversal_threads[i]));
+                            os::DestroyThread(std::addressof(g_sd_traversal_threads[i]));
+                        }
+                    }
+
+                    AMS_ABORT_UNLESS(m_queue_count == 0);
+                    AMS_ABORT_UNLESS(m_outstanding_count == 0);
+                }
+            private:
+                static void ThreadFunction(void *arg) {
+                    static_cast<SdTraversalContext *>(arg)->ProcessQueue();
+                }
+
+                bool TryEnqueue(BuildDirectoryContext *dir) {
+                    AMS_ASSERT(m_mutex.IsLockedByCurrentThread());
+
+                    if (m_queue_count == SdTraversalQueueSize) {
+                        return false;
+                    }
+
+                    m_queue[(m_queue_head + m_queue_count) % SdTraversalQueueSize] = dir;
+                    ++m_queue_count;
+                    ++m_outstanding_count;
+
+                    m_cv.Signal();
+                    return true;
+                }
+
+                void ProcessQueue() {
+                    /* Allocate our scratch buffer. */
+                    SdTraversalBuffer *buffer;
+                    {
+                        std::scoped_lock lk(m_mutex);
+                        buffer = static_cast<SdTraversalBuffer *>(AllocateTracked(AllocationType_TraversalBuffer, sizeof(SdTraversalBuffer)));
+                    }
+                    AMS_ABORT_UNLESS(buffer != nullptr);
+
+                    ON_SCOPE_EXIT {
+                        std::scoped_lock lk(m_mutex);
+                        FreeTracked(AllocationType_TraversalBuffer, buffer, sizeof(SdTraversalBuffer));
+                    };
 
-                    s64 read_entries = 0;
                     while (true) {
-                        R_ABORT_UNLESS(fsDirRead(std::addressof(dir), std::addressof(read_entries), 1, std::addressof(m_dir_entry)));
-                        if (read_entries != 1) {
-                            break;
+                        /* Get a directory to visit. */
+                        BuildDirectoryContext *dir = nullptr;
+                        {
+                            std::scoped_lock lk(m_mutex);
+
+                            while (m_queue_count == 0 && m_outstanding_count > 0) {
+                                m_cv.Wait(m_mutex);
+                            }
+
+                            /* If nothing is queued or in progress, the traversal is complete. */
+                            if (m_queue_count == 0) {
+                                break;
+                            }
+
+                            dir = m_queue[m_queue_head];
+                            m_queue_head = (m_queue_head + 1) % SdTraversalQueueSize;
+                            --m_queue_count;
                         }
 
-                        AMS_ABORT_UNLESS(m_dir_entry.type == FsDirEntryType_Dir || m_dir_entry.type == FsDirEntryType_File);
-                        if (m_dir_entry.type == FsDirEntryType_Dir) {
-                            AMS_ABORT_UNLESS(child_dirs != nullptr);
-
-                            BuildDirectoryContext *real_child = nullptr;
-                            this->AddDirectory(std::addressof(real_child), parent, std::unique_ptr<BuildDirectoryContext>(AllocateTyped<BuildDirectoryContext>(AllocationType_BuildDirContext, m_dir_entry.name, strlen(m_dir_entry.name))));
-                            AMS_ABORT_UNLESS(real_child != nullptr);
-                            child_dirs[cur_child_dir_ind++] = real_child;
-                            AMS_ABORT_UNLESS(cur_child_dir_ind <= num_child_dirs);
-                        } else /* if (m_dir_entry.type == FsDirEntryType_File) */ {
-                            this->AddFile(parent, std::unique_ptr<BuildFileContext>(AllocateTyped<BuildFileContext>(AllocationType_BuildFileContext, m_dir_entry.name, strlen(m_dir_entry.name), m_dir_entry.file_size, 0, m_cur_source_type)));
+                        /* Visit the directory. */
+                        this->VisitDirectory(dir, buffer);
+
+                        /* Note that we're done with it. */
+                        {
+                            std::scoped_lock lk(m_mutex);
+
+                            if ((--m_outstanding_count) == 0) {
+                                m_cv.Broadcast();
+                            }
                         }
                     }
                 }
 
-                AMS_ABORT_UNLESS(num_child_dirs == cur_child_dir_ind);
-                for (s64 i = 0; i < num_child_dirs; i++) {
-                    this->VisitDirectory(fs, child_dirs[i]);
-                }
-            }
+                void VisitDirectory(BuildDirectoryContext *parent, SdTraversalBuffer *buffer) {
+                    /* NOTE: All access to builder state and to the tracked allocator happens under our lock. */
+                    /* Directory IPC is performed without it, so that workers can enumerate in parallel. */
+                    FsDir dir;
+
+                    /* Get number of child directories. */
+                    s64 num_child_dirs = 0;
+                    {
+                        OpenFileSystemRomfsDirectory(std::addressof(dir), m_builder->m_program_id, parent, OpenDirectoryMode_Directory, m_fs, buffer->path);
+                        ON_SCOPE_EXIT { fsDirClose(std::addressof(dir)); };
+                        R_ABORT_UNLESS(fsDirGetEntryCount(std::addressof(dir), std::addressof(num_child_dirs)));
+                    }
+                    AMS_ABORT_UNLESS(num_child_dirs >= 0);
 
-        }
+                    BuildDirectoryContext **child_dirs = nullptr;
+                    if (num_child_dirs != 0) {
+                        std::scoped_lock lk(m_mutex);
+                        child_dirs = reinterpret_cast<BuildDirectoryContext **>(AllocateTracked(AllocationType_DirPointerArray, sizeof(BuildDirectoryContext *) * num_child_dirs));
+                    }
+                    AMS_ABORT_UNLESS(num_child_dirs == 0 || child_dirs != nullptr);
+                    ON_SCOPE_EXIT {
+                        if (child_dirs != nullptr) {
+                            std::scoped_lock lk(m_mutex);
+                            FreeTracked(AllocationType_DirPointerArray, child_dirs, sizeof(BuildDirectoryContext *) * num_child_dirs);
+                        }
+                    };
+
+                    s64 cur_child_dir_ind = 0;
+                    {
+                        OpenFileSystemRomfsDirectory(std::addressof(dir), m_builder->m_program_id, parent, OpenDirectoryMode_All, m_fs, buffer->path);
+                        ON_SCOPE_EXIT { fsDirClose(std::addressof(dir)); };
+
+                        while (true) {
+                            s64 read_entries = 0;
+                            R_ABORT_UNLESS(fsDirRead(std::addressof(dir), std::addressof(read_entries), SdTraversalDirectoryEntryCount, buffer->entries));
+                            if (read_entries == 0) {
+                                break;
+                            }
+
+                            std::scoped_lock lk(m_mutex);
+
+                            for (s64 i = 0; i < read_entries; ++i) {
+                                const auto &entry = buffer->entries[i];
+
+                                AMS_ABORT_UNLESS(entry.type == FsDirEntryType_Dir || entry.type == FsDirEntryType_File);
+                                if (entry.type == FsDirEntryType_Dir) {
+                                    AMS_ABORT_UNLESS(child_dirs != nullptr);
+                                    AMS_ABORT_UNLESS(cur_child_dir_ind < num_child_dirs);
+
+                                    BuildDirectoryContext *real_child = nullptr;
+                                    m_builder->AddDirectory(std::addressof(real_child), parent, std::unique_ptr<BuildDirectoryContext>(AllocateTyped<BuildDirectoryContext>(AllocationType_BuildDirContext, entry.name, strlen(entry.name))));
+                                    AMS_ABORT_UNLESS(real_child != nullptr);
+                                    child_dirs[cur_child_dir_ind++] = real_child;
+                                } else /* if (entry.type == FsDirEntryType_File) */ {
+                                    m_builder->AddFile(parent, std::unique_ptr<BuildFileContext>(AllocateTyped<BuildFileContext>(AllocationType_BuildFileContext, entry.name, strlen(entry.name), entry.file_size, 0, m_builder->m_cur_source_type)));
+                                }
+                            }
+                        }
+                    }
+
+                    AMS_ABORT_UNLESS(num_child_dirs == cur_child_dir_ind);
+
+                    /* Hand our children off to the queue, visiting any which don't fit ourselves. */
+                    for (s64 i = 0; i < num_child_dirs; i++) {
+                        bool enqueued;
+                        {
+                            std::scoped_lock lk(m_mutex);
+                            enqueued = this->TryEnqueue(child_dirs[i]);
+                        }
+
+                        if (!enqueued) {
+                            this->VisitDirectory(child_dirs[i], buffer);
+                        }
+                    }
+                }
+        };
 
         class DirectoryTableReader : public TableReader<DirectoryEntry> {
             public:
@@ -766,7 +1067,10 @@ namespace ams::mitm::fs {
             }
 
             m_cur_source_type = DataSourceType::LooseSdFile;
-            this->VisitDirectory(std::addressof(sd_filesystem), m_root);
+
+            /* Enumerate the directory tree using a pool of workers, so that directory IPC isn't serialized. */
+            SdTraversalContext traversal(this, std::addressof(sd_filesystem));
+            traversal.Run(m_root);
         }
 
         void Builder::AddStorageFiles(ams::fs::IStorage *storage, DataSourceType source_type) {
@@ -782,10 +1086,284 @@ namespace ams::mitm::fs {
             this->VisitDirectory(m_root, 0x0, dir_table, file_table);
         }
 
+        bool Builder::CalculateIndexFingerprint(ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs) {
+            m_has_index_fingerprint = false;
+
+            crypto::Sha256Generator generator;
+            generator.Initialize();
+
+            /* Include the index version, so that changes to the romfs layout invalidate old indices. */
+            const u32 version = RomfsIndexVersion;
+            generator.Update(std::addressof(version), sizeof(version));
+
+            /* Include the base romfs images. */
+            /* NOTE: The entry tables fully determine what the base images contribute to the built romfs, so we don't need to read any file data. */
+            {
+                u8 *buffer = static_cast<u8 *>(AllocateTracked(AllocationType_IndexBuffer, IndexTableBufferSize));
+                if (buffer == nullptr) {
+                    return false;
+                }
+                ON_SCOPE_EXIT { FreeTracked(AllocationType_IndexBuffer, buffer, IndexTableBufferSize); };
+
+                for (auto *storage : { file_romfs, storage_romfs }) {
+                    Header header = {};
+                    s64 size = -1;
+                    if (storage != nullptr) {
+                        if (R_FAILED(storage->GetSize(std::addressof(size))) || R_FAILED(storage->Read(0, std::addressof(header), sizeof(header)))) {
+                            return false;
+                        }
+                    }
+
+                    generator.Update(std::addressof(header), sizeof(header));
+                    generator.Update(std::addressof(size), sizeof(size));
+
+                    if (storage != nullptr) {
+                        if (!UpdateIndexFingerprintWithStorageTable(std::addressof(generator), storage, header.dir_table_ofs, header.dir_table_size, buffer)) {
+                            return false;
+                        }
+                        if (!UpdateIndexFingerprintWithStorageTable(std::addressof(generator), storage, header.file_table_ofs, header.file_table_size, buffer)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            /* Include the sd card romfs tree, which we've already enumerated. */
+            /* NOTE: Loose file contents are read from the sd card at runtime, so only names and sizes affect the built romfs. */
+            /* Our sets are ordered by path, so the traversal order of the enumeration doesn't affect the fingerprint. */
+            {
+                char path[fs::EntryNameLengthMax + 1];
+
+                const u64 num_dirs = m_directories.size();
+                generator.Update(std::addressof(num_dirs), sizeof(num_dirs));
+                for (const auto &dir : m_directories) {
+                    const size_t path_len = dir->GetPath(path);
+                    generator.Update(path, path_len + 1);
+                }
+
+                const u64 num_files = m_files.size();
+                generator.Update(std::addressof(num_files), sizeof(num_files));
+                for (const auto &file : m_files) {
+                    const size_t path_len = file->GetPath(path);
+                    generator.Update(path, path_len + 1);
+                    generator.Update(std::addressof(file->size), sizeof(file->size));
+                }
+            }
+
+            generator.GetHash(m_index_fingerprint, sizeof(m_index_fingerprint));
+            m_has_index_fingerprint = true;
+            return true;
+        }
+
+        bool Builder::LoadIndex(SourceInfoVector *out_infos, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs) {
+            /* Clear output. */
+            out_infos->clear();
+
+            /* Determine the fingerprint of our inputs. If we can't, we'll need to build without an index. */
+            if (!this->CalculateIndexFingerprint(file_romfs, storage_romfs)) {
+                return false;
+            }
+
+            /* Try to load an index with a matching fingerprint. */
+            if (R_FAILED(this->LoadIndexImpl(out_infos, file_romfs, storage_romfs))) {
+                for (auto &info : *out_infos) {
+                    info.Cleanup();
+                }
+                out_infos->clear();
+
+                return false;
+            }
+
+            return true;
+        }
+
+        Result Builder::LoadIndexImpl(SourceInfoVector *out_infos, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs) {
+            /* Open the index. */
+            FsFile index_file;
+            R_TRY(mitm::fs::OpenAtmosphereSdFile(std::addressof(index_file), m_program_id, RomfsIndexFileName, OpenMode_Read));
+            ON_SCOPE_EXIT { fsFileClose(std::addressof(index_file)); };
+
+            IndexFileReader reader(std::addressof(index_file), 0);
+
+            /* Validate the index header. */
+            RomfsIndexHeader index_header;
+            R_TRY(reader.Read(std::addressof(index_header), sizeof(index_header)));
+            R_UNLESS(index_header.magic == RomfsIndexMagic,                                                              fs::ResultDataCorrupted());
+            R_UNLESS(index_header.version == RomfsIndexVersion,                                                          fs::ResultDataCorrupted());
+            R_UNLESS(crypto::IsSameBytes(index_header.fingerprint, m_index_fingerprint, sizeof(m_index_fingerprint)), fs::ResultDataCorrupted());
+            R_UNLESS(index_header.num_source_infos >= 2,                                                                 fs::ResultDataCorrupted());
+
+            /* Read the source infos. */
+            out_infos->reserve(index_header.num_source_infos);
+            for (u32 i = 0; i < index_header.num_source_infos; ++i) {
+                RomfsIndexSourceInfo record;
+                R_TRY(reader.Read(std::addressof(record), sizeof(record)));
+
+                /* Sources must be sorted and non-overlapping. */
+                R_UNLESS(record.virtual_offset >= 0 && record.size >= 0, fs::ResultDataCorrupted());
+                if (!out_infos->empty()) {
+                    const auto &back = out_infos->back();
+                    R_UNLESS(back.virtual_offset + back.size <= record.virtual_offset, fs::ResultDataCorrupted());
+                }
+
+                switch (record.source_type) {
+                    case DataSourceType::Storage:
+                        R_UNLESS(storage_romfs != nullptr, fs::ResultDataCorrupted());
+                        out_infos->emplace_back(record.virtual_offset, record.size, record.source_type, record.offset);
+                        break;
+                    case DataSourceType::File:
+                        R_UNLESS(file_romfs != nullptr, fs::ResultDataCorrupted());
+                        out_infos->emplace_back(record.virtual_offset, record.size, record.source_type, record.offset);
+                        break;
+                    case DataSourceType::LooseSdFile:
+                        {
+                            R_UNLESS(0 < record.data_size && record.data_size <= fs::EntryNameLengthMax + 1, fs::ResultDataCorrupted());
+
+                            char *path = static_cast<char *>(AllocateTracked(AllocationType_FullPath, record.data_size));
+                            R_UNLESS(path != nullptr, fs::ResultAllocationMemoryFailed());
+
+                            auto path_guard = SCOPE_GUARD { FreeTracked(AllocationType_FullPath, path, record.data_size); };
+
+                            R_TRY(reader.Read(path, record.data_size));
+                            R_UNLESS(path[record.data_size - 1] == '\x00',       fs::ResultDataCorrupted());
+                            R_UNLESS(std::strlen(path) + 1 == record.data_size, fs::ResultDataCorrupted());
+
+                            path_guard.Cancel();
+                            out_infos->emplace_back(record.virtual_offset, record.size, record.source_type, path);
+                        }
+                        break;
+                    case DataSourceType::Memory:
+                        {
+                            /* The only memory source is the romfs header. */
+                            R_UNLESS(i == 0,                                                              fs::ResultDataCorrupted());
+                            R_UNLESS(record.size == sizeof(Header) && record.data_size == sizeof(Header), fs::ResultDataCorrupted());
+
+                            u8 *data = static_cast<u8 *>(AllocateTracked(AllocationType_Memory, sizeof(Header)));
+                            R_UNLESS(data != nullptr, fs::ResultAllocationMemoryFailed());
+
+                            auto data_guard = SCOPE_GUARD { FreeTracked(AllocationType_Memory, data, sizeof(Header)); };
+
+                            R_TRY(reader.Read(data, sizeof(Header)));
+
+                            data_guard.Cancel();
+                            out_infos->emplace_back(record.virtual_offset, record.size, record.source_type, data);
+                        }
+                        break;
+                    case DataSourceType::Metadata:
+                        {
+                            /* The only metadata source is the metadata file, which is always last. */
+                            R_UNLESS(i == index_header.num_source_infos - 1, fs::ResultDataCorrupted());
+
+                            FsFile metadata_file;
+                            R_TRY(mitm::fs::OpenAtmosphereSdFile(std::addressof(metadata_file), m_program_id, RomfsMetadataFileName, OpenMode_Read));
+                            auto file_guard = SCOPE_GUARD { fsFileClose(std::addressof(metadata_file)); };
+
+                            s64 metadata_size = 0;
+                            R_TRY(fsFileGetSize(std::addressof(metadata_file), std::addressof(metadata_size)));
+                            R_UNLESS(metadata_size == record.size, fs::ResultDataCorrupted());
+
+                            file_guard.Cancel();
+                            out_infos->emplace_back(record.virtual_offset, record.size, record.source_type, new RemoteFile(metadata_file));
+                        }
+                        break;
+                    default:
+                        R_THROW(fs::ResultDataCorrupted());
+                }
+            }
+
+            /* Check that the index is well-formed. */
+            R_UNLESS(out_infos->front().source_type == DataSourceType::Memory,   fs::ResultDataCorrupted());
+            R_UNLESS(out_infos->back().source_type  == DataSourceType::Metadata, fs::ResultDataCorrupted());
+
+            R_SUCCEED();
+        }
+
+        Result Builder::SaveIndexImpl(::FsFile *file, const SourceInfoVector &infos) {
+            /* Write the source infos after a placeholder header. */
+            {
+                IndexFileWriter writer(file, sizeof(RomfsIndexHeader));
+
+                for (const auto &info : infos) {
+                    RomfsIndexSourceInfo record = {};
+                    record.virtual_offset = info.virtual_offset;
+                    record.size           = info.size;
+                    record.source_type    = info.source_type;
+
+                    const void *data = nullptr;
+                    switch (info.source_type) {
+                        case DataSourceType::Storage:
+                            record.offset = info.storage_source_info.offset;
+                            break;
+                        case DataSourceType::File:
+                            record.offset = info.file_source_info.offset;
+                            break;
+                        case DataSourceType::LooseSdFile:
+                            data             = info.loose_source_info.path;
+                            record.data_size = std::strlen(info.loose_source_info.path) + 1;
+                            break;
+                        case DataSourceType::Memory:
+                            data             = info.memory_source_info.data;
+                            record.data_size = info.size;
+                            break;
+                        case DataSourceType::Metadata:
+                            break;
+                        AMS_UNREACHABLE_DEFAULT_CASE();
+                    }
+
+                    R_TRY(writer.Write(std::addressof(record), sizeof(record)));
+                    if (data != nullptr) {
+                        R_TRY(writer.Write(data, record.data_size));
+                    }
+                }
+
+                R_TRY(writer.Flush());
+                R_TRY(fsFileFlush(file));
+            }
+
+            /* Now that the contents are written, write the real header to make the index valid. */
+            RomfsIndexHeader index_header = {};
+            index_header.magic            = RomfsIndexMagic;
+            index_header.version          = RomfsIndexVersion;
+            index_header.num_source_infos = infos.size();
+            std::memcpy(index_header.fingerprint, m_index_fingerprint, sizeof(index_header.fingerprint));
+
+            R_RETURN(fsFileWrite(file, 0, std::addressof(index_header), sizeof(index_header), FsWriteOption_Flush));
+        }
+
+        void Builder::SaveIndex(const SourceInfoVector &infos) {
+            /* Determine the size of the index. */
+            s64 index_size = sizeof(RomfsIndexHeader);
+            for (const auto &info : infos) {
+                index_size += sizeof(RomfsIndexSourceInfo);
+
+                if (info.source_type == DataSourceType::LooseSdFile) {
+                    index_size += std::strlen(info.loose_source_info.path) + 1;
+                } else if (info.source_type == DataSourceType::Memory) {
+                    index_size += info.size;
+                }
+            }
+
+            /* Create the index. The file is zero-filled, so it won't be considered valid until the header is written. */
+            FsFile index_file;
+            if (R_FAILED(mitm::fs::CreateAndOpenAtmosphereSdFile(std::addressof(index_file), m_program_id, RomfsIndexFileName, index_size))) {
+                return;
+            }
+            ON_SCOPE_EXIT { fsFileClose(std::addressof(index_file)); };
+
+            /* Write the index. Failure is fine, as we'll simply rebuild next time. */
+            if (R_FAILED(this->SaveIndexImpl(std::addressof(index_file), infos))) {
+                const RomfsIndexHeader invalid_header = {};
+                fsFileWrite(std::addressof(index_file), 0, std::addressof(invalid_header), sizeof(invalid_header), FsWriteOption_Flush);
+            }
+        }
+
         void Builder::Build(SourceInfoVector *out_infos) {
             /* Clear output. */
             out_infos->clear();
 
+            /* Any existing index describes the metadata we're about to overwrite, so discard it. */
+            mitm::fs::DeleteAtmosphereSdFile(m_program_id, RomfsIndexFileName);
+
             /* Open an SD card filesystem. */
             FsFileSystem sd_filesystem;
             R_ABORT_UNLESS(fsOpenSdCardFileSystem(std::addressof(sd_filesystem)));
@@ -804,7 +1382,7 @@ namespace ams::mitm::fs {
             /* Open metadata file. */
             const size_t metadata_size = m_dir_hash_table_size + m_dir_table_size + m_file_hash_table_size + m_file_table_size;
             FsFile metadata_file;
-            R_ABORT_UNLESS(mitm::fs::CreateAndOpenAtmosphereSdFile(std::addressof(metadata_file), m_program_id, "romfs_metadata.bin", metadata_size));
+            R_ABORT_UNLESS(mitm::fs::CreateAndOpenAtmosphereSdFile(std::addressof(metadata_file), m_program_id, RomfsMetadataFileName, metadata_size));
 
             /* Ensure later hash tables will have correct defaults. */
             static_assert(EmptyEntry == 0xFFFFFFFF);
@@ -1071,6 +1649,11 @@ namespace ams::mitm::fs {
                 R_ABORT_UNLESS(fsFileFlush(std::addressof(metadata_file)));
                 out_infos->emplace_back(header->dir_hash_table_ofs, metadata_size, DataSourceType::Metadata, new RemoteFile(metadata_file));
             }
+
+            /* If we know the fingerprint of our inputs, save an index so that we can skip building next time. */
+            if (m_has_index_fingerprint) {
+                this->SaveIndex(*out_infos);
+            }
         }
 
         Result ConfigureDynamicHeap(u64 *out_size, ncm::ProgramId program_id, const cfg::OverrideStatus &status, bool is_application) {
@@ -39,6 +39,9 @@ namespace ams::mitm::fs::romfs {
         AllocationType_DirContextSet,
         AllocationType_FileContextSet,
         AllocationType_Memory,
+        AllocationType_IndexBuffer,
+        AllocationType_TraversalBuffer,
+        AllocationType_ThreadStack,
 
         AllocationType_Count,
     };
@@ -343,6 +346,8 @@ namespace ams::mitm::fs::romfs {
 
             template<AllocationType AllocType, typename T>
             using ContextSet = std::set<std::unique_ptr<T>, Comparator<T>, TrackedAllocator<AllocType, std::unique_ptr<T>>>;
+
+            class SdTraversalContext;
         private:
             ncm::ProgramId m_program_id;
             BuildDirectoryContext *m_root;
@@ -356,14 +361,20 @@ namespace ams::mitm::fs::romfs {
             size_t m_file_hash_table_size;
             size_t m_file_partition_size;
 
-            ::FsDirectoryEntry m_dir_entry;
             DataSourceType m_cur_source_type;
+
+            u8 m_index_fingerprint[crypto::Sha256Generator::HashSize];
+            bool m_has_index_fingerprint;
         private:
-            void VisitDirectory(FsFileSystem *fs, BuildDirectoryContext *parent);
             void VisitDirectory(BuildDirectoryContext *parent, u32 parent_offset, DirectoryTableReader &dir_table, FileTableReader &file_table);
 
             void AddDirectory(BuildDirectoryContext **out, BuildDirectoryContext *parent_ctx, std::unique_ptr<BuildDirectoryContext> file_ctx);
             void AddFile(BuildDirectoryContext *parent_ctx, std::unique_ptr<BuildFileContext> file_ctx);
+
+            bool CalculateIndexFingerprint(ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs);
+            Result LoadIndexImpl(SourceInfoVector *out_infos, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs);
+            Result SaveIndexImpl(::FsFile *file, const SourceInfoVector &infos);
+            void SaveIndex(const SourceInfoVector &infos);
         public:
             Builder(ncm::ProgramId pr_id);
             ~Builder();
@@ -371,6 +382,9 @@ namespace ams::mitm::fs::romfs {
             void AddSdFiles();
             void AddStorageFiles(ams::fs::IStorage *storage, DataSourceType source_type);
 
+            /* NOTE: Must be called after AddSdFiles and before AddStorageFiles, as the sd card tree is part of the fingerprint. */
+            bool LoadIndex(SourceInfoVector *out_infos, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs);
+
             void Build(SourceInfoVector *out_infos);
     };
 
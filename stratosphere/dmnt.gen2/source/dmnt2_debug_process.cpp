@@ -65,6 +65,8 @@ namespace ams::dmnt {
         }
 
         m_is_valid = false;
+
+        this->InvalidateMemoryCache();
     }
 
     Result DebugProcess::Start() {
@@ -289,13 +291,112 @@ namespace ams::dmnt {
     }
 
     Result DebugProcess::ReadMemory(void *dst, uintptr_t address, size_t size) {
-        R_RETURN(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(dst), m_debug_handle, address, size));
+        /* NOTE: We hold the lock throughout, so that the process can't start running between our status check and a cache fill. */
+        std::scoped_lock lk(m_memory_cache_mutex);
+
+        /* Memory can only be cached while the process is stopped, and large reads are unlikely to be repeated. */
+        if (m_status != ProcessStatus_DebugBreak || size > os::MemoryPageSize) {
+            R_RETURN(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(dst), m_debug_handle, address, size));
+        }
+
+        /* Read each page the request touches, through the cache. */
+        u8 *dst_u8 = static_cast<u8 *>(dst);
+        while (size > 0) {
+            const uintptr_t page_address = util::AlignDown(address, os::MemoryPageSize);
+            const size_t page_offset     = address - page_address;
+            const size_t cur_size        = std::min(size, os::MemoryPageSize - page_offset);
+
+            if (const auto *page = this->GetMemoryCachePage(page_address); page != nullptr) {
+                std::memcpy(dst_u8, page->data + page_offset, cur_size);
+            } else {
+                R_TRY(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(dst_u8), m_debug_handle, address, cur_size));
+            }
+
+            dst_u8  += cur_size;
+            address += cur_size;
+            size    -= cur_size;
+        }
+
+        R_SUCCEED();
     }
 
     Result DebugProcess::WriteMemory(const void *src, uintptr_t address, size_t size) {
+        /* Drop any cached copy of the memory we're writing, holding the lock so that the old contents can't be re-cached before the write. */
+        std::scoped_lock lk(m_memory_cache_mutex);
+        this->InvalidateMemoryCacheLocked(address, size);
+
         R_RETURN(svc::WriteDebugProcessMemory(m_debug_handle, reinterpret_cast<uintptr_t>(src), address, size));
     }
 
+    const DebugProcess::MemoryCachePage *DebugProcess::GetMemoryCachePage(uintptr_t page_address) {
+        /* Check if we already have the page, and otherwise find the least recently used page. */
+        MemoryCachePage *victim = std::addressof(m_memory_cache[0]);
+        for (auto &page : m_memory_cache) {
+            if (page.is_valid && page.address == page_address) {
+                page.last_used = ++m_memory_cache_tick;
+                return std::addressof(page);
+            }
+
+            if (!page.is_valid) {
+                if (victim->is_valid) {
+                    victim = std::addressof(page);
+                }
+            } else if (victim->is_valid && page.last_used < victim->last_used) {
+                victim = std::addressof(page);
+            }
+        }
+
+        /* Read the page. Pages share permissions, so this only fails when the whole page is inaccessible. */
+        victim->is_valid = false;
+        if (R_FAILED(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(victim->data), m_debug_handle, page_address, sizeof(victim->data)))) {
+            return nullptr;
+        }
+
+        victim->address   = page_address;
+        victim->last_used = ++m_memory_cache_tick;
+        victim->is_valid  = true;
+        return victim;
+    }
+
+    void DebugProcess::InvalidateMemoryCache() {
+        std::scoped_lock lk(m_memory_cache_mutex);
+
+        this->InvalidateMemoryCacheLocked();
+    }
+
+    void DebugProcess::InvalidateMemoryCacheLocked() {
+        AMS_ASSERT(m_memory_cache_mutex.IsLockedByCurrentThread());
+
+        for (auto &page : m_memory_cache) {
+            page.is_valid = false;
+        }
+    }
+
+    void DebugProcess::SetDebugBreaked() {
+        std::scoped_lock lk(m_memory_cache_mutex);
+
+        /* The process may have modified its memory while it was running, so drop anything cached before it stopped. */
+        this->InvalidateMemoryCacheLocked();
+
+        m_status = ProcessStatus_DebugBreak;
+    }
+
+    void DebugProcess::SetRunning() {
+        std::scoped_lock lk(m_memory_cache_mutex);
+
+        m_status = ProcessStatus_Running;
+    }
+
+    void DebugProcess::InvalidateMemoryCacheLocked(uintptr_t address, size_t size) {
+        AMS_ASSERT(m_memory_cache_mutex.IsLockedByCurrentThread());
+
+        for (auto &page : m_memory_cache) {
+            if (page.is_valid && page.address < address + size && address < page.address + os::MemoryPageSize) {
+                page.is_valid = false;
+            }
+        }
+    }
+
     Result DebugProcess::QueryMemory(svc::MemoryInfo *out, uintptr_t address) {
         svc::PageInfo dummy;
         R_RETURN(svc::QueryDebugProcessMemory(out, std::addressof(dummy), m_debug_handle, address));
@@ -304,11 +405,14 @@ namespace ams::dmnt {
     Result DebugProcess::Continue() {
         AMS_DMNT2_GDB_LOG_DEBUG("DebugProcess::Continue() all\n");
 
+        /* Stop caching memory before the process can start running. */
+        this->SetRunning();
+        ON_RESULT_FAILURE { this->SetDebugBreaked(); };
+
         u64 thread_ids[] = { 0 };
         R_TRY(svc::ContinueDebugEvent(m_debug_handle, svc::ContinueFlag_ExceptionHandled | svc::ContinueFlag_EnableExceptionEvent | svc::ContinueFlag_ContinueAll, thread_ids, util::size(thread_ids)));
 
         m_continue_thread_id = 0;
-        m_status             = ProcessStatus_Running;
 
         this->SetLastThreadId(0);
         this->SetLastSignal(GdbSignal_Signal0);
@@ -319,11 +423,14 @@ namespace ams::dmnt {
     Result DebugProcess::Continue(u64 thread_id) {
         AMS_DMNT2_GDB_LOG_DEBUG("DebugProcess::Continue() thread_id=%lx\n", thread_id);
 
+        /* Stop caching memory before the process can start running. */
+        this->SetRunning();
+        ON_RESULT_FAILURE { this->SetDebugBreaked(); };
+
         u64 thread_ids[] = { thread_id };
         R_TRY(svc::ContinueDebugEvent(m_debug_handle, svc::ContinueFlag_ExceptionHandled | svc::ContinueFlag_EnableExceptionEvent, thread_ids, util::size(thread_ids)));
 
         m_continue_thread_id = thread_id;
-        m_status             = ProcessStatus_Running;
 
         this->SetLastThreadId(0);
         this->SetLastSignal(GdbSignal_Signal0);
@@ -27,6 +27,7 @@ namespace ams::dmnt {
         public:
             static constexpr size_t ThreadCountMax = 0x100;
             static constexpr size_t ModuleCountMax = 0x60;
+            static constexpr size_t MemoryCachePageCountMax = 0x10;
 
             enum ProcessStatus {
                 ProcessStatus_DebugBreak,
@@ -39,6 +40,13 @@ namespace ams::dmnt {
                 ContinueMode_Continue,
                 ContinueMode_Step,
             };
+        private:
+            struct MemoryCachePage {
+                uintptr_t address;
+                u64 last_used;
+                bool is_valid;
+                u8 data[os::MemoryPageSize];
+            };
         private:
             os::NativeHandle m_debug_handle{os::InvalidNativeHandle};
             s32 m_thread_count{0};
@@ -76,6 +84,9 @@ namespace ams::dmnt {
             ncm::ProgramLocation m_program_location{};
             cfg::OverrideStatus m_process_override_status{};
             bool m_is_application{false};
+            mutable os::SdkMutex m_memory_cache_mutex{}; /* Also guards m_status, as whether we may cache depends on it. */
+            MemoryCachePage m_memory_cache[MemoryCachePageCountMax]{};
+            u64 m_memory_cache_tick{};
         public:
             DebugProcess() : m_software_breakpoints(this), m_hardware_breakpoints(this), m_hardware_watchpoints(this), m_step_breakpoints(m_software_breakpoints) {
                 if (svc::IsKernelMesosphere()) {
@@ -94,7 +105,7 @@ namespace ams::dmnt {
             const char *GetModuleName(size_t ix) const { return m_module_definitions[ix].GetName(); }
             uintptr_t GetModuleBaseAddress(size_t ix) const { return m_module_definitions[ix].GetAddress(); }
             uintptr_t GetModuleSize(size_t ix) const { return m_module_definitions[ix].GetSize(); }
-            ProcessStatus GetStatus() const { return m_status; }
+            ProcessStatus GetStatus() const { std::scoped_lock lk(m_memory_cache_mutex); return m_status; }
             os::ProcessId GetProcessId() const { return m_process_id; }
 
             const char *GetProcessName() const { return m_create_process_info.name; }
@@ -120,9 +131,7 @@ namespace ams::dmnt {
                 m_preferred_debug_break_thread_id = tid;
             }
 
-            void SetDebugBreaked() {
-                m_status = ProcessStatus_DebugBreak;
-            }
+            void SetDebugBreaked();
 
             u64 GetAliasRegionAddress() const { return m_process_alias_address; }
             u64 GetAliasRegionSize()    const { return m_process_alias_size; }
@@ -187,6 +196,13 @@ namespace ams::dmnt {
 
             s32 ThreadCreate(u64 thread_id);
             void ThreadExit(u64 thread_id);
+
+            const MemoryCachePage *GetMemoryCachePage(uintptr_t page_address);
+            void InvalidateMemoryCache();
+            void InvalidateMemoryCacheLocked();
+            void InvalidateMemoryCacheLocked(uintptr_t address, size_t size);
+
+            void SetRunning();
     };
 
 }
\ No newline at end of file
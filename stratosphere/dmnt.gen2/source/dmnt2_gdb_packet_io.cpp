@@ -21,7 +21,9 @@ namespace ams::dmnt {
 
     namespace {
 
-        constexpr char BreakCharacter = '\x03'; /* ctrl-c */
+        constexpr char BreakCharacter  = '\x03'; /* ctrl-c */
+        constexpr char EscapeCharacter = '}';
+        constexpr char EscapeXorValue  = 0x20;
 
         constexpr int DecodeHex(char c) {
             if ('a' <= c && c <= 'f') {
@@ -99,9 +101,10 @@ namespace ams::dmnt {
         }
     }
 
-    char *GdbPacketIo::ReceivePacket(bool *out_break, char *dst, size_t size, TransportSession *session) {
+    char *GdbPacketIo::ReceivePacket(bool *out_break, size_t *out_size, char *dst, size_t size, TransportSession *session) {
         /* Default to not breaked. */
         *out_break = false;
+        *out_size  = 0;
 
         /* Receive a packet. */
         while (true) {
@@ -122,6 +125,7 @@ namespace ams::dmnt {
             enum class State {
                 Initial,
                 PacketData,
+                EscapedData,
                 ChecksumHigh,
                 ChecksumLow
             };
@@ -146,16 +150,24 @@ namespace ams::dmnt {
                             }
                             break;
                         case State::PacketData:
-                            /* TODO: Escaped characters. */
                             if (c == '#') {
                                 dst[count] = 0;
                                 state = State::ChecksumHigh;
+                            } else if (c == EscapeCharacter) {
+                                checksum += static_cast<u8>(c);
+                                state = State::EscapedData;
                             } else {
                                 AMS_ABORT_UNLESS(count < size - 1);
                                 checksum += static_cast<u8>(c);
                                 dst[count++] = c;
                             }
                             break;
+                        case State::EscapedData:
+                            AMS_ABORT_UNLESS(count < size - 1);
+                            checksum += static_cast<u8>(c);
+                            dst[count++] = c ^ EscapeXorValue;
+                            state = State::PacketData;
+                            break;
                         case State::ChecksumHigh:
                             csum_high = DecodeHex(c);
                             state = State::ChecksumLow;
@@ -164,6 +176,7 @@ namespace ams::dmnt {
                             csum_low = DecodeHex(c);
 
                             if (m_no_ack) {
+                                *out_size = count;
                                 return dst;
                             } else {
                                 const u8 expectsum = (static_cast<u8>(csum_high) << 4) | (static_cast<u8>(csum_low) << 0);
@@ -178,6 +191,7 @@ namespace ams::dmnt {
                                     session->PutChar('-');
                                 } else {
                                     session->PutChar('+');
+                                    *out_size = count;
                                     return dst;
                                 }
                             }
@@ -19,7 +19,7 @@
 
 namespace ams::dmnt {
 
-    static constexpr size_t GdbPacketBufferSize = 32_KB;
+    static constexpr size_t GdbPacketBufferSize = 64_KB;
 
     class GdbPacketIo {
         private:
@@ -31,7 +31,7 @@ namespace ams::dmnt {
             void SetNoAck() { m_no_ack = true; }
 
             void SendPacket(bool *out_break, const char *src, TransportSession *session);
-            char *ReceivePacket(bool *out_break, char *dst, size_t size, TransportSession *session);
+            char *ReceivePacket(bool *out_break, size_t *out_size, char *dst, size_t size, TransportSession *session);
     };
 
 }
\ No newline at end of file
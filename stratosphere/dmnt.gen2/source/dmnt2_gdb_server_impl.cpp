@@ -390,6 +390,31 @@ namespace ams::dmnt {
             *dst = 0;
         }
 
+        size_t MemoryToBinary(char *dst, char * const dst_end, const void *mem, size_t size) {
+            const u8 *mem_u8 = static_cast<const u8 *>(mem);
+
+            /* Escape characters which are special to the protocol, as well as NUL so that the reply remains a string. */
+            size_t encoded = 0;
+            while (encoded < size) {
+                const u8 v = mem_u8[encoded];
+                const bool escape = v == '#' || v == '$' || v == '}' || v == '*' || v == 0;
+                if (dst_end - dst <= (escape ? 2 : 1)) {
+                    break;
+                }
+
+                if (escape) {
+                    *(dst++) = '}';
+                    *(dst++) = static_cast<char>(v ^ 0x20);
+                } else {
+                    *(dst++) = static_cast<char>(v);
+                }
+                ++encoded;
+            }
+            *dst = 0;
+
+            return encoded;
+        }
+
         void HexToMemory(void *dst, const char *src, size_t size) {
             u8 *dst_u8 = static_cast<u8 *>(dst);
 
@@ -1291,13 +1316,14 @@ namespace ams::dmnt {
         while (m_session.IsValid()) {
             /* Receive a packet. */
             bool do_break = false;
+            size_t packet_size = 0;
             char recv_buf[GdbPacketBufferSize];
-            char *packet = this->ReceivePacket(std::addressof(do_break), recv_buf, sizeof(recv_buf));
+            char *packet = this->ReceivePacket(std::addressof(do_break), std::addressof(packet_size), recv_buf, sizeof(recv_buf));
 
             if (!do_break && packet != nullptr) {
                 /* Process the packet. */
                 char reply_buffer[GdbPacketBufferSize];
-                this->ProcessPacket(packet, reply_buffer);
+                this->ProcessPacket(packet, packet_size, reply_buffer);
 
                 /* Send packet. */
                 this->SendPacket(std::addressof(do_break), reply_buffer);
@@ -1310,9 +1336,10 @@ namespace ams::dmnt {
         }
     }
 
-    void GdbServerImpl::ProcessPacket(char *receive, char *reply) {
+    void GdbServerImpl::ProcessPacket(char *receive, size_t receive_size, char *reply) {
         /* Set our fields. */
         m_receive_packet = receive;
+        m_receive_end    = receive + receive_size;
         m_reply_cur      = reply;
         m_reply_end      = reply + GdbPacketBufferSize;
 
@@ -1345,6 +1372,9 @@ namespace ams::dmnt {
             case 'T':
                 this->T();
                 break;
+            case 'X':
+                this->X();
+                break;
             case 'Z':
                 this->Z();
                 break;
@@ -1368,6 +1398,9 @@ namespace ams::dmnt {
             case 'v':
                 this->v();
                 break;
+            case 'x':
+                this->x();
+                break;
             case 'q':
                 this->q();
                 break;
@@ -1483,7 +1516,7 @@ namespace ams::dmnt {
         /* Parse address/length. */
         const u64 address = DecodeHex(m_receive_packet);
         const u64 length  = DecodeHex(comma + 1);
-        if (length >= sizeof(m_buffer)) {
+        if (length >= sizeof(m_buffer) / 2) {
             AppendReplyError(m_reply_cur, m_reply_end, "E01");
             return;
         }
@@ -1565,6 +1598,43 @@ namespace ams::dmnt {
         }
     }
 
+    void GdbServerImpl::X() {
+        ++m_receive_packet;
+
+        /* Validate format. */
+        char *comma = std::strchr(m_receive_packet, ',');
+        if (comma == nullptr) {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+            return;
+        }
+        *comma = 0;
+
+        char *colon = std::strchr(comma + 1, ':');
+        if (colon == nullptr) {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+            return;
+        }
+        *colon = 0;
+
+        /* Parse address/length. */
+        const u64 address = DecodeHex(m_receive_packet);
+        const u64 length  = DecodeHex(comma + 1);
+
+        /* The data was unescaped when we received it, and so must be exactly as long as specified. */
+        const char *data = colon + 1;
+        if (length != static_cast<u64>(m_receive_end - data)) {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+            return;
+        }
+
+        /* Write the memory. Zero-length writes are used to probe for support. */
+        if (length == 0 || R_SUCCEEDED(m_debug_process.WriteMemory(data, address, length))) {
+            AppendReplyOk(m_reply_cur, m_reply_end);
+        } else {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+        }
+    }
+
     void GdbServerImpl::Z() {
         /* Increment past the 'Z'. */
         ++m_receive_packet;
@@ -1704,7 +1774,7 @@ namespace ams::dmnt {
         /* Parse address/length. */
         const u64 address = DecodeHex(m_receive_packet);
         const u64 length  = DecodeHex(comma + 1);
-        if (length >= sizeof(m_buffer)) {
+        if (length >= sizeof(m_buffer) / 2) {
             AppendReplyError(m_reply_cur, m_reply_end, "E01");
             return;
         }
@@ -1925,6 +1995,32 @@ namespace ams::dmnt {
     }
 
 
+    void GdbServerImpl::x() {
+        ++m_receive_packet;
+
+        /* Validate format. */
+        const char *comma = std::strchr(m_receive_packet, ',');
+        if (comma == nullptr) {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+            return;
+        }
+
+        /* Parse address/length. */
+        /* Partial replies are permitted, so we clamp the length to what we can transfer at once. */
+        const u64 address = DecodeHex(m_receive_packet);
+        const u64 length  = std::min<u64>(DecodeHex(comma + 1), sizeof(m_buffer));
+
+        /* Read the memory. */
+        if (length != 0 && R_FAILED(m_debug_process.ReadMemory(m_buffer, address, length))) {
+            AppendReplyError(m_reply_cur, m_reply_end, "E01");
+            return;
+        }
+
+        /* Encode the memory. */
+        AppendReplyFormat(m_reply_cur, m_reply_end, "b");
+        MemoryToBinary(m_reply_cur, m_reply_end, m_buffer, length);
+    }
+
     void GdbServerImpl::q() {
         if (ParsePrefix(m_receive_packet, "qAttached:")) {
             this->qAttached();
@@ -34,9 +34,10 @@ namespace ams::dmnt {
             TransportSession m_session;
             GdbPacketIo m_packet_io;
             char *m_receive_packet{nullptr};
+            char *m_receive_end{nullptr};
             char *m_reply_cur{nullptr};
             char *m_reply_end{nullptr};
-            char m_buffer[GdbPacketBufferSize / 2];
+            char m_buffer[GdbPacketBufferSize];
             bool m_killed{false};
             os::ThreadType m_events_thread;
             State m_state;
@@ -50,10 +51,10 @@ namespace ams::dmnt {
 
             void LoopProcess();
         private:
-            void ProcessPacket(char *receive, char *reply);
+            void ProcessPacket(char *receive, size_t receive_size, char *reply);
 
             void SendPacket(bool *out_break, const char *src) { return m_packet_io.SendPacket(out_break, src, std::addressof(m_session)); }
-            char *ReceivePacket(bool *out_break, char *dst, size_t size) { return m_packet_io.ReceivePacket(out_break, dst, size, std::addressof(m_session)); }
+            char *ReceivePacket(bool *out_break, size_t *out_size, char *dst, size_t size) { return m_packet_io.ReceivePacket(out_break, out_size, dst, size, std::addressof(m_session)); }
         private:
             bool HasDebugProcess() const { return m_debug_process.IsValid(); }
             bool Is64Bit() const { return m_debug_process.Is64Bit(); }
@@ -81,6 +82,8 @@ namespace ams::dmnt {
 
             void T();
 
+            void X();
+
             void Z();
 
             void c();
@@ -98,6 +101,8 @@ namespace ams::dmnt {
             void vAttach();
             void vCont();
 
+            void x();
+
             void q();
 
             void qAttached();
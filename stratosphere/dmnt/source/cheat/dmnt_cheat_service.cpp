@@ -153,4 +153,29 @@ namespace ams::dmnt::cheat {
         R_RETURN(dmnt::cheat::impl::DisableFrozenAddress(address));
     }
 
+    Result CheatService::SetFrozenAddressRefreshInterval(u64 interval_ms) {
+        R_RETURN(dmnt::cheat::impl::SetFrozenAddressRefreshInterval(interval_ms));
+    }
+
+    /* ========================================================================================= */
+    /* ================================  Memory Search Commands  ============================== */
+    /* ========================================================================================= */
+
+    Result CheatService::StartMemorySearch(sf::Out<u64> out_count, MemorySearchParameters params) {
+        R_RETURN(dmnt::cheat::impl::StartMemorySearch(out_count.GetPointer(), params));
+    }
+
+    Result CheatService::NarrowMemorySearch(sf::Out<u64> out_count, MemorySearchParameters params) {
+        R_RETURN(dmnt::cheat::impl::NarrowMemorySearch(out_count.GetPointer(), params));
+    }
+
+    Result CheatService::GetMemorySearchResults(const sf::OutArray<MemorySearchResult> &results, sf::Out<u64> out_count, u64 offset) {
+        R_UNLESS(results.GetPointer() != nullptr, dmnt::cheat::ResultCheatNullBuffer());
+        R_RETURN(dmnt::cheat::impl::GetMemorySearchResults(results.GetPointer(), results.GetSize(), out_count.GetPointer(), offset));
+    }
+
+    Result CheatService::EndMemorySearch() {
+        R_RETURN(dmnt::cheat::impl::EndMemorySearch());
+    }
+
 }
@@ -44,7 +44,12 @@
     AMS_SF_METHOD_INFO(C, H, 65301, Result, GetFrozenAddresses,          (const sf::OutArray<dmnt::cheat::FrozenAddressEntry> &addresses, sf::Out<u64> out_count, u64 offset), (addresses, out_count, offset)) \
     AMS_SF_METHOD_INFO(C, H, 65302, Result, GetFrozenAddress,            (sf::Out<dmnt::cheat::FrozenAddressEntry> entry, u64 address),                                        (entry, address))               \
     AMS_SF_METHOD_INFO(C, H, 65303, Result, EnableFrozenAddress,         (sf::Out<u64> out_value, u64 address, u64 width),                                                     (out_value, address, width))    \
-    AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address),                                                                                        (address))
+    AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address),                                                                                        (address))                      \
+    AMS_SF_METHOD_INFO(C, H, 65305, Result, SetFrozenAddressRefreshInterval, (u64 interval_ms),                                                                                (interval_ms))                  \
+    AMS_SF_METHOD_INFO(C, H, 65400, Result, StartMemorySearch,           (sf::Out<u64> out_count, dmnt::cheat::MemorySearchParameters params),                                 (out_count, params))            \
+    AMS_SF_METHOD_INFO(C, H, 65401, Result, NarrowMemorySearch,          (sf::Out<u64> out_count, dmnt::cheat::MemorySearchParameters params),                                 (out_count, params))            \
+    AMS_SF_METHOD_INFO(C, H, 65402, Result, GetMemorySearchResults,      (const sf::OutArray<dmnt::cheat::MemorySearchResult> &results, sf::Out<u64> out_count, u64 offset),   (results, out_count, offset))   \
+    AMS_SF_METHOD_INFO(C, H, 65403, Result, EndMemorySearch,             (),                                                                                                   ())
 
 AMS_SF_DEFINE_INTERFACE(ams::dmnt::cheat::impl, ICheatInterface, AMS_DMNT_I_CHEAT_INTERFACE_INTERFACE_INFO, 0x00000000)
 
@@ -82,6 +87,12 @@ namespace ams::dmnt::cheat {
             Result GetFrozenAddress(sf::Out<FrozenAddressEntry> entry, u64 address);
             Result EnableFrozenAddress(sf::Out<u64> out_value, u64 address, u64 width);
             Result DisableFrozenAddress(u64 address);
+            Result SetFrozenAddressRefreshInterval(u64 interval_ms);
+
+            Result StartMemorySearch(sf::Out<u64> out_count, MemorySearchParameters params);
+            Result NarrowMemorySearch(sf::Out<u64> out_count, MemorySearchParameters params);
+            Result GetMemorySearchResults(const sf::OutArray<MemorySearchResult> &results, sf::Out<u64> out_count, u64 offset);
+            Result EndMemorySearch();
     };
     static_assert(impl::IsICheatInterface<CheatService>);
 
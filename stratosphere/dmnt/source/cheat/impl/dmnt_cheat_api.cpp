@@ -16,6 +16,7 @@
 #include <stratosphere.hpp>
 #include "dmnt_cheat_api.hpp"
 #include "dmnt_cheat_vm.hpp"
+#include "dmnt_cheat_memory_search.hpp"
 #include "dmnt_cheat_debug_events_manager.hpp"
 
 namespace ams::dmnt::cheat::impl {
@@ -24,59 +25,66 @@ namespace ams::dmnt::cheat::impl {
 
         /* Helper definitions. */
         constexpr size_t MaxCheatCount = 0x80;
-        constexpr size_t MaxFrozenAddressCount = 0x80;
+        constexpr size_t MaxFrozenAddressCount = 0x1000;
 
-        class FrozenAddressMapEntry : public util::IntrusiveRedBlackTreeBaseNode<FrozenAddressMapEntry> {
-            public:
-                using RedBlackKeyType = u64;
+        constexpr s64 VirtualMachineTimesPerSecond             = 12;
+        constexpr TimeSpan VirtualMachineExecuteInterval       = TimeSpan::FromNanoSeconds(TimeSpan::FromSeconds(1).GetNanoSeconds() / VirtualMachineTimesPerSecond);
+        constexpr TimeSpan DefaultFrozenAddressRefreshInterval = VirtualMachineExecuteInterval;
+        constexpr TimeSpan MaxFrozenAddressRefreshInterval     = TimeSpan::FromHours(1);
+
+        constinit os::SdkMutex g_text_file_buffer_lock;
+        constinit char g_text_file_buffer[64_KB];
+
+        /* Frozen addresses are kept in an array sorted by address, so that entries within the same page are adjacent. */
+        class FrozenAddressSet {
+            NON_COPYABLE(FrozenAddressSet);
+            NON_MOVEABLE(FrozenAddressSet);
             private:
-                u64 m_address;
-                FrozenAddressValue m_value;
+                FrozenAddressEntry m_entries[MaxFrozenAddressCount];
+                size_t m_count;
             public:
-                FrozenAddressMapEntry(u64 address, FrozenAddressValue value) : m_address(address), m_value(value) { /* ... */ }
+                constexpr FrozenAddressSet() : m_entries(), m_count(0) { /* ... */ }
 
-                constexpr u64 GetAddress() const { return m_address; }
+                size_t GetCount() const { return m_count; }
 
-                constexpr const FrozenAddressValue &GetValue() const { return m_value; }
-                constexpr FrozenAddressValue &GetValue() { return m_value; }
+                FrozenAddressEntry *begin() { return m_entries; }
+                FrozenAddressEntry *end() { return m_entries + m_count; }
 
-                static constexpr ALWAYS_INLINE int Compare(const RedBlackKeyType &lval, const FrozenAddressMapEntry &rhs) {
-                    const auto rval = rhs.GetAddress();
+                const FrozenAddressEntry *begin() const { return m_entries; }
+                const FrozenAddressEntry *end() const { return m_entries + m_count; }
 
-                    if (lval < rval) {
-                        return -1;
-                    } else if (lval == rval) {
-                        return 0;
-                    } else {
-                        return 1;
-                    }
+                FrozenAddressEntry *LowerBound(u64 address) {
+                    return std::lower_bound(this->begin(), this->end(), address, [](const FrozenAddressEntry &entry, u64 address) { return entry.address < address; });
                 }
 
-                static constexpr ALWAYS_INLINE int Compare(const FrozenAddressMapEntry &lhs, const FrozenAddressMapEntry &rhs) {
-                    return Compare(lhs.GetAddress(), rhs);
+                FrozenAddressEntry *Find(u64 address) {
+                    auto *it = this->LowerBound(address);
+                    return (it != this->end() && it->address == address) ? it : nullptr;
                 }
-        };
 
-        constinit os::SdkMutex g_text_file_buffer_lock;
-        constinit char g_text_file_buffer[64_KB];
+                bool Insert(u64 address, const FrozenAddressValue &value) {
+                    if (m_count >= MaxFrozenAddressCount) {
+                        return false;
+                    }
 
-        constinit u8 g_frozen_address_map_memory[sizeof(FrozenAddressMapEntry) * MaxFrozenAddressCount];
-        constinit lmem::HeapHandle g_frozen_address_map_heap;
+                    auto *it = this->LowerBound(address);
+                    std::memmove(it + 1, it, (this->end() - it) * sizeof(*it));
 
-        FrozenAddressMapEntry *AllocateFrozenAddress(u64 address, FrozenAddressValue value) {
-            FrozenAddressMapEntry *entry = static_cast<FrozenAddressMapEntry *>(lmem::AllocateFromUnitHeap(g_frozen_address_map_heap));
-            if (entry != nullptr) {
-                std::construct_at(entry, address, value);
-            }
-            return entry;
-        }
+                    it->address = address;
+                    it->value   = value;
+                    ++m_count;
+                    return true;
+                }
 
-        void DeallocateFrozenAddress(FrozenAddressMapEntry *entry) {
-            std::destroy_at(entry);
-            lmem::FreeToUnitHeap(g_frozen_address_map_heap, entry);
-        }
+                void Erase(FrozenAddressEntry *it) {
+                    std::memmove(it, it + 1, (this->end() - (it + 1)) * sizeof(*it));
+                    --m_count;
+                }
 
-        using FrozenAddressMap = typename util::IntrusiveRedBlackTreeBaseTraits<FrozenAddressMapEntry>::TreeType<FrozenAddressMapEntry>;
+                void Clear() {
+                    m_count = 0;
+                }
+        };
 
         /* Manager class. */
         class CheatProcessManager {
@@ -100,7 +108,13 @@ namespace ams::dmnt::cheat::impl {
                 bool m_always_save_cheat_toggles = false;
                 bool m_should_save_cheat_toggles = false;
                 CheatEntry m_cheat_entries[MaxCheatCount] = {};
-                FrozenAddressMap m_frozen_addresses_map = {};
+                FrozenAddressSet m_frozen_addresses;
+                TimeSpan m_frozen_address_refresh_interval = DefaultFrozenAddressRefreshInterval;
+                os::Tick m_next_frozen_address_refresh_tick = os::Tick(0);
+                u8 m_frozen_address_buffer[os::MemoryPageSize + sizeof(u64)] = {};
+                os::SdkMutex m_memory_search_lock;
+                MemorySearcher m_memory_searcher;
+                os::ProcessId m_memory_search_process_id = os::InvalidProcessId;
 
                 alignas(os::MemoryPageSize) u8 m_detect_thread_stack[ThreadStackSize] = {};
                 alignas(os::MemoryPageSize) u8 m_debug_events_thread_stack[ThreadStackSize] = {};
@@ -204,16 +218,17 @@ namespace ams::dmnt::cheat::impl {
                         /* Clear cheat list. */
                         this->ResetAllCheatEntries();
 
-                        /* Clear frozen addresses. */
-                        {
-                            auto it = m_frozen_addresses_map.begin();
-                            while (it != m_frozen_addresses_map.end()) {
-                                FrozenAddressMapEntry *entry = std::addressof(*it);
-                                it = m_frozen_addresses_map.erase(it);
-                                DeallocateFrozenAddress(entry);
-                            }
+                        /* End any memory search, unless one is in progress; it will fail on its next access, and end itself. */
+                        if (!m_memory_search_lock.IsLockedByCurrentThread() && m_memory_search_lock.TryLock()) {
+                            ON_SCOPE_EXIT { m_memory_search_lock.Unlock(); };
+                            m_memory_searcher.End();
                         }
 
+                        /* Clear frozen addresses. */
+                        m_frozen_addresses.Clear();
+                        m_frozen_address_refresh_interval  = DefaultFrozenAddressRefreshInterval;
+                        m_next_frozen_address_refresh_tick = os::Tick(0);
+
                         /* Signal to our fans. */
                         m_cheat_process_event.Signal();
                     }
@@ -243,6 +258,53 @@ namespace ams::dmnt::cheat::impl {
                     return m_cheat_process_debug_handle;
                 }
 
+                /* Gives a memory search access to the process it was started for, taking the cheat lock only for each access. */
+                class MemorySearchAccessor final : public MemorySearcher::IProcessMemoryAccessor {
+                    private:
+                        CheatProcessManager *m_manager;
+                        os::ProcessId m_process_id;
+                    public:
+                        MemorySearchAccessor(CheatProcessManager *manager, os::ProcessId process_id) : m_manager(manager), m_process_id(process_id) { /* ... */ }
+
+                        virtual Result QueryMemory(svc::MemoryInfo *out, u64 address) override {
+                            std::scoped_lock lk(m_manager->m_cheat_lock);
+                            R_TRY(this->EnsureProcess());
+
+                            svc::PageInfo page_info;
+                            R_RETURN(svc::QueryDebugProcessMemory(out, std::addressof(page_info), m_manager->GetCheatProcessHandle(), address));
+                        }
+
+                        virtual Result ReadMemory(void *dst, u64 address, size_t size) override {
+                            std::scoped_lock lk(m_manager->m_cheat_lock);
+                            R_TRY(this->EnsureProcess());
+
+                            R_RETURN(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(dst), m_manager->GetCheatProcessHandle(), address, size));
+                        }
+                    private:
+                        Result EnsureProcess() {
+                            /* Note: This function *MUST* be called only with the cheat lock held. */
+                            R_TRY(m_manager->EnsureCheatProcess());
+                            R_UNLESS(m_manager->m_cheat_process_metadata.process_id == m_process_id, dmnt::cheat::ResultCheatNotAttached());
+                            R_SUCCEED();
+                        }
+                };
+
+                Result PrepareMemorySearch(os::ProcessId *out_process_id) {
+                    /* Note: This function *MUST* be called only with the memory search lock held. */
+                    std::scoped_lock lk(m_cheat_lock);
+
+                    /* A search for a process which has since been detached from is stale. */
+                    const bool has_cheat_process = this->HasActiveCheatProcess();
+                    if (!has_cheat_process || m_memory_search_process_id != m_cheat_process_metadata.process_id) {
+                        m_memory_searcher.End();
+                        m_memory_search_process_id = os::InvalidProcessId;
+                    }
+                    R_UNLESS(has_cheat_process, dmnt::cheat::ResultCheatNotAttached());
+
+                    *out_process_id = m_cheat_process_metadata.process_id;
+                    R_SUCCEED();
+                }
+
                 os::NativeHandle HookToCreateApplicationProcess() const {
                     os::NativeHandle h;
                     R_ABORT_UNLESS(pm::dmnt::HookToCreateApplicationProcess(std::addressof(h)));
@@ -252,6 +314,74 @@ namespace ams::dmnt::cheat::impl {
                 void StartProcess(os::ProcessId process_id) const {
                     R_ABORT_UNLESS(pm::dmnt::StartProcess(process_id));
                 }
+
+                void ApplyFrozenAddresses() {
+                    /* Note: This function *MUST* be called only with the cheat lock held. */
+                    /* Entries are sorted by address, so all entries within a page are handled together. */
+                    auto *it = m_frozen_addresses.begin();
+                    while (it != m_frozen_addresses.end()) {
+                        const u64 page_address = util::AlignDown(it->address, os::MemoryPageSize);
+
+                        auto *page_end = it;
+                        u64 span_end = 0;
+                        while (page_end != m_frozen_addresses.end() && util::AlignDown(page_end->address, os::MemoryPageSize) == page_address) {
+                            span_end = std::max<u64>(span_end, page_end->address + page_end->value.width);
+                            ++page_end;
+                        }
+
+                        this->ApplyFrozenAddressPage(it, page_end, span_end);
+                        it = page_end;
+                    }
+                }
+
+                void ApplyFrozenAddressPage(const FrozenAddressEntry *begin, const FrozenAddressEntry *end, u64 span_end) {
+                    /* NOTE: We use the SVCs directly, to avoid the usual frozen address update logic. */
+                    const auto handle    = this->GetCheatProcessHandle();
+                    const u64 span_start = begin->address;
+
+                    /* Read the current contents of the page, so that we only need to write the values which changed. */
+                    if (R_FAILED(svc::ReadDebugProcessMemory(reinterpret_cast<uintptr_t>(m_frozen_address_buffer), handle, span_start, span_end - span_start))) {
+                        /* We can't tell what changed, so just write everything. */
+                        for (auto *it = begin; it != end; ++it) {
+                            svc::WriteDebugProcessMemory(handle, reinterpret_cast<uintptr_t>(std::addressof(it->value.value)), it->address, it->value.width);
+                        }
+                        return;
+                    }
+
+                    /* Write back changed values, merging runs of them into a single write. */
+                    /* A run may include unchanged frozen values, but never bytes which aren't frozen, as the process may be modifying them. */
+                    u64 run_start = 0, run_end = 0, covered_end = span_start;
+                    auto FlushRun = [&]() ALWAYS_INLINE_LAMBDA {
+                        if (run_start != run_end) {
+                            svc::WriteDebugProcessMemory(handle, reinterpret_cast<uintptr_t>(m_frozen_address_buffer + (run_start - span_start)), run_start, run_end - run_start);
+                            run_start = run_end = 0;
+                        }
+                    };
+
+                    for (auto *it = begin; it != end; ++it) {
+                        const u64 entry_end = it->address + it->value.width;
+
+                        /* If there's a gap before this entry, we have to end the current run. */
+                        if (it->address > covered_end) {
+                            FlushRun();
+                        }
+                        covered_end = std::max(covered_end, entry_end);
+
+                        /* Check if the value has changed. */
+                        u8 *current = m_frozen_address_buffer + (it->address - span_start);
+                        if (std::memcmp(current, std::addressof(it->value.value), it->value.width) == 0) {
+                            continue;
+                        }
+
+                        std::memcpy(current, std::addressof(it->value.value), it->value.width);
+                        if (run_start == run_end) {
+                            run_start = it->address;
+                        }
+                        run_end = std::max(run_end, entry_end);
+                    }
+
+                    FlushRun();
+                }
             public:
                 CheatProcessManager() : m_cheat_lock(), m_unsafe_break_event(os::EventClearMode_ManualClear), m_debug_events_event(os::EventClearMode_AutoClear), m_cheat_process_event(os::EventClearMode_AutoClear, true) {
                     /* Learn whether we should enable cheats by default. */
@@ -316,12 +446,12 @@ namespace ams::dmnt::cheat::impl {
                 Result WriteCheatProcessMemoryUnsafe(u64 proc_addr, const void *data, size_t size) {
                     R_TRY(svc::WriteDebugProcessMemory(this->GetCheatProcessHandle(), reinterpret_cast<uintptr_t>(data), proc_addr, size));
 
-                    for (auto &entry : m_frozen_addresses_map) {
+                    for (auto *it = m_frozen_addresses.LowerBound(proc_addr); it != m_frozen_addresses.end(); ++it) {
                         /* Get address/value. */
-                        const u64 address = entry.GetAddress();
-                        auto &value = entry.GetValue();
+                        const u64 address = it->address;
+                        auto &value = it->value;
 
-                        /* Map is ordered, so break when we can. */
+                        /* Set is ordered, so break when we can. */
                         if (address >= proc_addr + size) {
                             break;
                         }
@@ -599,7 +729,7 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
-                    *out_count = std::distance(m_frozen_addresses_map.begin(), m_frozen_addresses_map.end());
+                    *out_count = m_frozen_addresses.GetCount();
                     R_SUCCEED();
                 }
 
@@ -608,18 +738,10 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
-                    u64 total_count = 0, written_count = 0;
-                    for (const auto &entry : m_frozen_addresses_map) {
-                        if (written_count >= max_count) {
-                            break;
-                        }
-
-                        if (offset <= total_count) {
-                            frz_addrs[written_count].address = entry.GetAddress();
-                            frz_addrs[written_count].value   = entry.GetValue();
-                            written_count++;
-                        }
-                        total_count++;
+                    u64 written_count = 0;
+                    if (offset < m_frozen_addresses.GetCount()) {
+                        written_count = std::min<u64>(max_count, m_frozen_addresses.GetCount() - offset);
+                        std::memcpy(frz_addrs, m_frozen_addresses.begin() + offset, written_count * sizeof(*frz_addrs));
                     }
 
                     *out_count = written_count;
@@ -631,11 +753,10 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
-                    const auto it = m_frozen_addresses_map.find_key(address);
-                    R_UNLESS(it != m_frozen_addresses_map.end(), dmnt::cheat::ResultFrozenAddressNotFound());
+                    const auto *entry = m_frozen_addresses.Find(address);
+                    R_UNLESS(entry != nullptr, dmnt::cheat::ResultFrozenAddressNotFound());
 
-                    frz_addr->address = it->GetAddress();
-                    frz_addr->value   = it->GetValue();
+                    *frz_addr = *entry;
                     R_SUCCEED();
                 }
 
@@ -644,17 +765,14 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
-                    const auto it = m_frozen_addresses_map.find_key(address);
-                    R_UNLESS(it == m_frozen_addresses_map.end(), dmnt::cheat::ResultFrozenAddressAlreadyExists());
+                    R_UNLESS(m_frozen_addresses.Find(address) == nullptr,           dmnt::cheat::ResultFrozenAddressAlreadyExists());
+                    R_UNLESS(m_frozen_addresses.GetCount() < MaxFrozenAddressCount, dmnt::cheat::ResultFrozenAddressOutOfResource());
 
                     FrozenAddressValue value = {};
                     value.width = width;
                     R_TRY(this->ReadCheatProcessMemoryUnsafe(address, std::addressof(value.value), width));
 
-                    FrozenAddressMapEntry *entry = AllocateFrozenAddress(address, value);
-                    R_UNLESS(entry != nullptr, dmnt::cheat::ResultFrozenAddressOutOfResource());
-
-                    m_frozen_addresses_map.insert(*entry);
+                    AMS_ABORT_UNLESS(m_frozen_addresses.Insert(address, value));
                     *out_value = value.value;
                     R_SUCCEED();
                 }
@@ -664,16 +782,69 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
-                    const auto it = m_frozen_addresses_map.find_key(address);
-                    R_UNLESS(it != m_frozen_addresses_map.end(), dmnt::cheat::ResultFrozenAddressNotFound());
+                    auto *entry = m_frozen_addresses.Find(address);
+                    R_UNLESS(entry != nullptr, dmnt::cheat::ResultFrozenAddressNotFound());
 
-                    FrozenAddressMapEntry *entry = std::addressof(*it);
-                    m_frozen_addresses_map.erase(it);
-                    DeallocateFrozenAddress(entry);
+                    m_frozen_addresses.Erase(entry);
+                    R_SUCCEED();
+                }
 
+                Result SetFrozenAddressRefreshInterval(u64 interval_ms) {
+                    std::scoped_lock lk(m_cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    /* Check that the interval is representable. */
+                    R_UNLESS(interval_ms <= static_cast<u64>(MaxFrozenAddressRefreshInterval.GetMilliSeconds()), dmnt::cheat::ResultFrozenAddressInvalidRefreshInterval());
+
+                    /* An interval of zero restores the default, which refreshes once per vm execution. */
+                    m_frozen_address_refresh_interval  = interval_ms != 0 ? TimeSpan::FromMilliSeconds(interval_ms) : DefaultFrozenAddressRefreshInterval;
+                    m_next_frozen_address_refresh_tick = os::Tick(0);
                     R_SUCCEED();
                 }
 
+                Result StartMemorySearch(u64 *out_count, const MemorySearchParameters &params) {
+                    std::scoped_lock lk(m_memory_search_lock);
+
+                    os::ProcessId process_id;
+                    R_TRY(this->PrepareMemorySearch(std::addressof(process_id)));
+
+                    /* Scan without the cheat lock held, so that the cheat vm and other requests aren't stalled behind the sd card. */
+                    MemorySearchAccessor accessor(this, process_id);
+                    R_TRY(m_memory_searcher.Start(out_count, accessor, params));
+
+                    m_memory_search_process_id = process_id;
+                    R_SUCCEED();
+                }
+
+                Result NarrowMemorySearch(u64 *out_count, const MemorySearchParameters &params) {
+                    std::scoped_lock lk(m_memory_search_lock);
+
+                    os::ProcessId process_id;
+                    R_TRY(this->PrepareMemorySearch(std::addressof(process_id)));
+
+                    MemorySearchAccessor accessor(this, process_id);
+                    R_RETURN(m_memory_searcher.Narrow(out_count, accessor, params));
+                }
+
+                Result GetMemorySearchResults(MemorySearchResult *results, size_t max_count, u64 *out_count, u64 offset) {
+                    std::scoped_lock lk(m_memory_search_lock);
+
+                    os::ProcessId process_id;
+                    R_TRY(this->PrepareMemorySearch(std::addressof(process_id)));
+
+                    R_RETURN(m_memory_searcher.GetResults(results, max_count, out_count, offset));
+                }
+
+                Result EndMemorySearch() {
+                    std::scoped_lock lk(m_memory_search_lock);
+
+                    os::ProcessId process_id;
+                    R_TRY(this->PrepareMemorySearch(std::addressof(process_id)));
+
+                    m_memory_searcher.End();
+                    R_SUCCEED();
+                }
         };
 
         void CheatProcessManager::DetectLaunchThread(void *_this) {
@@ -738,38 +909,47 @@ namespace ams::dmnt::cheat::impl {
 
         void CheatProcessManager::VirtualMachineThread(void *_this) {
             CheatProcessManager *manager = reinterpret_cast<CheatProcessManager *>(_this);
+            os::Tick next_execute_tick(0);
             while (true) {
+                TimeSpan sleep_time = VirtualMachineExecuteInterval;
+
                 /* Apply cheats. */
                 {
                     std::scoped_lock lk(manager->m_cheat_lock);
 
                     if (manager->HasActiveCheatProcess()) {
+                        const auto cur_tick = os::GetSystemTick();
+
                         /* Execute VM. */
-                        if (!manager->GetNeedsReloadVm() || manager->m_cheat_vm.LoadProgram(manager->m_cheat_entries, util::size(manager->m_cheat_entries))) {
-                            manager->SetNeedsReloadVm(false);
+                        if (cur_tick >= next_execute_tick) {
+                            if (!manager->GetNeedsReloadVm() || manager->m_cheat_vm.LoadProgram(manager->m_cheat_entries, util::size(manager->m_cheat_entries))) {
+                                manager->SetNeedsReloadVm(false);
 
-                            /* Execute program only if it has opcodes. */
-                            if (manager->m_cheat_vm.GetProgramSize()) {
-                                manager->m_cheat_vm.Execute(std::addressof(manager->m_cheat_process_metadata));
+                                /* Execute program only if it has opcodes. */
+                                if (manager->m_cheat_vm.GetProgramSize()) {
+                                    manager->m_cheat_vm.Execute(std::addressof(manager->m_cheat_process_metadata));
+                                }
                             }
+
+                            next_execute_tick = cur_tick + os::Tick(VirtualMachineExecuteInterval);
                         }
 
                         /* Apply frozen addresses. */
-                        for (const auto &entry : manager->m_frozen_addresses_map) {
-                            const auto address = entry.GetAddress();
-                            const auto &value  = entry.GetValue();
+                        if (cur_tick >= manager->m_next_frozen_address_refresh_tick) {
+                            manager->ApplyFrozenAddresses();
 
-                            /* Use Write SVC directly, to avoid the usual frozen address update logic. */
-                            svc::WriteDebugProcessMemory(manager->GetCheatProcessHandle(), reinterpret_cast<uintptr_t>(std::addressof(value.value)), address, value.width);
+                            manager->m_next_frozen_address_refresh_tick = cur_tick + os::Tick(manager->m_frozen_address_refresh_interval);
                         }
+
+                        /* Sleep until whichever of the two is due next. */
+                        const auto next_tick = std::min(next_execute_tick, manager->m_next_frozen_address_refresh_tick);
+                        const auto end_tick  = os::GetSystemTick();
+                        sleep_time = next_tick > end_tick ? (next_tick - end_tick).ToTimeSpan() : TimeSpan(0);
                     }
                 }
 
                 /* Sleep until next potential execution. */
-                constexpr s64 TimesPerSecond   = 12;
-                constexpr s64 DelayNanoSeconds = TimeSpan::FromSeconds(1).GetNanoSeconds() / TimesPerSecond;
-                constexpr TimeSpan Delay       = TimeSpan::FromNanoSeconds(DelayNanoSeconds);
-                os::SleepThread(Delay);
+                os::SleepThread(sleep_time);
             }
         }
 
@@ -1185,9 +1365,6 @@ namespace ams::dmnt::cheat::impl {
         /* Initialize the debug events manager (spawning its threads). */
         InitializeDebugEventsManager();
 
-        /* Initialize the frozen address map heap. */
-        g_frozen_address_map_heap = lmem::CreateUnitHeap(g_frozen_address_map_memory, sizeof(g_frozen_address_map_memory), sizeof(FrozenAddressMapEntry), lmem::CreateOption_ThreadSafe);
-
         /* Create the cheat process manager (spawning its threads). */
         util::ConstructAt(g_cheat_process_manager);
     }
@@ -1316,4 +1493,24 @@ namespace ams::dmnt::cheat::impl {
         R_RETURN(GetReference(g_cheat_process_manager).DisableFrozenAddress(address));
     }
 
+    Result SetFrozenAddressRefreshInterval(u64 interval_ms) {
+        R_RETURN(GetReference(g_cheat_process_manager).SetFrozenAddressRefreshInterval(interval_ms));
+    }
+
+    Result StartMemorySearch(u64 *out_count, const MemorySearchParameters &params) {
+        R_RETURN(GetReference(g_cheat_process_manager).StartMemorySearch(out_count, params));
+    }
+
+    Result NarrowMemorySearch(u64 *out_count, const MemorySearchParameters &params) {
+        R_RETURN(GetReference(g_cheat_process_manager).NarrowMemorySearch(out_count, params));
+    }
+
+    Result GetMemorySearchResults(MemorySearchResult *results, size_t max_count, u64 *out_count, u64 offset) {
+        R_RETURN(GetReference(g_cheat_process_manager).GetMemorySearchResults(results, max_count, out_count, offset));
+    }
+
+    Result EndMemorySearch() {
+        R_RETURN(GetReference(g_cheat_process_manager).EndMemorySearch());
+    }
+
 }
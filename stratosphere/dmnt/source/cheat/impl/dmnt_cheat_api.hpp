@@ -56,5 +56,11 @@ namespace ams::dmnt::cheat::impl {
     Result GetFrozenAddress(FrozenAddressEntry *frz_addr, u64 address);
     Result EnableFrozenAddress(u64 *out_value, u64 address, u64 width);
     Result DisableFrozenAddress(u64 address);
+    Result SetFrozenAddressRefreshInterval(u64 interval_ms);
+
+    Result StartMemorySearch(u64 *out_count, const MemorySearchParameters &params);
+    Result NarrowMemorySearch(u64 *out_count, const MemorySearchParameters &params);
+    Result GetMemorySearchResults(MemorySearchResult *results, size_t max_count, u64 *out_count, u64 offset);
+    Result EndMemorySearch();
 
 }
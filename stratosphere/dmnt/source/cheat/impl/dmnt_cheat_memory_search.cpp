@@ -0,0 +1,590 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "dmnt_cheat_memory_search.hpp"
+
+#if defined(ATMOSPHERE_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace ams::dmnt::cheat::impl {
+
+    namespace {
+
+        constexpr const char MemorySearchDirectoryPath[]   = "sdmc:/atmosphere/cheat_search";
+        constexpr const char CandidateBitmapFilePath[]     = "sdmc:/atmosphere/cheat_search/candidates.bin";
+        constexpr const char ValueSnapshotFilePathFormat[] = "sdmc:/atmosphere/cheat_search/values_%zu.bin";
+
+        constexpr size_t ElementsPerBitmapWord = BITSIZEOF(u64);
+
+        alignas(os::MemoryPageSize) constinit u8 g_current_buffer[MemorySearcher::ChunkSize];
+        alignas(os::MemoryPageSize) constinit u8 g_previous_buffer[MemorySearcher::ChunkSize];
+        constinit u64 g_bitmap_buffer[MemorySearcher::ChunkSize / ElementsPerBitmapWord];
+
+        class ValueSnapshotFilePath {
+            private:
+                char m_path[fs::EntryNameLengthMax + 1];
+            public:
+                explicit ValueSnapshotFilePath(size_t index) {
+                    util::SNPrintf(m_path, sizeof(m_path), ValueSnapshotFilePathFormat, index);
+                }
+
+                operator const char *() const { return m_path; }
+        };
+
+        /* The value snapshot files of a search, each of which holds the snapshots of whole regions. */
+        class ValueSnapshotFiles {
+            NON_COPYABLE(ValueSnapshotFiles);
+            NON_MOVEABLE(ValueSnapshotFiles);
+            private:
+                fs::FileHandle m_files[MemorySearcher::MaxSnapshotFileCount];
+                size_t m_count;
+            public:
+                ValueSnapshotFiles() : m_files(), m_count(0) { /* ... */ }
+
+                ~ValueSnapshotFiles() {
+                    for (size_t i = 0; i < m_count; ++i) {
+                        fs::CloseFile(m_files[i]);
+                    }
+                }
+
+                Result Open(size_t count, int mode) {
+                    AMS_ASSERT(count <= MemorySearcher::MaxSnapshotFileCount);
+
+                    for (m_count = 0; m_count < count; ++m_count) {
+                        ValueSnapshotFilePath path(m_count);
+                        R_TRY(fs::OpenFile(m_files + m_count, path, mode));
+                    }
+                    R_SUCCEED();
+                }
+
+                Result Flush() {
+                    for (size_t i = 0; i < m_count; ++i) {
+                        R_TRY(fs::FlushFile(m_files[i]));
+                    }
+                    R_SUCCEED();
+                }
+
+                fs::FileHandle Get(s32 index) const {
+                    AMS_ASSERT(0 <= index && static_cast<size_t>(index) < m_count);
+                    return m_files[index];
+                }
+        };
+
+        constexpr bool IsValidWidth(size_t width) {
+            return width == sizeof(u8) || width == sizeof(u16) || width == sizeof(u32) || width == sizeof(u64);
+        }
+
+        constexpr bool IsValidCondition(u32 condition) {
+            return condition <= MemorySearchCondition_Decreased;
+        }
+
+        constexpr bool RequiresPreviousValue(u32 condition) {
+            switch (condition) {
+                case MemorySearchCondition_Changed:
+                case MemorySearchCondition_Unchanged:
+                case MemorySearchCondition_Increased:
+                case MemorySearchCondition_Decreased:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        constexpr size_t GetBitmapSize(size_t num_elements) {
+            return num_elements / BITSIZEOF(u8);
+        }
+
+        u64 CountCandidates(const u64 *bitmap, size_t num_words) {
+            u64 count = 0;
+            for (size_t i = 0; i < num_words; ++i) {
+                count += util::PopCount(bitmap[i]);
+            }
+            return count;
+        }
+
+        bool HasCandidates(const u64 *bitmap, size_t num_words) {
+            for (size_t i = 0; i < num_words; ++i) {
+                if (bitmap[i] != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        #if defined(ATMOSPHERE_ARCH_ARM64)
+
+        /* Compare a full bitmap word's worth of elements at a time, a vector at a time. */
+        /* Each comparison yields an all-ones lane per matching element, which we reduce to one bit per element. */
+        template<typename T>
+        struct VectorOperations;
+
+        template<>
+        struct VectorOperations<u8> {
+            using Vector = uint8x16_t;
+
+            static ALWAYS_INLINE Vector Load(const u8 *p) { return vld1q_u8(p); }
+            static ALWAYS_INLINE Vector Duplicate(u8 v) { return vdupq_n_u8(v); }
+            static ALWAYS_INLINE Vector Equal(Vector lhs, Vector rhs) { return vceqq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector Greater(Vector lhs, Vector rhs) { return vcgtq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector Less(Vector lhs, Vector rhs) { return vcltq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector GreaterEqual(Vector lhs, Vector rhs) { return vcgeq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector LessEqual(Vector lhs, Vector rhs) { return vcleq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector And(Vector lhs, Vector rhs) { return vandq_u8(lhs, rhs); }
+            static ALWAYS_INLINE Vector Not(Vector v) { return vmvnq_u8(v); }
+
+            static ALWAYS_INLINE u64 ToMask(Vector v) {
+                constexpr const u8 Weights[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+                const Vector bits = vandq_u8(v, vld1q_u8(Weights));
+                return static_cast<u64>(vaddv_u8(vget_low_u8(bits))) | (static_cast<u64>(vaddv_u8(vget_high_u8(bits))) << 8);
+            }
+        };
+
+        template<>
+        struct VectorOperations<u16> {
+            using Vector = uint16x8_t;
+
+            static ALWAYS_INLINE Vector Load(const u16 *p) { return vld1q_u16(p); }
+            static ALWAYS_INLINE Vector Duplicate(u16 v) { return vdupq_n_u16(v); }
+            static ALWAYS_INLINE Vector Equal(Vector lhs, Vector rhs) { return vceqq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector Greater(Vector lhs, Vector rhs) { return vcgtq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector Less(Vector lhs, Vector rhs) { return vcltq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector GreaterEqual(Vector lhs, Vector rhs) { return vcgeq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector LessEqual(Vector lhs, Vector rhs) { return vcleq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector And(Vector lhs, Vector rhs) { return vandq_u16(lhs, rhs); }
+            static ALWAYS_INLINE Vector Not(Vector v) { return vmvnq_u16(v); }
+
+            static ALWAYS_INLINE u64 ToMask(Vector v) {
+                constexpr const u16 Weights[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+                return vaddvq_u16(vandq_u16(v, vld1q_u16(Weights)));
+            }
+        };
+
+        template<>
+        struct VectorOperations<u32> {
+            using Vector = uint32x4_t;
+
+            static ALWAYS_INLINE Vector Load(const u32 *p) { return vld1q_u32(p); }
+            static ALWAYS_INLINE Vector Duplicate(u32 v) { return vdupq_n_u32(v); }
+            static ALWAYS_INLINE Vector Equal(Vector lhs, Vector rhs) { return vceqq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector Greater(Vector lhs, Vector rhs) { return vcgtq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector Less(Vector lhs, Vector rhs) { return vcltq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector GreaterEqual(Vector lhs, Vector rhs) { return vcgeq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector LessEqual(Vector lhs, Vector rhs) { return vcleq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector And(Vector lhs, Vector rhs) { return vandq_u32(lhs, rhs); }
+            static ALWAYS_INLINE Vector Not(Vector v) { return vmvnq_u32(v); }
+
+            static ALWAYS_INLINE u64 ToMask(Vector v) {
+                constexpr const u32 Weights[4] = { 0x01, 0x02, 0x04, 0x08 };
+                return vaddvq_u32(vandq_u32(v, vld1q_u32(Weights)));
+            }
+        };
+
+        template<>
+        struct VectorOperations<u64> {
+            using Vector = uint64x2_t;
+
+            static ALWAYS_INLINE Vector Load(const u64 *p) { return vld1q_u64(p); }
+            static ALWAYS_INLINE Vector Duplicate(u64 v) { return vdupq_n_u64(v); }
+            static ALWAYS_INLINE Vector Equal(Vector lhs, Vector rhs) { return vceqq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector Greater(Vector lhs, Vector rhs) { return vcgtq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector Less(Vector lhs, Vector rhs) { return vcltq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector GreaterEqual(Vector lhs, Vector rhs) { return vcgeq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector LessEqual(Vector lhs, Vector rhs) { return vcleq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector And(Vector lhs, Vector rhs) { return vandq_u64(lhs, rhs); }
+            static ALWAYS_INLINE Vector Not(Vector v) { return veorq_u64(v, vdupq_n_u64(std::numeric_limits<u64>::max())); }
+
+            static ALWAYS_INLINE u64 ToMask(Vector v) {
+                constexpr const u64 Weights[2] = { 0x01, 0x02 };
+                return vaddvq_u64(vandq_u64(v, vld1q_u64(Weights)));
+            }
+        };
+
+        template<typename T, MemorySearchCondition Condition>
+        ALWAYS_INLINE u64 FilterBitmapWord(const T *current, const T *previous, T value, T range_max) {
+            using Operations = VectorOperations<T>;
+            using Vector     = typename Operations::Vector;
+            constexpr size_t Lanes = sizeof(Vector) / sizeof(T);
+
+            const Vector value_vector     = Operations::Duplicate(value);
+            const Vector range_max_vector = Operations::Duplicate(range_max);
+
+            u64 mask = 0;
+            for (size_t i = 0; i < ElementsPerBitmapWord; i += Lanes) {
+                const Vector cur = Operations::Load(current + i);
+
+                Vector match;
+                if constexpr (Condition == MemorySearchCondition_Equal) {
+                    match = Operations::Equal(cur, value_vector);
+                } else if constexpr (Condition == MemorySearchCondition_NotEqual) {
+                    match = Operations::Not(Operations::Equal(cur, value_vector));
+                } else if constexpr (Condition == MemorySearchCondition_InRange) {
+                    match = Operations::And(Operations::GreaterEqual(cur, value_vector), Operations::LessEqual(cur, range_max_vector));
+                } else if constexpr (Condition == MemorySearchCondition_Changed) {
+                    match = Operations::Not(Operations::Equal(cur, Operations::Load(previous + i)));
+                } else if constexpr (Condition == MemorySearchCondition_Unchanged) {
+                    match = Operations::Equal(cur, Operations::Load(previous + i));
+                } else if constexpr (Condition == MemorySearchCondition_Increased) {
+                    match = Operations::Greater(cur, Operations::Load(previous + i));
+                } else if constexpr (Condition == MemorySearchCondition_Decreased) {
+                    match = Operations::Less(cur, Operations::Load(previous + i));
+                } else {
+                    match = Operations::Equal(cur, cur);
+                }
+
+                mask |= Operations::ToMask(match) << i;
+            }
+
+            return mask;
+        }
+
+        #else
+
+        template<typename T, MemorySearchCondition Condition>
+        ALWAYS_INLINE bool IsMatch(T cur, T prev, T value, T range_max) {
+            if constexpr (Condition == MemorySearchCondition_Equal) {
+                return cur == value;
+            } else if constexpr (Condition == MemorySearchCondition_NotEqual) {
+                return cur != value;
+            } else if constexpr (Condition == MemorySearchCondition_InRange) {
+                return value <= cur && cur <= range_max;
+            } else if constexpr (Condition == MemorySearchCondition_Changed) {
+                return cur != prev;
+            } else if constexpr (Condition == MemorySearchCondition_Unchanged) {
+                return cur == prev;
+            } else if constexpr (Condition == MemorySearchCondition_Increased) {
+                return cur > prev;
+            } else if constexpr (Condition == MemorySearchCondition_Decreased) {
+                return cur < prev;
+            } else {
+                return true;
+            }
+        }
+
+        template<typename T, MemorySearchCondition Condition>
+        ALWAYS_INLINE u64 FilterBitmapWord(const T *current, const T *previous, T value, T range_max) {
+            u64 mask = 0;
+            for (size_t i = 0; i < ElementsPerBitmapWord; ++i) {
+                mask |= static_cast<u64>(IsMatch<T, Condition>(current[i], previous[i], value, range_max)) << i;
+            }
+            return mask;
+        }
+
+        #endif
+
+        template<typename T, MemorySearchCondition Condition>
+        void FilterChunkImpl(u64 *bitmap, const T *current, const T *previous, size_t num_elements, T value, T range_max, bool is_start) {
+            for (size_t i = 0; i < num_elements / ElementsPerBitmapWord; ++i) {
+                /* When narrowing, skip words which have no candidates left. */
+                if (!is_start && bitmap[i] == 0) {
+                    continue;
+                }
+
+                const u64 mask = FilterBitmapWord<T, Condition>(current + i * ElementsPerBitmapWord, previous + i * ElementsPerBitmapWord, value, range_max);
+                bitmap[i] = is_start ? mask : (bitmap[i] & mask);
+            }
+        }
+
+        template<typename T>
+        void FilterChunk(u64 *bitmap, const void *current, const void *previous, size_t num_elements, const MemorySearchParameters &params, bool is_start) {
+            const T *cur   = static_cast<const T *>(current);
+            const T *prev  = static_cast<const T *>(previous);
+            const T value     = static_cast<T>(params.value);
+            const T range_max = static_cast<T>(params.range_max);
+
+            switch (params.condition) {
+                case MemorySearchCondition_Any:       return FilterChunkImpl<T, MemorySearchCondition_Any>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_Equal:     return FilterChunkImpl<T, MemorySearchCondition_Equal>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_NotEqual:  return FilterChunkImpl<T, MemorySearchCondition_NotEqual>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_InRange:   return FilterChunkImpl<T, MemorySearchCondition_InRange>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_Changed:   return FilterChunkImpl<T, MemorySearchCondition_Changed>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_Unchanged: return FilterChunkImpl<T, MemorySearchCondition_Unchanged>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_Increased: return FilterChunkImpl<T, MemorySearchCondition_Increased>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                case MemorySearchCondition_Decreased: return FilterChunkImpl<T, MemorySearchCondition_Decreased>(bitmap, cur, prev, num_elements, value, range_max, is_start);
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+        void FilterChunk(u64 *bitmap, const void *current, const void *previous, size_t width, size_t num_elements, const MemorySearchParameters &params, bool is_start) {
+            switch (width) {
+                case sizeof(u8):  return FilterChunk<u8>(bitmap, current, previous, num_elements, params, is_start);
+                case sizeof(u16): return FilterChunk<u16>(bitmap, current, previous, num_elements, params, is_start);
+                case sizeof(u32): return FilterChunk<u32>(bitmap, current, previous, num_elements, params, is_start);
+                case sizeof(u64): return FilterChunk<u64>(bitmap, current, previous, num_elements, params, is_start);
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+    }
+
+    Result MemorySearcher::CollectRegions(IProcessMemoryAccessor &accessor) {
+        m_region_count     = 0;
+        m_value_file_count = 0;
+
+        /* Gather all writable memory, merging adjacent mappings. Regions are kept small enough for one snapshot file. */
+        svc::MemoryInfo mem_info;
+        u64 address = 0;
+        do {
+            if (R_FAILED(accessor.QueryMemory(std::addressof(mem_info), address))) {
+                break;
+            }
+
+            if (mem_info.permission == svc::MemoryPermission_ReadWrite) {
+                u64 cur_address = mem_info.base_address;
+                u64 remaining   = mem_info.size;
+                while (remaining > 0) {
+                    Region *last = m_region_count > 0 ? std::addressof(m_regions[m_region_count - 1]) : nullptr;
+                    if (last != nullptr && last->address + last->size == cur_address && last->size < SnapshotFileSize) {
+                        const u64 cur_size = std::min<u64>(remaining, SnapshotFileSize - last->size);
+                        last->size += cur_size;
+                        cur_address += cur_size;
+                        remaining   -= cur_size;
+                    } else {
+                        R_UNLESS(m_region_count < MaxRegionCount, dmnt::cheat::ResultMemorySearchOutOfResource());
+
+                        const u64 cur_size = std::min<u64>(remaining, SnapshotFileSize);
+                        m_regions[m_region_count++] = { .address = cur_address, .size = cur_size };
+                        cur_address += cur_size;
+                        remaining   -= cur_size;
+                    }
+                }
+            }
+
+            address = mem_info.base_address + mem_info.size;
+        } while (address != 0);
+
+        /* Lay out each region's portion of the bitmap and snapshot files. A region never straddles snapshot files. */
+        s64 bitmap_offset = 0;
+        s64 value_file_sizes[MaxSnapshotFileCount] = {};
+        size_t value_file_index = 0;
+        for (size_t i = 0; i < m_region_count; ++i) {
+            if (value_file_sizes[value_file_index] + m_regions[i].size > SnapshotFileSize) {
+                ++value_file_index;
+                R_UNLESS(value_file_index < MaxSnapshotFileCount, dmnt::cheat::ResultMemorySearchOutOfResource());
+            }
+
+            m_regions[i].bitmap_offset    = bitmap_offset;
+            m_regions[i].value_offset     = value_file_sizes[value_file_index];
+            m_regions[i].value_file_index = static_cast<s32>(value_file_index);
+            m_regions[i].candidate_count  = 0;
+
+            bitmap_offset                      += GetBitmapSize(m_regions[i].size / m_width);
+            value_file_sizes[value_file_index] += m_regions[i].size;
+        }
+
+        /* Create the files, removing any left over from a previous search. */
+        fs::EnsureDirectory(MemorySearchDirectoryPath);
+        fs::DeleteFile(CandidateBitmapFilePath);
+        for (size_t i = 0; i < MaxSnapshotFileCount; ++i) {
+            ValueSnapshotFilePath path(i);
+            fs::DeleteFile(path);
+        }
+
+        R_TRY(fs::CreateFile(CandidateBitmapFilePath, bitmap_offset));
+        m_value_file_count = m_region_count > 0 ? value_file_index + 1 : 0;
+        for (size_t i = 0; i < m_value_file_count; ++i) {
+            ValueSnapshotFilePath path(i);
+            R_TRY(fs::CreateFile(path, value_file_sizes[i]));
+        }
+
+        R_SUCCEED();
+    }
+
+    Result MemorySearcher::Scan(IProcessMemoryAccessor &accessor, const MemorySearchParameters &params, bool is_start) {
+        /* Open the candidate bitmap and value snapshots. */
+        fs::FileHandle bitmap_file;
+        R_TRY(fs::OpenFile(std::addressof(bitmap_file), CandidateBitmapFilePath, fs::OpenMode_ReadWrite));
+        ON_SCOPE_EXIT { fs::CloseFile(bitmap_file); };
+
+        ValueSnapshotFiles value_files;
+        R_TRY(value_files.Open(m_value_file_count, fs::OpenMode_ReadWrite));
+
+        const bool needs_previous = RequiresPreviousValue(params.condition);
+
+        u64 total_count = 0;
+        for (size_t i = 0; i < m_region_count; ++i) {
+            auto &region = m_regions[i];
+            const fs::FileHandle value_file = value_files.Get(region.value_file_index);
+
+            /* When narrowing, regions without candidates can't gain any. */
+            if (!is_start && region.candidate_count == 0) {
+                continue;
+            }
+
+            u64 region_count = 0;
+            for (u64 offset = 0; offset < region.size; offset += ChunkSize) {
+                const size_t cur_size      = std::min<u64>(ChunkSize, region.size - offset);
+                const size_t num_elements  = cur_size / m_width;
+                const size_t bitmap_size   = GetBitmapSize(num_elements);
+                const size_t num_words     = num_elements / ElementsPerBitmapWord;
+                const s64 bitmap_offset    = region.bitmap_offset + GetBitmapSize(offset / m_width);
+                const s64 value_offset     = region.value_offset + offset;
+
+                /* Get the candidates and previous values for this chunk, if we're narrowing. */
+                if (!is_start) {
+                    R_TRY(fs::ReadFile(bitmap_file, bitmap_offset, g_bitmap_buffer, bitmap_size));
+                    if (!HasCandidates(g_bitmap_buffer, num_words)) {
+                        continue;
+                    }
+
+                    if (needs_previous) {
+                        R_TRY(fs::ReadFile(value_file, value_offset, g_previous_buffer, cur_size));
+                    }
+                }
+
+                /* Read the current memory, and filter it. Memory we can't read can't match, but losing the process ends the search. */
+                if (const Result read_result = accessor.ReadMemory(g_current_buffer, region.address + offset, cur_size); R_SUCCEEDED(read_result)) {
+                    FilterChunk(g_bitmap_buffer, g_current_buffer, needs_previous ? g_previous_buffer : g_current_buffer, m_width, num_elements, params, is_start);
+                } else {
+                    R_UNLESS(!dmnt::cheat::ResultCheatNotAttached::Includes(read_result), read_result);
+                    std::memset(g_bitmap_buffer, 0, bitmap_size);
+                }
+
+                /* Save the updated candidates, and the values they need to be compared against next time. */
+                const u64 chunk_count = CountCandidates(g_bitmap_buffer, num_words);
+                R_TRY(fs::WriteFile(bitmap_file, bitmap_offset, g_bitmap_buffer, bitmap_size, fs::WriteOption::None));
+                if (chunk_count > 0) {
+                    R_TRY(fs::WriteFile(value_file, value_offset, g_current_buffer, cur_size, fs::WriteOption::None));
+                }
+
+                region_count += chunk_count;
+            }
+
+            region.candidate_count = region_count;
+            total_count += region_count;
+        }
+
+        R_TRY(fs::FlushFile(bitmap_file));
+        R_TRY(value_files.Flush());
+
+        m_candidate_count = total_count;
+        R_SUCCEED();
+    }
+
+    Result MemorySearcher::Start(u64 *out_count, IProcessMemoryAccessor &accessor, const MemorySearchParameters &params) {
+        /* Validate parameters. Conditions relative to a previous value need a previous search. */
+        R_UNLESS(IsValidWidth(params.width),                dmnt::cheat::ResultMemorySearchInvalidWidth());
+        R_UNLESS(IsValidCondition(params.condition),        dmnt::cheat::ResultMemorySearchInvalidCondition());
+        R_UNLESS(!RequiresPreviousValue(params.condition),  dmnt::cheat::ResultMemorySearchInvalidCondition());
+
+        /* Discard any previous search. */
+        this->End();
+
+        /* Set up the new search, removing its files if it can't be completed. */
+        ON_RESULT_FAILURE { this->End(); };
+        m_width = params.width;
+        R_TRY(this->CollectRegions(accessor));
+
+        /* Perform the initial scan. */
+        R_TRY(this->Scan(accessor, params, true));
+        m_is_started = true;
+
+        *out_count = m_candidate_count;
+        R_SUCCEED();
+    }
+
+    Result MemorySearcher::Narrow(u64 *out_count, IProcessMemoryAccessor &accessor, const MemorySearchParameters &params) {
+        /* Validate parameters. */
+        R_UNLESS(m_is_started,                         dmnt::cheat::ResultMemorySearchNotStarted());
+        R_UNLESS(params.width == m_width,              dmnt::cheat::ResultMemorySearchInvalidWidth());
+        R_UNLESS(IsValidCondition(params.condition),   dmnt::cheat::ResultMemorySearchInvalidCondition());
+
+        /* Narrow the candidates. If this fails partway through, our files are inconsistent, so end the search. */
+        {
+            auto search_guard = SCOPE_GUARD { this->End(); };
+            R_TRY(this->Scan(accessor, params, false));
+            search_guard.Cancel();
+        }
+
+        *out_count = m_candidate_count;
+        R_SUCCEED();
+    }
+
+    Result MemorySearcher::GetResults(MemorySearchResult *out_results, size_t max_count, u64 *out_count, u64 offset) {
+        R_UNLESS(m_is_started, dmnt::cheat::ResultMemorySearchNotStarted());
+
+        fs::FileHandle bitmap_file;
+        R_TRY(fs::OpenFile(std::addressof(bitmap_file), CandidateBitmapFilePath, fs::OpenMode_Read));
+        ON_SCOPE_EXIT { fs::CloseFile(bitmap_file); };
+
+        ValueSnapshotFiles value_files;
+        R_TRY(value_files.Open(m_value_file_count, fs::OpenMode_Read));
+
+        u64 index = 0, written_count = 0;
+        for (size_t i = 0; i < m_region_count && written_count < max_count; ++i) {
+            const auto &region = m_regions[i];
+
+            /* Skip regions entirely before the requested offset. */
+            if (index + region.candidate_count <= offset) {
+                index += region.candidate_count;
+                continue;
+            }
+
+            for (u64 chunk_offset = 0; chunk_offset < region.size && written_count < max_count; chunk_offset += ChunkSize) {
+                const size_t cur_size     = std::min<u64>(ChunkSize, region.size - chunk_offset);
+                const size_t num_elements = cur_size / m_width;
+                const size_t num_words    = num_elements / ElementsPerBitmapWord;
+
+                R_TRY(fs::ReadFile(bitmap_file, region.bitmap_offset + GetBitmapSize(chunk_offset / m_width), g_bitmap_buffer, GetBitmapSize(num_elements)));
+
+                /* Skip chunks entirely before the requested offset. */
+                const u64 chunk_count = CountCandidates(g_bitmap_buffer, num_words);
+                if (index + chunk_count <= offset) {
+                    index += chunk_count;
+                    continue;
+                }
+
+                R_TRY(fs::ReadFile(value_files.Get(region.value_file_index), region.value_offset + chunk_offset, g_current_buffer, cur_size));
+
+                for (size_t w = 0; w < num_words && written_count < max_count; ++w) {
+                    for (u64 bits = g_bitmap_buffer[w]; bits != 0 && written_count < max_count; bits &= (bits - 1)) {
+                        if (index++ < offset) {
+                            continue;
+                        }
+
+                        const size_t element = w * ElementsPerBitmapWord + util::CountTrailingZeros(bits);
+
+                        auto &result = out_results[written_count++];
+                        result.address = region.address + chunk_offset + element * m_width;
+                        result.value   = 0;
+                        std::memcpy(std::addressof(result.value), g_current_buffer + element * m_width, m_width);
+                    }
+                }
+            }
+        }
+
+        *out_count = written_count;
+        R_SUCCEED();
+    }
+
+    void MemorySearcher::End() {
+        /* A search which has been set up has files, even if it was never started. */
+        if (m_width != 0) {
+            fs::DeleteFile(CandidateBitmapFilePath);
+            for (size_t i = 0; i < m_value_file_count; ++i) {
+                ValueSnapshotFilePath path(i);
+                fs::DeleteFile(path);
+            }
+        }
+
+        m_region_count     = 0;
+        m_value_file_count = 0;
+        m_width            = 0;
+        m_candidate_count = 0;
+        m_is_started      = false;
+    }
+
+}
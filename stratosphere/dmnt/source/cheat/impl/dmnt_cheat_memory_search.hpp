@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::dmnt::cheat::impl {
+
+    /* Searches the writable memory of the cheat process for values matching a condition, and then narrows down the candidates. */
+    /* The candidate bitmap and a snapshot of the values are kept on the sd card, as they scale with the size of the process' memory. */
+    /* The snapshot is split across files, as the sd card may be FAT32, which limits files to 4 GB. */
+    class MemorySearcher {
+        NON_COPYABLE(MemorySearcher);
+        NON_MOVEABLE(MemorySearcher);
+        public:
+            static constexpr size_t MaxRegionCount       = 0x200;
+            static constexpr size_t ChunkSize            = 32_KB;
+            static constexpr size_t SnapshotFileSize     = 2_GB;
+            static constexpr size_t MaxSnapshotFileCount = 4;
+        public:
+            /* Accesses the searched process' memory; a search doesn't otherwise synchronize with the process' owner. */
+            class IProcessMemoryAccessor {
+                public:
+                    virtual ~IProcessMemoryAccessor() { /* ... */ }
+
+                    virtual Result QueryMemory(svc::MemoryInfo *out, u64 address) = 0;
+                    virtual Result ReadMemory(void *dst, u64 address, size_t size) = 0;
+            };
+        private:
+            struct Region {
+                u64 address;
+                u64 size;
+                s64 bitmap_offset;
+                s64 value_offset;
+                s32 value_file_index;
+                u64 candidate_count;
+            };
+        private:
+            Region m_regions[MaxRegionCount];
+            size_t m_region_count;
+            size_t m_value_file_count;
+            size_t m_width;
+            u64 m_candidate_count;
+            bool m_is_started;
+        public:
+            constexpr MemorySearcher() : m_regions(), m_region_count(0), m_value_file_count(0), m_width(0), m_candidate_count(0), m_is_started(false) { /* ... */ }
+
+            Result Start(u64 *out_count, IProcessMemoryAccessor &accessor, const MemorySearchParameters &params);
+            Result Narrow(u64 *out_count, IProcessMemoryAccessor &accessor, const MemorySearchParameters &params);
+            Result GetResults(MemorySearchResult *out_results, size_t max_count, u64 *out_count, u64 offset);
+            void End();
+        private:
+            Result CollectRegions(IProcessMemoryAccessor &accessor);
+            Result Scan(IProcessMemoryAccessor &accessor, const MemorySearchParameters &params, bool is_start);
+    };
+
+}
@@ -693,31 +693,82 @@ namespace ams::dmnt::cheat::impl {
         return valid;
     }
 
-    void CheatVirtualMachine::SkipConditionalBlock(bool is_if) {
-        if (m_condition_depth > 0) {
-            /* We want to continue until we're out of the current block. */
-            const size_t desired_depth = m_condition_depth - 1;
+    void CheatVirtualMachine::CompileProgram() {
+        /* Decode the whole program once, so that execution doesn't need to parse it every frame. */
+        m_num_instructions = 0;
+        m_instruction_ptr  = 0;
+        m_decode_success   = true;
+
+        /* Decode until we hit the end of the program, or an instruction that can't be decoded. */
+        /* Nothing past a decode failure is reachable, so execution can simply stop there. */
+        while (true) {
+            const size_t offset = m_instruction_ptr;
+
+            CheatVmOpcode opcode;
+            if (!this->DecodeNextOpcode(std::addressof(opcode))) {
+                break;
+            }
+
+            /* Every instruction is at least one dword, so this can't overflow. */
+            auto &instruction = m_instructions[m_num_instructions++];
+            instruction.opcode           = opcode;
+            instruction.offset           = static_cast<u16>(offset);
+            instruction.skip_target      = 0;
+            instruction.skip_exits_block = false;
+        }
+
+        /* Resolve where execution continues when a conditional block is skipped. */
+        for (size_t i = 0; i < m_num_instructions; i++) {
+            auto &instruction = m_instructions[i];
+
+            const bool is_if   = instruction.opcode.begin_conditional_block;
+            const bool is_else = instruction.opcode.opcode == CheatVmOpcodeType_EndConditionalBlock && instruction.opcode.end_cond.is_else;
+            if (!is_if && !is_else) {
+                continue;
+            }
+
+            /* If we never find the end of the block, skipping it ends execution. */
+            instruction.skip_target      = static_cast<u16>(m_num_instructions);
+            instruction.skip_exits_block = true;
 
-            CheatVmOpcode skip_opcode;
-            while (m_condition_depth > desired_depth && this->DecodeNextOpcode(std::addressof(skip_opcode))) {
-                /* Decode instructions until we see end of the current conditional block. */
+            size_t depth = 1;
+            for (size_t n = i + 1; n < m_num_instructions; n++) {
+                /* Walk decoded instructions until we see end of the current conditional block. */
                 /* NOTE: This is broken in gateway's implementation. */
                 /* Gateway currently checks for "0x2" instead of "0x20000000" */
                 /* In addition, they do a linear scan instead of correctly decoding opcodes. */
                 /* This causes issues if "0x2" appears as an immediate in the conditional block... */
 
                 /* We also support nesting of conditional blocks, and Gateway does not. */
+                const auto &skip_opcode = m_instructions[n].opcode;
                 if (skip_opcode.begin_conditional_block) {
-                    m_condition_depth++;
+                    depth++;
                 } else if (skip_opcode.opcode == CheatVmOpcodeType_EndConditionalBlock) {
                     if (!skip_opcode.end_cond.is_else) {
-                        m_condition_depth--;
-                    } else if (is_if && m_condition_depth - 1 == desired_depth) {
+                        if ((--depth) == 0) {
+                            instruction.skip_target = static_cast<u16>(n + 1);
+                            break;
+                        }
+                    } else if (is_if && depth == 1) {
                         /* An if will continue to an else at the same depth. */
+                        instruction.skip_target      = static_cast<u16>(n + 1);
+                        instruction.skip_exits_block = false;
                         break;
                     }
                 }
             }
+        }
+
+        m_instruction_ptr = 0;
+    }
+
+    void CheatVirtualMachine::SkipConditionalBlock(const CheatVmInstruction &instruction) {
+        if (m_condition_depth > 0) {
+            /* Jump past the current block (or into its else), as resolved when the program was compiled. */
+            m_instruction_ptr = instruction.skip_target;
+            if (instruction.skip_exits_block) {
+                m_condition_depth--;
+            }
         } else {
             /* Skipping, but m_condition_depth = 0. */
             /* This is an error condition. */
@@ -769,6 +820,152 @@ namespace ams::dmnt::cheat::impl {
         m_decode_success = true;
     }
 
+    CheatVirtualMachine::MemoryCachePage *CheatVirtualMachine::FindMemoryCachePage(u64 page_address) {
+        for (auto &page : m_memory_cache) {
+            if (page.in_use && page.address == page_address) {
+                page.last_used = ++m_memory_cache_tick;
+                return std::addressof(page);
+            }
+        }
+
+        return nullptr;
+    }
+
+    CheatVirtualMachine::MemoryCachePage *CheatVirtualMachine::AcquireMemoryCachePage(u64 page_address) {
+        /* If we already have the page, use it. */
+        if (auto *page = this->FindMemoryCachePage(page_address); page != nullptr) {
+            return page;
+        }
+
+        /* Otherwise, take a free page, or evict the least recently used one. */
+        MemoryCachePage *victim = nullptr;
+        for (auto &page : m_memory_cache) {
+            if (!page.in_use) {
+                victim = std::addressof(page);
+                break;
+            }
+
+            if (victim == nullptr || page.last_used < victim->last_used) {
+                victim = std::addressof(page);
+            }
+        }
+
+        this->FlushMemoryCachePage(victim);
+
+        victim->address   = page_address;
+        victim->last_used = ++m_memory_cache_tick;
+        victim->in_use    = true;
+        victim->has_data  = false;
+        return victim;
+    }
+
+    void CheatVirtualMachine::FlushMemoryCachePage(MemoryCachePage *page) {
+        if (!page->has_dirty) {
+            return;
+        }
+
+        /* Write back each run of dirty bytes with a single write. */
+        /* We don't write back bytes we didn't store to, as the process may have modified them since we read the page. */
+        auto IsDirty = [page](size_t i) ALWAYS_INLINE_LAMBDA { return (page->dirty_mask[i / BITSIZEOF(u64)] & (1ul << (i % BITSIZEOF(u64)))) != 0; };
+
+        size_t i = 0;
+        while (i < os::MemoryPageSize) {
+            if (page->dirty_mask[i / BITSIZEOF(u64)] == 0) {
+                i = util::AlignDown(i, BITSIZEOF(u64)) + BITSIZEOF(u64);
+                continue;
+            }
+
+            if (!IsDirty(i)) {
+                i++;
+                continue;
+            }
+
+            size_t end = i + 1;
+            while (end < os::MemoryPageSize && IsDirty(end)) {
+                end++;
+            }
+
+            dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(page->address + i, page->data + i, end - i);
+            i = end;
+        }
+
+        std::memset(page->dirty_mask, 0, sizeof(page->dirty_mask));
+        page->has_dirty = false;
+    }
+
+    void CheatVirtualMachine::InvalidateMemoryCache() {
+        for (auto &page : m_memory_cache) {
+            if (page.in_use) {
+                this->FlushMemoryCachePage(std::addressof(page));
+                page.in_use = false;
+            }
+        }
+    }
+
+    void CheatVirtualMachine::ReadProcessMemory(u64 address, void *out, size_t size) {
+        const u64 page_address = util::AlignDown(address, os::MemoryPageSize);
+
+        /* Accesses which span pages are rare, so write back anything pending for them and access the process directly. */
+        if (page_address != util::AlignDown(address + size - 1, os::MemoryPageSize)) {
+            for (const u64 cur_address : { page_address, page_address + os::MemoryPageSize }) {
+                if (auto *page = this->FindMemoryCachePage(cur_address); page != nullptr) {
+                    this->FlushMemoryCachePage(page);
+                }
+            }
+
+            dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(address, out, size);
+            return;
+        }
+
+        /* Get the page, reading it in if we don't have its contents yet. */
+        auto *page = this->AcquireMemoryCachePage(page_address);
+        if (!page->has_data) {
+            /* Write back any stores we have pending to the page first, so that we observe them. */
+            this->FlushMemoryCachePage(page);
+
+            if (R_FAILED(dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(page_address, page->data, sizeof(page->data)))) {
+                /* We couldn't read the whole page, so just try to read what we were asked for. */
+                page->in_use = false;
+                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(address, out, size);
+                return;
+            }
+
+            page->has_data = true;
+        }
+
+        std::memcpy(out, page->data + (address - page_address), size);
+    }
+
+    void CheatVirtualMachine::WriteProcessMemory(u64 address, const void *data, size_t size) {
+        const u64 page_address = util::AlignDown(address, os::MemoryPageSize);
+
+        /* Accesses which span pages are rare, so write back and drop anything we have for them and access the process directly. */
+        if (page_address != util::AlignDown(address + size - 1, os::MemoryPageSize)) {
+            for (const u64 cur_address : { page_address, page_address + os::MemoryPageSize }) {
+                if (auto *page = this->FindMemoryCachePage(cur_address); page != nullptr) {
+                    this->FlushMemoryCachePage(page);
+                    page->in_use = false;
+                }
+            }
+
+            u8 buffer[sizeof(u64)];
+            AMS_ASSERT(size <= sizeof(buffer));
+            std::memcpy(buffer, data, size);
+            dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(address, buffer, size);
+            return;
+        }
+
+        /* Store into the page, and remember which bytes we need to write back. */
+        auto *page = this->AcquireMemoryCachePage(page_address);
+
+        const size_t offset = address - page_address;
+        std::memcpy(page->data + offset, data, size);
+        for (size_t i = offset; i < offset + size; i++) {
+            page->dirty_mask[i / BITSIZEOF(u64)] |= (1ul << (i % BITSIZEOF(u64)));
+        }
+        page->has_dirty = true;
+    }
+
     bool CheatVirtualMachine::LoadProgram(const CheatEntry *cheats, size_t num_cheats) {
         /* Reset opcode count. */
         m_num_opcodes = 0;
@@ -778,6 +975,7 @@ namespace ams::dmnt::cheat::impl {
                 /* Bounds check. */
                 if (cheats[i].definition.num_opcodes + m_num_opcodes > MaximumProgramOpcodeCount) {
                     m_num_opcodes = 0;
+                    this->CompileProgram();
                     return false;
                 }
 
@@ -787,12 +985,14 @@ namespace ams::dmnt::cheat::impl {
             }
         }
 
+        /* Lower the program into pre-decoded instructions. */
+        this->CompileProgram();
+
         return true;
     }
 
     static u64 s_keyold = 0;
     void CheatVirtualMachine::Execute(const CheatProcessMetadata *metadata) {
-        CheatVmOpcode cur_opcode;
         u64 kHeld = 0;
 
         /* Get Keys held. */
@@ -809,9 +1009,15 @@ namespace ams::dmnt::cheat::impl {
         /* Clear VM state. */
         this->ResetState();
 
+        /* Write back any stores we batched once the program finishes. */
+        ON_SCOPE_EXIT { this->InvalidateMemoryCache(); };
+
         /* Loop until program finishes. */
-        while (this->DecodeNextOpcode(std::addressof(cur_opcode))) {
-            this->LogToDebugFile("Instruction Ptr: %04x\n", (u32)m_instruction_ptr);
+        while (m_instruction_ptr < m_num_instructions) {
+            const CheatVmInstruction &cur_instruction = m_instructions[m_instruction_ptr++];
+            const CheatVmOpcode &cur_opcode = cur_instruction.opcode;
+
+            this->LogToDebugFile("Instruction Ptr: %04x\n", (u32)cur_instruction.offset);
 
             for (size_t i = 0; i < NumRegisters; i++) {
                 this->LogToDebugFile("Registers[%02x]: %016lx\n", i, m_registers[i]);
@@ -838,7 +1044,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, std::addressof(dst_value), cur_opcode.store_static.bit_width);
+                                this->WriteProcessMemory(dst_address, std::addressof(dst_value), cur_opcode.store_static.bit_width);
                                 break;
                         }
                     }
@@ -853,7 +1059,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, std::addressof(src_value), cur_opcode.begin_cond.bit_width);
+                                this->ReadProcessMemory(src_address, std::addressof(src_value), cur_opcode.begin_cond.bit_width);
                                 break;
                         }
                         /* Check against condition. */
@@ -881,14 +1087,14 @@ namespace ams::dmnt::cheat::impl {
                         }
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock(true);
+                            this->SkipConditionalBlock(cur_instruction);
                         }
                     }
                     break;
                 case CheatVmOpcodeType_EndConditionalBlock:
                     if (cur_opcode.end_cond.is_else) {
                         /* Skip to the end of the conditional block. */
-                        this->SkipConditionalBlock(false);
+                        this->SkipConditionalBlock(cur_instruction);
                     } else {
                         /* Decrement the condition depth. */
                         /* We will assume, graciously, that mismatched conditional block ends are a nop. */
@@ -933,7 +1139,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, std::addressof(m_registers[cur_opcode.ldr_memory.reg_index]), cur_opcode.ldr_memory.bit_width);
+                                this->ReadProcessMemory(src_address, std::addressof(m_registers[cur_opcode.ldr_memory.reg_index]), cur_opcode.ldr_memory.bit_width);
                                 break;
                         }
                     }
@@ -952,7 +1158,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, std::addressof(dst_value), cur_opcode.str_static.bit_width);
+                                this->WriteProcessMemory(dst_address, std::addressof(dst_value), cur_opcode.str_static.bit_width);
                                 break;
                         }
                         /* Increment register if relevant. */
@@ -1005,7 +1211,7 @@ namespace ams::dmnt::cheat::impl {
                     /* Check for keypress. */
                     if ((cur_opcode.begin_keypress_cond.key_mask & kHeld) != cur_opcode.begin_keypress_cond.key_mask) {
                         /* Keys not pressed. Skip conditional block. */
-                        this->SkipConditionalBlock(true);
+                        this->SkipConditionalBlock(cur_instruction);
                     }
                     break;
                 case CheatVmOpcodeType_BeginExtendedKeypressConditionalBlock:
@@ -1013,11 +1219,11 @@ namespace ams::dmnt::cheat::impl {
                     if (!cur_opcode.begin_ext_keypress_cond.auto_repeat) {
                         if ((cur_opcode.begin_ext_keypress_cond.key_mask & kHeld) != (cur_opcode.begin_ext_keypress_cond.key_mask) || (cur_opcode.begin_ext_keypress_cond.key_mask & s_keyold) == (cur_opcode.begin_ext_keypress_cond.key_mask)) {
                             /* Keys not pressed. Skip conditional block. */
-                            this->SkipConditionalBlock(true);
+                            this->SkipConditionalBlock(cur_instruction);
                         }
                     } else if ((cur_opcode.begin_ext_keypress_cond.key_mask & kHeld) != cur_opcode.begin_ext_keypress_cond.key_mask) {
                         /* Keys not pressed. Skip conditional block. */
-                        this->SkipConditionalBlock(true);
+                        this->SkipConditionalBlock(cur_instruction);
                     }
                     break;
                 case CheatVmOpcodeType_PerformArithmeticRegister:
@@ -1143,7 +1349,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, std::addressof(dst_value), cur_opcode.str_register.bit_width);
+                                this->WriteProcessMemory(dst_address, std::addressof(dst_value), cur_opcode.str_register.bit_width);
                                 break;
                         }
 
@@ -1214,7 +1420,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(cond_address, std::addressof(cond_value), cur_opcode.begin_reg_cond.bit_width);
+                                    this->ReadProcessMemory(cond_address, std::addressof(cond_value), cur_opcode.begin_reg_cond.bit_width);
                                     break;
                             }
                         }
@@ -1244,7 +1450,7 @@ namespace ams::dmnt::cheat::impl {
 
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock(true);
+                            this->SkipConditionalBlock(cur_instruction);
                         }
                     }
                     break;
@@ -1309,9 +1515,13 @@ namespace ams::dmnt::cheat::impl {
                     }
                     break;
                 case CheatVmOpcodeType_PauseProcess:
+                    /* Make sure our stores land before pausing, and re-read anything we need afterwards. */
+                    this->InvalidateMemoryCache();
                     dmnt::cheat::impl::PauseCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_ResumeProcess:
+                    /* Make sure our stores land while the process is still paused. */
+                    this->InvalidateMemoryCache();
                     dmnt::cheat::impl::ResumeCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_DebugLog:
@@ -1356,7 +1566,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(val_address, std::addressof(log_value), cur_opcode.debug_log.bit_width);
+                                    this->ReadProcessMemory(val_address, std::addressof(log_value), cur_opcode.debug_log.bit_width);
                                     break;
                             }
                         }
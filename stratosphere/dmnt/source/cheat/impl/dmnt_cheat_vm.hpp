@@ -284,6 +284,13 @@ namespace ams::dmnt::cheat::impl {
         };
     };
 
+    struct CheatVmInstruction {
+        CheatVmOpcode opcode;
+        u16 offset;
+        u16 skip_target;
+        bool skip_exits_block;
+    };
+
     class CheatVirtualMachine {
         public:
             constexpr static size_t MaximumProgramOpcodeCount = 0x400;
@@ -291,21 +298,45 @@ namespace ams::dmnt::cheat::impl {
             constexpr static size_t NumReadableStaticRegisters = 0x80;
             constexpr static size_t NumWritableStaticRegisters = 0x80;
             constexpr static size_t NumStaticRegisters = NumReadableStaticRegisters + NumWritableStaticRegisters;
+            constexpr static size_t NumMemoryCachePages = 8;
+        private:
+            struct MemoryCachePage {
+                u64 address;
+                u64 last_used;
+                bool in_use;
+                bool has_data;
+                bool has_dirty;
+                u64 dirty_mask[os::MemoryPageSize / BITSIZEOF(u64)];
+                u8 data[os::MemoryPageSize];
+            };
         private:
             size_t m_num_opcodes = 0;
+            size_t m_num_instructions = 0;
             size_t m_instruction_ptr = 0;
             size_t m_condition_depth = 0;
             bool m_decode_success = false;
             u32 m_program[MaximumProgramOpcodeCount] = {0};
+            CheatVmInstruction m_instructions[MaximumProgramOpcodeCount] = {};
             u64 m_registers[NumRegisters] = {0};
             u64 m_saved_values[NumRegisters] = {0};
             u64 m_static_registers[NumStaticRegisters] = {0};
             size_t m_loop_tops[NumRegisters] = {0};
+            MemoryCachePage m_memory_cache[NumMemoryCachePages] = {};
+            u64 m_memory_cache_tick = 0;
         private:
             bool DecodeNextOpcode(CheatVmOpcode *out);
-            void SkipConditionalBlock(bool is_if);
+            void CompileProgram();
+            void SkipConditionalBlock(const CheatVmInstruction &instruction);
             void ResetState();
 
+            /* Process memory accesses made by the program are batched per page, and written back when execution finishes. */
+            void ReadProcessMemory(u64 address, void *out, size_t size);
+            void WriteProcessMemory(u64 address, const void *data, size_t size);
+            MemoryCachePage *FindMemoryCachePage(u64 page_address);
+            MemoryCachePage *AcquireMemoryCachePage(u64 page_address);
+            void FlushMemoryCachePage(MemoryCachePage *page);
+            void InvalidateMemoryCache();
+
             /* For implementing the DebugLog opcode. */
             void DebugLog(u32 log_id, u64 value);
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+#define AMS_TEST_I_TEST_SERVICE_INTERFACE_INFO(C, H)                                                                                      \
+    AMS_SF_METHOD_INFO(C, H, 0, Result, Add,     (ams::sf::Out<u32> out, u32 lhs, u32 rhs),                                (out, lhs, rhs)) \
+    AMS_SF_METHOD_INFO(C, H, 1, Result, Reverse, (const ams::sf::OutPointerBuffer &out, const ams::sf::InPointerBuffer &in), (out, in))
+
+AMS_SF_DEFINE_INTERFACE(ams::test, ITestService, AMS_TEST_I_TEST_SERVICE_INTERFACE_INFO, 0x00000000);
+
+namespace ams {
+
+    namespace test {
+
+        class TestService {
+            public:
+                Result Add(sf::Out<u32> out, u32 lhs, u32 rhs) {
+                    *out = lhs + rhs;
+                    R_SUCCEED();
+                }
+
+                Result Reverse(const sf::OutPointerBuffer &out, const sf::InPointerBuffer &in) {
+                    R_UNLESS(out.GetSize() >= in.GetSize(), sf::ResultNotSupported());
+
+                    for (size_t i = 0; i < in.GetSize(); ++i) {
+                        out.GetPointer()[i] = in.GetPointer()[in.GetSize() - 1 - i];
+                    }
+                    R_SUCCEED();
+                }
+        };
+        static_assert(IsITestService<TestService>);
+
+    }
+
+    namespace {
+
+        struct ServerOptions {
+            static constexpr size_t PointerBufferSize   = 0x100;
+            static constexpr size_t MaxDomains          = 0;
+            static constexpr size_t MaxDomainObjects    = 0;
+            static constexpr bool CanDeferInvokeRequest = false;
+            static constexpr bool CanManageMitmServers  = false;
+        };
+
+        constexpr u32 CmifInHeaderMagic  = util::FourCC<'S','F','C','I'>::Code;
+        constexpr u32 CmifOutHeaderMagic = util::FourCC<'S','F','C','O'>::Code;
+
+        constinit sf::UnmanagedServiceObject<test::ITestService, test::TestService> g_test_service;
+
+        sf::hipc::ServerManager<0, ServerOptions, 1> g_server_manager;
+
+        alignas(os::ThreadStackAlignment) constinit u8 g_server_thread_stack[16_KB];
+        constinit os::ThreadType g_server_thread;
+
+        void ServerThreadFunction(void *) {
+            g_server_manager.LoopProcess();
+        }
+
+        /* Builds a cmif request with an in pointer and an unfixed-size out pointer, and returns where its raw data goes. */
+        void *MakeRequest(void *message, u32 command_id, size_t data_size, const void *in_ptr, size_t in_size, void *out_ptr, size_t out_size) {
+            const bool has_pointers = in_ptr != nullptr;
+
+            /* Raw data is 0x10 of alignment padding, the header, the data, then the out pointer sizes. */
+            const size_t out_pointer_sizes_offset = util::AlignUp(0x10 + sizeof(CmifInHeader) + data_size, alignof(u16));
+            const size_t raw_size                 = out_pointer_sizes_offset + (has_pointers ? sizeof(u16) : 0);
+
+            const auto request = hipcMakeRequestInline(message,
+                .type             = CmifCommandType_Request,
+                .num_send_statics = has_pointers ? 1u : 0u,
+                .num_data_words   = static_cast<u32>(util::DivideUp(raw_size, sizeof(u32))),
+                .num_recv_statics = has_pointers ? 1u : 0u,
+            );
+
+            if (has_pointers) {
+                request.send_statics[0] = hipcMakeSendStatic(in_ptr, in_size, 0);
+                request.recv_list[0]    = hipcMakeRecvStatic(out_ptr, out_size);
+
+                const u16 out_size16 = static_cast<u16>(out_size);
+                std::memcpy(reinterpret_cast<u8 *>(request.data_words) + out_pointer_sizes_offset, std::addressof(out_size16), sizeof(out_size16));
+            }
+
+            auto *header = reinterpret_cast<CmifInHeader *>(util::AlignUp(reinterpret_cast<uintptr_t>(request.data_words), 0x10));
+            *header = { .magic = CmifInHeaderMagic, .version = 0, .command_id = command_id, .token = 0 };
+
+            return header + 1;
+        }
+
+        Result GetResponse(const void **out_data, void *message) {
+            const auto response = hipcParseResponse(message);
+
+            const auto *header = reinterpret_cast<const CmifOutHeader *>(util::AlignUp(reinterpret_cast<uintptr_t>(response.data_words), 0x10));
+            AMS_ABORT_UNLESS(header->magic == CmifOutHeaderMagic);
+
+            *out_data = header + 1;
+            R_RETURN(header->result);
+        }
+
+    }
+
+    void Main() {
+        printf("Testing hipc server round trips\n");
+
+        /* Create a session, and serve it from a separate thread. */
+        os::NativeHandle server_handle, client_handle;
+        R_ABORT_UNLESS(sf::hipc::CreateSession(std::addressof(server_handle), std::addressof(client_handle)));
+        R_ABORT_UNLESS(g_server_manager.RegisterSession(server_handle, sf::cmif::ServiceObjectHolder(g_test_service.GetShared())));
+
+        R_ABORT_UNLESS(os::CreateThread(std::addressof(g_server_thread), ServerThreadFunction, nullptr, g_server_thread_stack, sizeof(g_server_thread_stack), os::DefaultThreadPriority));
+        os::StartThread(std::addressof(g_server_thread));
+
+        /* Messages and pointer buffers live on our stack, which is typically well above the 42 bits a static descriptor encodes on hardware. */
+        alignas(0x10) u8 message[0x100];
+        const sf::cmif::PointerAndSize message_buffer(message, sizeof(message));
+
+        /* Verify that raw data round trips. */
+        for (u32 i = 0; i < 100; ++i) {
+            const u32 args[2] = { i, 2 * i + 1 };
+            std::memcpy(MakeRequest(message, 0, sizeof(args), nullptr, 0, nullptr, 0), args, sizeof(args));
+            R_ABORT_UNLESS(sf::hipc::SendSyncRequest(client_handle, message_buffer));
+
+            const void *data;
+            R_ABORT_UNLESS(GetResponse(std::addressof(data), message));
+
+            u32 sum;
+            std::memcpy(std::addressof(sum), data, sizeof(sum));
+            AMS_ABORT_UNLESS(sum == 3 * i + 1);
+        }
+
+        /* Verify that pointer buffers round trip through the server's pointer buffer. */
+        {
+            char in[] = "stratosphere";
+            char out[0x20] = {};
+            MakeRequest(message, 1, 0, in, sizeof(in) - 1, out, sizeof(out));
+            R_ABORT_UNLESS(sf::hipc::SendSyncRequest(client_handle, message_buffer));
+
+            const void *data;
+            R_ABORT_UNLESS(GetResponse(std::addressof(data), message));
+            AMS_ABORT_UNLESS(std::memcmp(out, "erehpsotarts", sizeof(in) - 1) == 0);
+        }
+
+        /* Verify that a pointer which doesn't fit in the server's pointer buffer fails the request, without affecting the session. */
+        {
+            u8 in[ServerOptions::PointerBufferSize * 2] = {};
+            u8 out[0x10];
+            MakeRequest(message, 1, 0, in, sizeof(in), out, sizeof(out));
+            AMS_ABORT_UNLESS(svc::ResultReceiveListBroken::Includes(sf::hipc::SendSyncRequest(client_handle, message_buffer)));
+
+            const u32 args[2] = { 1, 2 };
+            std::memcpy(MakeRequest(message, 0, sizeof(args), nullptr, 0, nullptr, 0), args, sizeof(args));
+            R_ABORT_UNLESS(sf::hipc::SendSyncRequest(client_handle, message_buffer));
+
+            const void *data;
+            R_ABORT_UNLESS(GetResponse(std::addressof(data), message));
+        }
+
+        /* Stop the server. */
+        g_server_manager.RequestStopProcessing();
+        os::WaitThread(std::addressof(g_server_thread));
+        os::DestroyThread(std::addressof(g_server_thread));
+
+        os::CloseNativeHandle(client_handle);
+
+        printf("All tests completed!\n");
+    }
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams {
+
+    namespace {
+
+        constexpr size_t HeapSize       = 8_MB;
+        constexpr size_t MaxLiveBlocks  = 0x2000;
+        constexpr size_t IterationCount = 500000;
+
+        alignas(os::MemoryPageSize) constinit u8 g_heap_memory[HeapSize];
+
+        constinit void *g_live_blocks[MaxLiveBlocks];
+
+        /* Simple deterministic generator, so that every mode sees the same sequence of operations. */
+        class Random {
+            private:
+                u64 m_state;
+            public:
+                constexpr explicit Random(u64 seed) : m_state(seed) { /* ... */ }
+
+                u32 Next() {
+                    m_state ^= m_state << 13;
+                    m_state ^= m_state >> 7;
+                    m_state ^= m_state << 17;
+                    return static_cast<u32>(m_state);
+                }
+        };
+
+        size_t GetRandomSize(Random &rng) {
+            /* Mostly small allocations, with an occasional large one. */
+            switch (rng.Next() % 8) {
+                case 0:  return 0x400 + rng.Next() % 0x4000;
+                case 1:
+                case 2:  return 0x80 + rng.Next() % 0x380;
+                default: return 1 + rng.Next() % 0x80;
+            }
+        }
+
+        s32 GetRandomAlignment(Random &rng) {
+            const s32 alignment = (rng.Next() % 4 == 0) ? 0x40 : 0x8;
+            return (rng.Next() % 8 == 0) ? -alignment : alignment;
+        }
+
+        void RunBenchmark(const char *name, lmem::AllocationMode mode) {
+            /* Create the heap. */
+            lmem::HeapHandle heap = lmem::CreateExpHeap(g_heap_memory, sizeof(g_heap_memory), lmem::CreateOption_None);
+            AMS_ABORT_UNLESS(heap != nullptr);
+            ON_SCOPE_EXIT { lmem::DestroyExpHeap(heap); };
+
+            const size_t initial_free_size = lmem::GetExpHeapTotalFreeSize(heap);
+
+            /* Set the allocation mode. */
+            lmem::SetExpHeapAllocationMode(heap, mode);
+            AMS_ABORT_UNLESS(lmem::GetExpHeapAllocationMode(heap) == mode);
+
+            Random rng(0x0123456789ABCDEF);
+            size_t live_count = 0;
+
+            /* Fragment the heap, by filling it and then freeing every other block. */
+            while (live_count < MaxLiveBlocks) {
+                void *block = lmem::AllocateFromExpHeap(heap, GetRandomSize(rng), GetRandomAlignment(rng));
+                if (block == nullptr) {
+                    break;
+                }
+                g_live_blocks[live_count++] = block;
+            }
+            for (size_t i = 0; i < live_count / 2; ++i) {
+                lmem::FreeToExpHeap(heap, g_live_blocks[i]);
+                g_live_blocks[i] = g_live_blocks[--live_count];
+            }
+
+            /* Randomly allocate and free. */
+            size_t failed_count = 0;
+            const auto start_tick = os::GetSystemTick();
+            for (size_t i = 0; i < IterationCount; ++i) {
+                if (live_count < MaxLiveBlocks && (live_count == 0 || rng.Next() % 2 == 0)) {
+                    const s32 alignment = GetRandomAlignment(rng);
+                    if (void *block = lmem::AllocateFromExpHeap(heap, GetRandomSize(rng), alignment); block != nullptr) {
+                        AMS_ABORT_UNLESS(util::IsAligned(reinterpret_cast<uintptr_t>(block), std::abs(alignment)));
+                        g_live_blocks[live_count++] = block;
+                    } else {
+                        ++failed_count;
+                    }
+                } else {
+                    const size_t index = rng.Next() % live_count;
+                    lmem::FreeToExpHeap(heap, g_live_blocks[index]);
+                    g_live_blocks[index] = g_live_blocks[--live_count];
+                }
+            }
+            const auto end_tick = os::GetSystemTick();
+
+            /* Free everything, and check that the heap coalesced back to its original state. */
+            /* NOTE: Other modes drop margins too small to become blocks, so only segregated fit is guaranteed to get everything back. */
+            while (live_count > 0) {
+                lmem::FreeToExpHeap(heap, g_live_blocks[--live_count]);
+            }
+            lmem::SetExpHeapAllocationMode(heap, lmem::AllocationMode_FirstFit);
+            AMS_ABORT_UNLESS(mode != lmem::AllocationMode_SegregatedFit || lmem::GetExpHeapTotalFreeSize(heap) == initial_free_size);
+
+            const auto elapsed = os::ConvertToTimeSpan(end_tick - start_tick);
+            printf("%-14s: %zu operations in %" PRId64 " us (%" PRId64 " ns/op), %zu failed allocations\n", name, IterationCount, elapsed.GetMicroSeconds(), elapsed.GetNanoSeconds() / static_cast<s64>(IterationCount), failed_count);
+        }
+
+    }
+
+    void Main() {
+        printf("Benchmarking exp heap allocation modes\n");
+        {
+            RunBenchmark("FirstFit",      lmem::AllocationMode_FirstFit);
+            RunBenchmark("BestFit",       lmem::AllocationMode_BestFit);
+            RunBenchmark("SegregatedFit", lmem::AllocationMode_SegregatedFit);
+        }
+        printf("All tests completed!\n");
+    }
+
+}
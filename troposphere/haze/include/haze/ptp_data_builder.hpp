@@ -27,8 +27,20 @@ namespace haze {
             u32 m_transmitted_size;
             u32 m_offset;
             u8 *m_data;
+            u8 *m_buffers[2];
+            u32 m_buffer_index;
+            u32 m_pending_urb_id;
+            bool m_pending;
             bool m_disabled;
         private:
+            Result WaitForPendingWrite() {
+                /* If we have no write in progress, we have nothing to do. */
+                R_SUCCEED_IF(!m_pending);
+
+                m_pending = false;
+                R_RETURN(m_server->WaitWritePacket(m_pending_urb_id));
+            }
+
             Result Flush() {
                 ON_SCOPE_EXIT {
                     m_transmitted_size += m_offset;
@@ -38,11 +50,37 @@ namespace haze {
                 /* If we're disabled, we have nothing to do. */
                 R_SUCCEED_IF(m_disabled);
 
-                /* Otherwise, we should write our buffered data. */
-                R_RETURN(m_server->WritePacket(m_data, m_offset));
+                /* If we only have one buffer, write our buffered data and wait for it to complete. */
+                if (m_buffers[1] == nullptr) {
+                    R_RETURN(m_server->WritePacket(m_data, m_offset));
+                }
+
+                /* Otherwise, wait for the previous write to complete, and begin writing our buffered data. */
+                R_TRY(this->WaitForPendingWrite());
+                R_TRY(m_server->BeginWritePacket(m_data, m_offset, std::addressof(m_pending_urb_id)));
+                m_pending = true;
+
+                /* Continue building into the other buffer while the write is in progress. */
+                m_buffer_index ^= 1;
+                m_data = m_buffers[m_buffer_index];
+
+                R_SUCCEED();
             }
         public:
-            constexpr explicit PtpDataBuilder(void *data, AsyncUsbServer *server) : m_server(server),  m_transmitted_size(), m_offset(), m_data(static_cast<u8 *>(data)), m_disabled() { /* ... */ }
+            constexpr explicit PtpDataBuilder(void *data, AsyncUsbServer *server) : PtpDataBuilder(data, nullptr, server) { /* ... */ }
+
+            /* When given a secondary buffer, the builder double-buffers, and returns to the caller while a packet is being written. */
+            constexpr explicit PtpDataBuilder(void *data, void *secondary_data, AsyncUsbServer *server)
+                : m_server(server), m_transmitted_size(), m_offset(), m_data(static_cast<u8 *>(data)), m_buffers{static_cast<u8 *>(data), static_cast<u8 *>(secondary_data)},
+                  m_buffer_index(), m_pending_urb_id(), m_pending(), m_disabled()
+            {
+                /* ... */
+            }
+
+            ~PtpDataBuilder() {
+                /* Don't let a write outlive its buffer. */
+                this->WaitForPendingWrite();
+            }
 
             Result Commit() {
                 if (m_offset > 0) {
@@ -55,7 +93,8 @@ namespace haze {
                     R_TRY(this->Flush());
                 }
 
-                R_SUCCEED();
+                /* Wait for the data to be written. */
+                R_RETURN(this->WaitForPendingWrite());
             }
 
             Result AddBuffer(const u8 *buffer, u32 count) {
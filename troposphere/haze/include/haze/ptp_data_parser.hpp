@@ -27,8 +27,19 @@ namespace haze {
             u32 m_received_size;
             u32 m_offset;
             u8 *m_data;
+            u8 *m_buffers[2];
+            u32 m_buffer_index;
+            u32 m_pending_urb_id;
+            bool m_pending;
             bool m_eot;
         private:
+            Result BeginRead() {
+                R_TRY(m_server->BeginReadPacket(m_buffers[m_buffer_index], haze::UsbBulkPacketBufferSize, std::addressof(m_pending_urb_id)));
+                m_pending = true;
+
+                R_SUCCEED();
+            }
+
             Result Flush() {
                 R_UNLESS(!m_eot, haze::ResultEndOfTransmission());
 
@@ -41,10 +52,48 @@ namespace haze {
                     m_eot = m_received_size < haze::UsbBulkPacketBufferSize;
                 };
 
-                R_RETURN(m_server->ReadPacket(m_data, haze::UsbBulkPacketBufferSize, std::addressof(m_received_size)));
+                /* If we only have one buffer, read directly into it. */
+                if (m_buffers[1] == nullptr) {
+                    R_RETURN(m_server->ReadPacket(m_data, haze::UsbBulkPacketBufferSize, std::addressof(m_received_size)));
+                }
+
+                /* Otherwise, begin a read if one isn't in progress already, and wait for it to complete. */
+                if (!m_pending) {
+                    R_TRY(this->BeginRead());
+                }
+
+                m_pending = false;
+                R_TRY(m_server->WaitReadPacket(m_pending_urb_id, std::addressof(m_received_size)));
+
+                /* Consume from the buffer we just received into. */
+                m_data = m_buffers[m_buffer_index];
+                m_buffer_index ^= 1;
+
+                /* If more packets will follow, begin receiving the next one into the other buffer. */
+                if (m_received_size == haze::UsbBulkPacketBufferSize) {
+                    R_TRY(this->BeginRead());
+                }
+
+                R_SUCCEED();
             }
         public:
-            constexpr explicit PtpDataParser(void *data, AsyncUsbServer *server) : m_server(server), m_received_size(), m_offset(), m_data(static_cast<u8 *>(data)), m_eot() { /* ... */ }
+            constexpr explicit PtpDataParser(void *data, AsyncUsbServer *server) : PtpDataParser(data, nullptr, server) { /* ... */ }
+
+            /* When given a secondary buffer, the parser double-buffers, and receives the next packet while the caller consumes the current one. */
+            constexpr explicit PtpDataParser(void *data, void *secondary_data, AsyncUsbServer *server)
+                : m_server(server), m_received_size(), m_offset(), m_data(static_cast<u8 *>(data)), m_buffers{static_cast<u8 *>(data), static_cast<u8 *>(secondary_data)},
+                  m_buffer_index(), m_pending_urb_id(), m_pending(), m_eot()
+            {
+                /* ... */
+            }
+
+            ~PtpDataParser() {
+                /* Don't let a read outlive its buffer. */
+                if (m_pending) {
+                    u32 received_size;
+                    m_server->WaitReadPacket(m_pending_urb_id, std::addressof(received_size));
+                }
+            }
 
             Result Finalize() {
                 /* Read until the transmission completes. */
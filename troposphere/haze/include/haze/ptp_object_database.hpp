@@ -21,15 +21,44 @@
 
 namespace haze {
 
+    /* Path components are interned, so that names shared between directories are only stored once. */
+    struct PtpObjectName {
+        public:
+            util::IntrusiveRedBlackTreeNode m_name_node;
+            u32 m_reference_count;
+            char m_name[];
+        public:
+            const char *GetName() const { return m_name; }
+        public:
+            struct Comparator {
+                struct RedBlackKeyType {
+                    const char *m_name;
+
+                    constexpr RedBlackKeyType(const char *name) : m_name(name) { /* ... */ }
+
+                    constexpr const char *GetName() const {
+                        return m_name;
+                    }
+                };
+
+                template<typename T> requires (std::same_as<T, PtpObjectName> || std::same_as<T, RedBlackKeyType>)
+                static constexpr int Compare(const T &lhs, const PtpObjectName &rhs) {
+                    /* Interning preserves case, so that case-only renames are reflected. */
+                    return std::strcmp(lhs.GetName(), rhs.GetName());
+                }
+            };
+    };
+
     struct PtpObject {
         public:
             util::IntrusiveRedBlackTreeNode m_name_node;
             util::IntrusiveRedBlackTreeNode m_object_id_node;
+            util::IntrusiveListNode m_enumerated_list_node;
+            PtpObjectName *m_name;
             u32 m_parent_id;
             u32 m_object_id;
-            char m_name[];
         public:
-            const char *GetName()  const { return m_name; }
+            const char *GetName()  const { return m_name->GetName(); }
             u32 GetParentId()      const { return m_parent_id; }
             u32 GetObjectId()      const { return m_object_id; }
         public:
@@ -39,9 +68,14 @@ namespace haze {
         public:
             struct NameComparator {
                 struct RedBlackKeyType {
+                    u32 m_parent_id;
                     const char *m_name;
 
-                    constexpr RedBlackKeyType(const char *name) : m_name(name) { /* ... */ }
+                    constexpr RedBlackKeyType(u32 parent_id, const char *name) : m_parent_id(parent_id), m_name(name) { /* ... */ }
+
+                    constexpr u32 GetParentId() const {
+                        return m_parent_id;
+                    }
 
                     constexpr const char *GetName() const {
                         return m_name;
@@ -50,6 +84,11 @@ namespace haze {
 
                 template<typename T> requires (std::same_as<T, PtpObject> || std::same_as<T, RedBlackKeyType>)
                 static constexpr int Compare(const T &lhs, const PtpObject &rhs) {
+                    /* Group objects by their parent, so that the children of an object are adjacent. */
+                    if (lhs.GetParentId() != rhs.GetParentId()) {
+                        return lhs.GetParentId() < rhs.GetParentId() ? -1 : 1;
+                    }
+
                     /* All SD card filesystems supported by fs are case-insensitive and case-preserving. */
                     /* Account for that in collation here. */
                     return strcasecmp(lhs.GetName(), rhs.GetName());
@@ -69,7 +108,12 @@ namespace haze {
 
                 template<typename T> requires (std::same_as<T, PtpObject> || std::same_as<T, RedBlackKeyType>)
                 static constexpr int Compare(const T &lhs, const PtpObject &rhs) {
-                    return lhs.GetObjectId() - rhs.GetObjectId();
+                    /* The storage IDs are at the top of the range, so the difference of two IDs doesn't fit in an int. */
+                    if (lhs.GetObjectId() != rhs.GetObjectId()) {
+                        return lhs.GetObjectId() < rhs.GetObjectId() ? -1 : 1;
+                    }
+
+                    return 0;
                 }
             };
     };
@@ -82,26 +126,54 @@ namespace haze {
             using ObjectIdTreeTraits   = util::IntrusiveRedBlackTreeMemberTraitsDeferredAssert<&PtpObject::m_object_id_node>;
             using ObjectIdTree         = ObjectIdTreeTraits::TreeType<PtpObject::ObjectIdComparator>;
 
+            using NameTreeTraits       = util::IntrusiveRedBlackTreeMemberTraitsDeferredAssert<&PtpObjectName::m_name_node>;
+            using NameTree             = NameTreeTraits::TreeType<PtpObjectName::Comparator>;
+
+            using EnumeratedListTraits = util::IntrusiveListMemberTraits<&PtpObject::m_enumerated_list_node>;
+            using EnumeratedList       = EnumeratedListTraits::ListType;
+
             PtpObjectHeap *m_object_heap;
-            ObjectNameTree m_name_tree;
+            ObjectNameTree m_object_name_tree;
             ObjectIdTree m_object_id_tree;
+            NameTree m_name_tree;
+            EnumeratedList m_enumerated_list;
+            u32 m_pinned_object_id;
             u32 m_next_object_id;
         public:
-            constexpr explicit PtpObjectDatabase() : m_object_heap(), m_name_tree(), m_object_id_tree(), m_next_object_id() { /* ... */ }
+            constexpr explicit PtpObjectDatabase() : m_object_heap(), m_object_name_tree(), m_object_id_tree(), m_name_tree(), m_enumerated_list(), m_pinned_object_id(), m_next_object_id() { /* ... */ }
 
             void Initialize(PtpObjectHeap *object_heap);
             void Finalize();
         public:
             /* Object database API. */
-            Result CreateOrFindObject(const char *parent_name, const char *name, u32 parent_id, PtpObject **out_object);
+            Result CreateOrFindObject(u32 parent_id, const char *name, PtpObject **out_object);
             void RegisterObject(PtpObject *object, u32 desired_id = 0);
             void UnregisterObject(PtpObject *object);
             void DeleteObject(PtpObject *obj);
+            void DeleteObjectRecursively(PtpObject *obj);
+            Result RenameObject(PtpObject *obj, const char *name);
+            Result CreateAndRegisterObjectId(u32 parent_id, const char *name, u32 *out_object_id);
+
+            /* Records that the host has listed the children of an object. */
+            /* When memory runs low, the children of the least recently listed objects are reclaimed. */
+            void MarkObjectEnumerated(PtpObject *object);
 
-            Result CreateAndRegisterObjectId(const char *parent_name, const char *name, u32 parent_id, u32 *out_object_id);
+            /* Prevents an object from being reclaimed, such as the target of a pending SendObject. Pass 0 to clear. */
+            void SetPinnedObjectId(u32 object_id) { m_pinned_object_id = object_id; }
+
+            /* NOTE: out_path must contain room for FS_MAX_PATH bytes. */
+            Result GetObjectPath(const PtpObject *object, char *out_path);
         public:
             PtpObject *GetObjectById(u32 object_id);
-            PtpObject *GetObjectByName(const char *name);
+            PtpObject *GetObjectByName(u32 parent_id, const char *name);
+        private:
+            void *Allocate(size_t size);
+
+            Result AcquireName(const char *name, PtpObjectName **out_name);
+            void ReleaseName(PtpObjectName *name);
+
+            bool HasChildren(const PtpObject *object) const;
+            bool ReclaimLeastRecentlyEnumerated();
     };
 
 }
@@ -21,16 +21,26 @@ namespace haze {
 
     /* This simple linear allocator implementation allows us to rapidly reclaim the entire object graph. */
     /* This is critical for maintaining interactivity when a session is closed. */
+    /* Small allocations are additionally recycled through per-size free lists, so that objects */
+    /* reclaimed during a session can be reused without resetting the heap. */
     class PtpObjectHeap {
         private:
             static constexpr size_t NumHeapBlocks = 2;
+            static constexpr size_t AllocationAlignment = alignof(u64);
+            static constexpr size_t MaxFreeListAllocationSize = 1_KB;
+            static constexpr size_t NumFreeLists = MaxFreeListAllocationSize / AllocationAlignment;
+
+            struct FreeListEntry {
+                FreeListEntry *m_next;
+            };
         private:
             void *m_heap_blocks[NumHeapBlocks];
             void *m_next_address;
             u32 m_heap_block_size;
             u32 m_current_heap_block;
+            FreeListEntry *m_free_lists[NumFreeLists];
         public:
-            constexpr explicit PtpObjectHeap() : m_heap_blocks(), m_next_address(), m_heap_block_size(), m_current_heap_block() { /* ... */ }
+            constexpr explicit PtpObjectHeap() : m_heap_blocks(), m_next_address(), m_heap_block_size(), m_current_heap_block(), m_free_lists() { /* ... */ }
 
             void Initialize();
             void Finalize();
@@ -77,6 +87,25 @@ namespace haze {
                 return false;
             }
 
+            static constexpr size_t GetFreeListIndex(size_t n) {
+                return (n / AllocationAlignment) - 1;
+            }
+
+            constexpr void *AllocateFromFreeList(size_t n) {
+                /* Only small allocations are tracked. */
+                if (n == 0 || n > MaxFreeListAllocationSize) {
+                    return nullptr;
+                }
+
+                /* Pop the first entry, if there is one. */
+                FreeListEntry *entry = m_free_lists[GetFreeListIndex(n)];
+                if (entry != nullptr) {
+                    m_free_lists[GetFreeListIndex(n)] = entry->m_next;
+                }
+
+                return entry;
+            }
+
             constexpr void *AllocateFromCurrentBlock(size_t n) {
                 void *result = this->GetNextAddress();
 
@@ -93,7 +122,12 @@ namespace haze {
                 }
 
                 /* Align the amount to satisfy allocation for u64. */
-                n = util::AlignUp(n, alignof(u64));
+                n = util::AlignUp(n, AllocationAlignment);
+
+                /* Reuse previously freed memory of the same size, if we can. */
+                if (void *recycled = this->AllocateFromFreeList(n); recycled != nullptr) {
+                    return static_cast<T *>(recycled);
+                }
 
                 /* Check if the allocation is possible. */
                 if (!this->AllocationIsPossible(n)) {
@@ -117,11 +151,20 @@ namespace haze {
                 }
 
                 /* Align the amount to satisfy allocation for u64. */
-                n = util::AlignUp(n, alignof(u64));
+                n = util::AlignUp(n, AllocationAlignment);
 
                 /* If the pointer was the last allocation, return the memory to the heap. */
                 if (static_cast<u8 *>(p) + n == this->GetNextAddress()) {
                     m_next_address = this->GetNextAddress() - n;
+                    return;
+                }
+
+                /* Otherwise, if the allocation is small, keep it around for reuse. */
+                if (n != 0 && n <= MaxFreeListAllocationSize) {
+                    FreeListEntry *entry = static_cast<FreeListEntry *>(p);
+                    entry->m_next = m_free_lists[GetFreeListIndex(n)];
+                    m_free_lists[GetFreeListIndex(n)] = entry;
+                    return;
                 }
 
                 /* Otherwise, do nothing. */
@@ -50,6 +50,12 @@ namespace haze {
             Result HandleCommandRequest(PtpDataParser &dp);
             void ForceCloseSession();
 
+            void SetSendObjectId(u32 object_id) {
+                /* The object must survive until the host sends its data, even if memory runs low in between. */
+                m_send_object_id = object_id;
+                m_object_database.SetPinnedObjectId(object_id);
+            }
+
             Result WriteResponse(PtpResponseCode code, const void* data, size_t size);
             Result WriteResponse(PtpResponseCode code);
 
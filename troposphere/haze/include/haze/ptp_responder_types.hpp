@@ -173,6 +173,9 @@ namespace haze {
         char modification_date_string_buffer[PtpStringMaxLength + 1];
         char keywords_string_buffer[PtpStringMaxLength + 1];
 
+        char object_path_buffer[FS_MAX_PATH];
+        char new_object_path_buffer[FS_MAX_PATH];
+
         FsDirectoryEntry file_system_entry_buffer[DirectoryReadSize];
         u8 file_system_data_buffer[FsBufferSize];
 
@@ -36,8 +36,7 @@ namespace haze {
         g_usb_session.Finalize();
     }
 
-    Result AsyncUsbServer::TransferPacketImpl(bool read, void *page, u32 size, u32 *out_size_transferred) const {
-        u32 urb_id;
+    Result AsyncUsbServer::BeginTransferPacketImpl(bool read, void *page, u32 size, u32 *out_urb_id) const {
         s32 waiter_idx;
 
         /* If we're not configured yet, wait to become configured first. */
@@ -50,9 +49,14 @@ namespace haze {
 
         /* Select the appropriate endpoint and begin a transfer. */
         UsbSessionEndpoint ep = read ? UsbSessionEndpoint_Read : UsbSessionEndpoint_Write;
-        R_TRY(g_usb_session.TransferAsync(ep, page, size, std::addressof(urb_id)));
+        R_RETURN(g_usb_session.TransferAsync(ep, page, size, out_urb_id));
+    }
+
+    Result AsyncUsbServer::WaitTransferPacketImpl(bool read, u32 urb_id, u32 *out_size_transferred) const {
+        s32 waiter_idx;
 
         /* Try to wait for the event. */
+        UsbSessionEndpoint ep = read ? UsbSessionEndpoint_Read : UsbSessionEndpoint_Write;
         R_TRY(m_reactor->WaitFor(std::addressof(waiter_idx), waiterForEvent(g_usb_session.GetCompletionEvent(ep))));
 
         /* Return what we transferred. */
@@ -21,56 +21,107 @@ namespace haze {
         m_object_heap = object_heap;
         m_object_heap->Initialize();
 
-        std::construct_at(std::addressof(m_name_tree));
+        std::construct_at(std::addressof(m_object_name_tree));
         std::construct_at(std::addressof(m_object_id_tree));
+        std::construct_at(std::addressof(m_name_tree));
+        std::construct_at(std::addressof(m_enumerated_list));
 
-        m_next_object_id = 1;
+        m_pinned_object_id = 0;
+        m_next_object_id   = 1;
     }
 
     void PtpObjectDatabase::Finalize() {
-        std::destroy_at(std::addressof(m_object_id_tree));
+        std::destroy_at(std::addressof(m_enumerated_list));
         std::destroy_at(std::addressof(m_name_tree));
+        std::destroy_at(std::addressof(m_object_id_tree));
+        std::destroy_at(std::addressof(m_object_name_tree));
 
-        m_next_object_id = 0;
+        m_pinned_object_id = 0;
+        m_next_object_id   = 0;
 
         m_object_heap->Finalize();
         m_object_heap = nullptr;
     }
 
-    Result PtpObjectDatabase::CreateOrFindObject(const char *parent_name, const char *name, u32 parent_id, PtpObject **out_object) {
-        constexpr auto separator = "/";
-
-        /* Calculate length of the new name with null terminator. */
-        const size_t parent_name_len = util::Strlen(parent_name);
-        const size_t separator_len   = util::Strlen(separator);
-        const size_t name_len        = util::Strlen(name);
-        const size_t terminator_len  = 1;
-        const size_t alloc_len       = sizeof(PtpObject) + parent_name_len + separator_len + name_len + terminator_len;
+    void *PtpObjectDatabase::Allocate(size_t size) {
+        while (true) {
+            /* Try to allocate the memory. */
+            if (void *p = m_object_heap->Allocate(size); p != nullptr) {
+                return p;
+            }
 
-        /* Allocate memory for the object. */
-        PtpObject * const object = m_object_heap->Allocate<PtpObject>(alloc_len);
-        R_UNLESS(object != nullptr, haze::ResultOutOfMemory());
-
-        /* Build the object name. */
-        std::strncpy(object->m_name,                                   parent_name, parent_name_len + terminator_len);
-        std::strncpy(object->m_name + parent_name_len,                 separator,   separator_len + terminator_len);
-        std::strncpy(object->m_name + parent_name_len + separator_len, name,        name_len + terminator_len);
-
-        {
-            /* Ensure we maintain a clean state on failure. */
-            auto guard = SCOPE_GUARD { m_object_heap->Deallocate(object, alloc_len); };
-
-            /* Check if an object with this name already exists. If it does, we can just return it here. */
-            if (auto * const existing = this->GetObjectByName(object->GetName()); existing != nullptr) {
-                *out_object = existing;
-                R_SUCCEED();
+            /* If we're out of memory, reclaim objects the host is least likely to be using, and try again. */
+            if (!this->ReclaimLeastRecentlyEnumerated()) {
+                return nullptr;
             }
+        }
+    }
+
+    Result PtpObjectDatabase::AcquireName(const char *name, PtpObjectName **out_name) {
+        /* If the name is already interned, take a reference to it. */
+        if (auto it = m_name_tree.find_key(name); it != m_name_tree.end()) {
+            it->m_reference_count++;
+
+            *out_name = std::addressof(*it);
+            R_SUCCEED();
+        }
+
+        /* Allocate memory for the name. */
+        const size_t name_len   = util::Strlen(name);
+        const size_t alloc_len  = sizeof(PtpObjectName) + name_len + 1;
+
+        PtpObjectName * const interned = static_cast<PtpObjectName *>(this->Allocate(alloc_len));
+        R_UNLESS(interned != nullptr, haze::ResultOutOfMemory());
+
+        /* Set name properties. */
+        interned->m_reference_count = 1;
+        std::memcpy(interned->m_name, name, name_len + 1);
+
+        /* Insert the name into the tree. */
+        m_name_tree.insert(*interned);
+
+        /* Set output. */
+        *out_name = interned;
+        R_SUCCEED();
+    }
 
-            /* Persist the reference to the object. */
-            guard.Cancel();
+    void PtpObjectDatabase::ReleaseName(PtpObjectName *name) {
+        /* If the name is still in use, we have nothing to do. */
+        if ((--name->m_reference_count) > 0) {
+            return;
         }
 
+        /* Remove the name from the tree and free it. */
+        m_name_tree.erase(m_name_tree.iterator_to(*name));
+        m_object_heap->Deallocate(name, sizeof(PtpObjectName) + std::strlen(name->GetName()) + 1);
+    }
+
+    Result PtpObjectDatabase::CreateOrFindObject(u32 parent_id, const char *name, PtpObject **out_object) {
+        /* Check if an object with this name already exists. If it does, we can just return it here. */
+        if (auto * const existing = this->GetObjectByName(parent_id, name); existing != nullptr) {
+            *out_object = existing;
+            R_SUCCEED();
+        }
+
+        /* Keep the parent from being reclaimed while we allocate. */
+        if (auto * const parent = this->GetObjectById(parent_id); parent != nullptr) {
+            this->MarkObjectEnumerated(parent);
+        }
+
+        /* Get the name of the object. */
+        PtpObjectName *object_name;
+        R_TRY(this->AcquireName(name, std::addressof(object_name)));
+
+        /* Ensure we maintain a clean state on failure. */
+        ON_RESULT_FAILURE { this->ReleaseName(object_name); };
+
+        /* Allocate memory for the object. */
+        void * const object_memory = this->Allocate(sizeof(PtpObject));
+        R_UNLESS(object_memory != nullptr, haze::ResultOutOfMemory());
+
         /* Set object properties. */
+        PtpObject * const object = std::construct_at(static_cast<PtpObject *>(object_memory));
+        object->m_name      = object_name;
         object->m_parent_id = parent_id;
         object->m_object_id = 0;
 
@@ -88,6 +139,7 @@ namespace haze {
         }
 
         /* Set desired object ID. */
+        /* NOTE: IDs are never reused within a session, so that a handle the host holds to a reclaimed object can't refer to another object. */
         if (desired_id == 0) {
             desired_id = m_next_object_id++;
         }
@@ -95,7 +147,7 @@ namespace haze {
         /* Insert object into trees. */
         object->Register(desired_id);
         m_object_id_tree.insert(*object);
-        m_name_tree.insert(*object);
+        m_object_name_tree.insert(*object);
     }
 
     void PtpObjectDatabase::UnregisterObject(PtpObject *object) {
@@ -104,9 +156,14 @@ namespace haze {
             return;
         }
 
+        /* Stop tracking enumeration of the object's children. */
+        if (object->m_enumerated_list_node.IsLinked()) {
+            m_enumerated_list.erase(m_enumerated_list.iterator_to(*object));
+        }
+
         /* Remove object from trees. */
         m_object_id_tree.erase(m_object_id_tree.iterator_to(*object));
-        m_name_tree.erase(m_name_tree.iterator_to(*object));
+        m_object_name_tree.erase(m_object_name_tree.iterator_to(*object));
         object->Unregister();
     }
 
@@ -115,13 +172,68 @@ namespace haze {
         this->UnregisterObject(object);
 
         /* Free the object. */
-        m_object_heap->Deallocate(object, sizeof(PtpObject) + std::strlen(object->GetName()) + 1);
+        this->ReleaseName(object->m_name);
+        std::destroy_at(object);
+        m_object_heap->Deallocate(object, sizeof(PtpObject));
+    }
+
+    void PtpObjectDatabase::DeleteObjectRecursively(PtpObject *object) {
+        /* Delete all children of the object. */
+        if (object->GetIsRegistered()) {
+            const u32 object_id = object->GetObjectId();
+
+            while (true) {
+                auto it = m_object_name_tree.nfind_key(PtpObject::NameComparator::RedBlackKeyType(object_id, ""));
+                if (it == m_object_name_tree.end() || it->GetParentId() != object_id) {
+                    break;
+                }
+
+                this->DeleteObjectRecursively(std::addressof(*it));
+            }
+        }
+
+        /* Delete the object itself. */
+        this->DeleteObject(object);
+    }
+
+    Result PtpObjectDatabase::RenameObject(PtpObject *object, const char *name) {
+        /* If we fail, the object's name no longer matches the filesystem, so forget it. The host will find it again when it enumerates. */
+        ON_RESULT_FAILURE { this->DeleteObjectRecursively(object); };
+
+        /* Keep the object from being reclaimed while we allocate. */
+        if (auto * const parent = this->GetObjectById(object->GetParentId()); parent != nullptr) {
+            this->MarkObjectEnumerated(parent);
+        }
+
+        /* Get the new name of the object. */
+        PtpObjectName *object_name;
+        R_TRY(this->AcquireName(name, std::addressof(object_name)));
+
+        /* Any other object with the new name no longer exists. */
+        if (auto * const existing = this->GetObjectByName(object->GetParentId(), name); existing != nullptr && existing != object) {
+            this->DeleteObjectRecursively(existing);
+        }
+
+        /* Update the name, keeping the name tree ordered. */
+        const bool is_registered = object->GetIsRegistered();
+        if (is_registered) {
+            m_object_name_tree.erase(m_object_name_tree.iterator_to(*object));
+        }
+
+        this->ReleaseName(object->m_name);
+        object->m_name = object_name;
+
+        if (is_registered) {
+            m_object_name_tree.insert(*object);
+        }
+
+        R_SUCCEED();
     }
 
-    Result PtpObjectDatabase::CreateAndRegisterObjectId(const char *parent_name, const char *name, u32 parent_id, u32 *out_object_id) {
+    Result PtpObjectDatabase::CreateAndRegisterObjectId(u32 parent_id, const char *name, u32 *out_object_id) {
         /* Try to create the object. */
         PtpObject *object;
-        R_TRY(this->CreateOrFindObject(parent_name, name, parent_id, std::addressof(object)));
+        R_TRY(this->CreateOrFindObject(parent_id, name, std::addressof(object)));
 
         /* We succeeded, so register it. */
         this->RegisterObject(object);
@@ -132,6 +244,61 @@ namespace haze {
         R_SUCCEED();
     }
 
+    void PtpObjectDatabase::MarkObjectEnumerated(PtpObject *object) {
+        /* If the object is already the most recently enumerated, we have nothing to do. */
+        if (!m_enumerated_list.empty() && std::addressof(m_enumerated_list.front()) == object) {
+            return;
+        }
+
+        /* The host reached the object through its ancestors, so they are still in use too. */
+        for (auto *parent = this->GetObjectById(object->GetParentId()); parent != nullptr; parent = this->GetObjectById(parent->GetParentId())) {
+            if (parent->m_enumerated_list_node.IsLinked()) {
+                m_enumerated_list.erase(m_enumerated_list.iterator_to(*parent));
+            }
+
+            m_enumerated_list.push_front(*parent);
+        }
+
+        /* Move the object to the front of the list. */
+        if (object->m_enumerated_list_node.IsLinked()) {
+            m_enumerated_list.erase(m_enumerated_list.iterator_to(*object));
+        }
+
+        m_enumerated_list.push_front(*object);
+    }
+
+    Result PtpObjectDatabase::GetObjectPath(const PtpObject *object, char *out_path) {
+        /* Calculate the length of the path. The storage root has no name of its own. */
+        size_t path_len = 0;
+        for (const PtpObject *cur = object; cur->GetParentId() != PtpGetObjectHandles_RootParent; ) {
+            path_len += 1 + std::strlen(cur->GetName());
+
+            cur = this->GetObjectById(cur->GetParentId());
+            R_UNLESS(cur != nullptr, haze::ResultInvalidObjectId());
+        }
+
+        /* The path must fit, including the null terminator. */
+        R_UNLESS(path_len < FS_MAX_PATH, haze::ResultInvalidArgument());
+
+        /* The storage root is the root directory. */
+        if (path_len == 0) {
+            std::strcpy(out_path, "/");
+            R_SUCCEED();
+        }
+
+        /* Build the path from the end. */
+        out_path[path_len] = '\x00';
+        for (const PtpObject *cur = object; cur->GetParentId() != PtpGetObjectHandles_RootParent; cur = this->GetObjectById(cur->GetParentId())) {
+            const size_t name_len = std::strlen(cur->GetName());
+
+            path_len -= name_len;
+            std::memcpy(out_path + path_len, cur->GetName(), name_len);
+            out_path[--path_len] = '/';
+        }
+
+        R_SUCCEED();
+    }
+
     PtpObject *PtpObjectDatabase::GetObjectById(u32 object_id) {
         /* Find in ID mapping. */
         if (auto it = m_object_id_tree.find_key(object_id); it != m_object_id_tree.end()) {
@@ -141,12 +308,46 @@ namespace haze {
         }
     }
 
-    PtpObject *PtpObjectDatabase::GetObjectByName(const char *name) {
+    PtpObject *PtpObjectDatabase::GetObjectByName(u32 parent_id, const char *name) {
         /* Find in name mapping. */
-        if (auto it = m_name_tree.find_key(name); it != m_name_tree.end()) {
+        if (auto it = m_object_name_tree.find_key(PtpObject::NameComparator::RedBlackKeyType(parent_id, name)); it != m_object_name_tree.end()) {
             return std::addressof(*it);
         } else {
             return nullptr;
         }
     }
+
+    bool PtpObjectDatabase::HasChildren(const PtpObject *object) const {
+        const u32 object_id = object->GetObjectId();
+
+        /* Children are ordered by parent, and the empty name sorts before all others. */
+        auto it = m_object_name_tree.nfind_key(PtpObject::NameComparator::RedBlackKeyType(object_id, ""));
+        return it != m_object_name_tree.end() && it->GetParentId() == object_id;
+    }
+
+    bool PtpObjectDatabase::ReclaimLeastRecentlyEnumerated() {
+        /* Never reclaim the children of the most recently enumerated object, as the host is likely still using them. */
+        if (m_enumerated_list.empty() || std::addressof(m_enumerated_list.front()) == std::addressof(m_enumerated_list.back())) {
+            return false;
+        }
+
+        /* Stop tracking the least recently enumerated object. */
+        PtpObject &parent = m_enumerated_list.back();
+        m_enumerated_list.pop_back();
+
+        /* Delete its children, keeping any which have children of their own. */
+        const u32 parent_id = parent.GetObjectId();
+
+        auto it = m_object_name_tree.nfind_key(PtpObject::NameComparator::RedBlackKeyType(parent_id, ""));
+        while (it != m_object_name_tree.end() && it->GetParentId() == parent_id) {
+            PtpObject *child = std::addressof(*(it++));
+
+            if (!child->m_enumerated_list_node.IsLinked() && child->GetObjectId() != m_pinned_object_id && !this->HasChildren(child)) {
+                this->DeleteObject(child);
+            }
+        }
+
+        return true;
+    }
+
 }
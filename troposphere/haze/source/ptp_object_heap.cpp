@@ -64,6 +64,10 @@ namespace haze {
         m_next_address       = nullptr;
         m_heap_block_size    = 0;
         m_current_heap_block = 0;
+
+        for (size_t i = 0; i < NumFreeLists; i++) {
+            m_free_lists[i] = nullptr;
+        }
     }
 
 }
@@ -21,7 +21,8 @@
 namespace haze {
 
     Result PtpResponder::GetPartialObject64(PtpDataParser &dp) {
-        PtpDataBuilder db(m_buffers->usb_bulk_write_buffer, std::addressof(m_usb_server));
+        /* The request is fully read before any data is written, so the read buffer is free to double-buffer the data phase. */
+        PtpDataBuilder db(m_buffers->usb_bulk_write_buffer, m_buffers->usb_bulk_read_buffer, std::addressof(m_usb_server));
 
         /* Get the object ID, offset, and size for the file we want to read. */
         u32 object_id, size;
@@ -35,9 +36,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Lock the object as a file. */
         FsFile file;
-        R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Read, std::addressof(file)));
+        R_TRY(m_fs.OpenFile(path, FsOpenMode_Read, std::addressof(file)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -94,9 +99,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(m_send_object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Lock the object as a file. */
         FsFile file;
-        R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Write | FsOpenMode_Append, std::addressof(file)));
+        R_TRY(m_fs.OpenFile(path, FsOpenMode_Write | FsOpenMode_Append, std::addressof(file)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -110,7 +119,8 @@ namespace haze {
         R_UNLESS(static_cast<u64>(file_size) <= offset, haze::ResultInvalidArgument());
 
         /* Prepare a data parser for the data we are about to receive. */
-        PtpDataParser dp(m_buffers->usb_bulk_read_buffer, std::addressof(m_usb_server));
+        /* Nothing is written until the data is fully received, so the write buffer is free to double-buffer the data phase. */
+        PtpDataParser dp(m_buffers->usb_bulk_read_buffer, m_buffers->usb_bulk_write_buffer, std::addressof(m_usb_server));
 
         /* Ensure we have a data header. */
         PtpUsbBulkContainer data_header;
@@ -157,9 +167,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Lock the object as a file. */
         FsFile file;
-        R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Write, std::addressof(file)));
+        R_TRY(m_fs.OpenFile(path, FsOpenMode_Write, std::addressof(file)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
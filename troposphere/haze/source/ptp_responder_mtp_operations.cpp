@@ -120,9 +120,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Define helper for getting the object type. */
         const auto GetObjectType = [&] (FsDirEntryType *out_entry_type) {
-            R_RETURN(m_fs.GetEntryType(obj->GetName(), out_entry_type));
+            R_RETURN(m_fs.GetEntryType(path, out_entry_type));
         };
 
         /* Define helper for getting the object size. */
@@ -138,7 +142,7 @@ namespace haze {
 
             /* Otherwise, open as a file. */
             FsFile file;
-            R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Read, std::addressof(file)));
+            R_TRY(m_fs.OpenFile(path, FsOpenMode_Read, std::addressof(file)));
 
             /* Ensure we maintain a clean state on exit. */
             ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -182,7 +186,7 @@ namespace haze {
                     break;
                 case PtpObjectPropertyCode_ObjectFileName:
                     {
-                        R_TRY(db.AddString(std::strrchr(obj->GetName(), '/') + 1));
+                        R_TRY(db.AddString(obj->GetName()));
                     }
                     break;
                 HAZE_UNREACHABLE_DEFAULT_CASE();
@@ -225,9 +229,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Define helper for getting the object type. */
         const auto GetObjectType = [&] (FsDirEntryType *out_entry_type) {
-            R_RETURN(m_fs.GetEntryType(obj->GetName(), out_entry_type));
+            R_RETURN(m_fs.GetEntryType(path, out_entry_type));
         };
 
         /* Define helper for getting the object size. */
@@ -243,7 +251,7 @@ namespace haze {
 
             /* Otherwise, open as a file. */
             FsFile file;
-            R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Read, std::addressof(file)));
+            R_TRY(m_fs.OpenFile(path, FsOpenMode_Read, std::addressof(file)));
 
             /* Ensure we maintain a clean state on exit. */
             ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -322,7 +330,7 @@ namespace haze {
                     case PtpObjectPropertyCode_ObjectFileName:
                         {
                             R_TRY(db.Add(PtpDataTypeCode_String));
-                            R_TRY(db.AddString(std::strrchr(obj->GetName(), '/') + 1));
+                            R_TRY(db.AddString(obj->GetName()));
                         }
                         break;
                     HAZE_UNREACHABLE_DEFAULT_CASE();
@@ -360,6 +368,10 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* We are reading a file name. */
         R_TRY(dp.ReadString(m_buffers->filename_string_buffer));
         R_TRY(dp.Finalize());
@@ -369,47 +381,35 @@ namespace haze {
         const bool contains_slashes = std::strchr(m_buffers->filename_string_buffer, '/') != nullptr;
         R_UNLESS(!is_empty && !contains_slashes, haze::ResultInvalidPropertyValue());
 
-        /* Add a new object in the database with the new name. */
-        PtpObject *newobj;
+        /* Build the new path of the object, which remains in the same directory. */
+        char * const new_path = m_buffers->new_object_path_buffer;
         {
-            /* Find the last path separator in the existing object name. */
-            char *pathsep = std::strrchr(obj->m_name, '/');
+            /* Find the last path separator in the existing object path. */
+            const char *pathsep = std::strrchr(path, '/');
             HAZE_ASSERT(pathsep != nullptr);
 
-            /* Temporarily mark the path separator as null to facilitate processing. */
-            *pathsep = '\x00';
-            ON_SCOPE_EXIT { *pathsep = '/'; };
+            /* Ensure the new path fits. */
+            const size_t directory_len = pathsep - path + 1;
+            const size_t filename_len  = util::Strlen(m_buffers->filename_string_buffer);
+            R_UNLESS(directory_len + filename_len < FS_MAX_PATH, haze::ResultInvalidPropertyValue());
 
-            R_TRY(m_object_database.CreateOrFindObject(obj->GetName(), m_buffers->filename_string_buffer, obj->GetParentId(), std::addressof(newobj)));
+            std::memcpy(new_path, path, directory_len);
+            std::memcpy(new_path + directory_len, m_buffers->filename_string_buffer, filename_len + 1);
         }
 
-        {
-            /* Ensure we maintain a clean state on failure. */
-            ON_RESULT_FAILURE {
-                if (!newobj->GetIsRegistered()) {
-                    /* Only delete if the object was not registered. */
-                    /* Otherwise, we would remove an object that still exists. */
-                    m_object_database.DeleteObject(newobj);
-                }
-            };
+        /* Get the old object type. */
+        FsDirEntryType entry_type;
+        R_TRY(m_fs.GetEntryType(path, std::addressof(entry_type)));
 
-            /* Get the old object type. */
-            FsDirEntryType entry_type;
-            R_TRY(m_fs.GetEntryType(obj->GetName(), std::addressof(entry_type)));
-
-            /* Attempt to rename the object on the filesystem. */
-            if (entry_type == FsDirEntryType_Dir) {
-                R_TRY(m_fs.RenameDirectory(obj->GetName(), newobj->GetName()));
-            } else {
-                R_TRY(m_fs.RenameFile(obj->GetName(), newobj->GetName()));
-            }
+        /* Attempt to rename the object on the filesystem. */
+        if (entry_type == FsDirEntryType_Dir) {
+            R_TRY(m_fs.RenameDirectory(path, new_path));
+        } else {
+            R_TRY(m_fs.RenameFile(path, new_path));
         }
 
-        /* Unregister and free the old object. */
-        m_object_database.DeleteObject(obj);
-
-        /* Register the new object. */
-        m_object_database.RegisterObject(newobj, object_id);
+        /* Rename the object in the database. Its children refer to it by ID, and so move with it. */
+        R_TRY(m_object_database.RenameObject(obj, m_buffers->filename_string_buffer));
 
         /* Write the success response. */
         R_RETURN(this->WriteResponse(PtpResponseCode_Ok));
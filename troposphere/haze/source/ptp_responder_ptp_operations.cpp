@@ -59,7 +59,7 @@ namespace haze {
 
         /* Create the root storages. */
         PtpObject *object;
-        R_TRY(m_object_database.CreateOrFindObject("", "", PtpGetObjectHandles_RootParent, std::addressof(object)));
+        R_TRY(m_object_database.CreateOrFindObject(PtpGetObjectHandles_RootParent, "", std::addressof(object)));
 
         /* Register the root storages. */
         m_object_database.RegisterObject(object, StorageId_SdmcFs);
@@ -160,9 +160,16 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(association_object_handle);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
+        /* Note that the host is using the object's children, so that they are reclaimed last. */
+        m_object_database.MarkObjectEnumerated(obj);
+
         /* Try to read the object as a directory. */
         FsDir dir;
-        R_TRY(m_fs.OpenDirectory(obj->GetName(), FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles, std::addressof(dir)));
+        R_TRY(m_fs.OpenDirectory(path, FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles, std::addressof(dir)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseDirectory(std::addressof(dir)); };
@@ -188,7 +195,7 @@ namespace haze {
                 const char *name = m_buffers->file_system_entry_buffer[i].name;
                 u32 handle;
 
-                R_TRY(m_object_database.CreateAndRegisterObjectId(obj->GetName(), name, obj->GetObjectId(), std::addressof(handle)));
+                R_TRY(m_object_database.CreateAndRegisterObjectId(obj->GetObjectId(), name, std::addressof(handle)));
                 R_TRY(db.Add(handle));
             }
 
@@ -217,6 +224,10 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Build info about the object. */
         PtpObjectInfo object_info(DefaultObjectInfo);
 
@@ -228,13 +239,13 @@ namespace haze {
         } else {
             /* Figure out what type of object this is. */
             FsDirEntryType entry_type;
-            R_TRY(m_fs.GetEntryType(obj->GetName(), std::addressof(entry_type)));
+            R_TRY(m_fs.GetEntryType(path, std::addressof(entry_type)));
 
             /* Get the size, if we are requesting info about a file. */
             s64 size = 0;
             if (entry_type == FsDirEntryType_File) {
                 FsFile file;
-                R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Read, std::addressof(file)));
+                R_TRY(m_fs.OpenFile(path, FsOpenMode_Read, std::addressof(file)));
 
                 /* Ensure we maintain a clean state on exit. */
                 ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -242,7 +253,7 @@ namespace haze {
                 R_TRY(m_fs.GetFileSize(std::addressof(file), std::addressof(size)));
             }
 
-            object_info.filename               = std::strrchr(obj->GetName(), '/') + 1;
+            object_info.filename               = obj->GetName();
             object_info.object_compressed_size = size;
             object_info.parent_object          = obj->GetParentId();
 
@@ -285,7 +296,8 @@ namespace haze {
     }
 
     Result PtpResponder::GetObject(PtpDataParser &dp) {
-        PtpDataBuilder db(m_buffers->usb_bulk_write_buffer, std::addressof(m_usb_server));
+        /* The request is fully read before any data is written, so the read buffer is free to double-buffer the data phase. */
+        PtpDataBuilder db(m_buffers->usb_bulk_write_buffer, m_buffers->usb_bulk_read_buffer, std::addressof(m_usb_server));
 
         /* Get the object ID the client requested. */
         u32 object_id;
@@ -296,9 +308,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Lock the object as a file. */
         FsFile file;
-        R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Read, std::addressof(file)));
+        R_TRY(m_fs.OpenFile(path, FsOpenMode_Read, std::addressof(file)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -390,7 +406,7 @@ namespace haze {
 
         /* Create the object in the database. */
         PtpObject *obj;
-        R_TRY(m_object_database.CreateOrFindObject(parentobj->GetName(), m_buffers->filename_string_buffer, parentobj->GetObjectId(), std::addressof(obj)));
+        R_TRY(m_object_database.CreateOrFindObject(parentobj->GetObjectId(), m_buffers->filename_string_buffer, std::addressof(obj)));
 
         /* Ensure we maintain a clean state on failure. */
         ON_RESULT_FAILURE { m_object_database.DeleteObject(obj); };
@@ -399,13 +415,17 @@ namespace haze {
         m_object_database.RegisterObject(obj);
         new_object_info.object_id = obj->GetObjectId();
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Create the object on the filesystem. */
         if (info.object_format == PtpObjectFormatCode_Association) {
-            R_TRY(m_fs.CreateDirectory(obj->GetName()));
-            m_send_object_id = 0;
+            R_TRY(m_fs.CreateDirectory(path));
+            this->SetSendObjectId(0);
         } else {
-            R_TRY(m_fs.CreateFile(obj->GetName(), 0, 0));
-            m_send_object_id = new_object_info.object_id;
+            R_TRY(m_fs.CreateFile(path, 0, 0));
+            this->SetSendObjectId(new_object_info.object_id);
         }
 
         /* Write the success response. */
@@ -414,11 +434,12 @@ namespace haze {
 
     Result PtpResponder::SendObject(PtpDataParser &rdp) {
         /* Reset SendObject object ID on exit. */
-        ON_SCOPE_EXIT { m_send_object_id = 0; };
+        ON_SCOPE_EXIT { this->SetSendObjectId(0); };
 
         R_TRY(rdp.Finalize());
 
-        PtpDataParser dp(m_buffers->usb_bulk_read_buffer, std::addressof(m_usb_server));
+        /* Nothing is written until the data is fully received, so the write buffer is free to double-buffer the data phase. */
+        PtpDataParser dp(m_buffers->usb_bulk_read_buffer, m_buffers->usb_bulk_write_buffer, std::addressof(m_usb_server));
 
         /* Ensure we have a data header. */
         PtpUsbBulkContainer data_header;
@@ -431,9 +452,13 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(m_send_object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Lock the object as a file. */
         FsFile file;
-        R_TRY(m_fs.OpenFile(obj->GetName(), FsOpenMode_Write | FsOpenMode_Append, std::addressof(file)));
+        R_TRY(m_fs.OpenFile(path, FsOpenMode_Write | FsOpenMode_Append, std::addressof(file)));
 
         /* Ensure we maintain a clean state on exit. */
         ON_SCOPE_EXIT { m_fs.CloseFile(std::addressof(file)); };
@@ -486,19 +511,23 @@ namespace haze {
         auto * const obj = m_object_database.GetObjectById(object_id);
         R_UNLESS(obj != nullptr, haze::ResultInvalidObjectId());
 
+        /* Get the path of the object. */
+        char * const path = m_buffers->object_path_buffer;
+        R_TRY(m_object_database.GetObjectPath(obj, path));
+
         /* Figure out what type of object this is. */
         FsDirEntryType entry_type;
-        R_TRY(m_fs.GetEntryType(obj->GetName(), std::addressof(entry_type)));
+        R_TRY(m_fs.GetEntryType(path, std::addressof(entry_type)));
 
         /* Remove the object from the filesystem. */
         if (entry_type == FsDirEntryType_Dir) {
-            R_TRY(m_fs.DeleteDirectoryRecursively(obj->GetName()));
+            R_TRY(m_fs.DeleteDirectoryRecursively(path));
         } else {
-            R_TRY(m_fs.DeleteFile(obj->GetName()));
+            R_TRY(m_fs.DeleteFile(path));
         }
 
-        /* Remove the object from the database. */
-        m_object_database.DeleteObject(obj);
+        /* Remove the object and anything inside it from the database. */
+        m_object_database.DeleteObjectRecursively(obj);
 
         /* Write the success response. */
         R_RETURN(this->WriteResponse(PtpResponseCode_Ok));
@@ -0,0 +1,74 @@
+#
+# Copyright (c) Atmosphère-NX
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms and conditions of the GNU General Public License,
+# version 2, as published by the Free Software Foundation.
+#
+# This program is distributed in the hope it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# ktrace.py: Merges the per-core rings of a dumped mesosphere KTrace buffer into a single timeline.
+
+import sys, heapq
+from struct import unpack as up
+
+KTRACE_HEADER_MAGIC      = b'KTR1'
+KTRACE_HEADER_SIZE       = 0x40
+KTRACE_CORE_HEADER_SIZE  = 0x40
+KTRACE_RECORD_SIZE       = 0x40
+
+KTRACE_TYPE_NAMES = {
+    1:  'ThreadSwitch',
+    3:  'SvcEntry0',
+    4:  'SvcEntry1',
+    5:  'SvcExit0',
+    6:  'SvcExit1',
+    7:  'Interrupt',
+    11: 'ScheduleUpdate',
+    14: 'CoreMigration',
+}
+
+def read_core_records(data, offset, index, count):
+    # Records are written in order, so the oldest is at the current index once the ring has wrapped.
+    for i in list(range(index, count)) + list(range(0, index)):
+        ofs = offset + i * KTRACE_RECORD_SIZE
+        core_id, type, process_id, thread_id, tick = up('<BBHIQ', data[ofs:ofs + 0x10])
+        params = up('<6Q', data[ofs + 0x10:ofs + KTRACE_RECORD_SIZE])
+        # Unused records are zero.
+        if tick == 0:
+            continue
+        yield (tick, core_id, type, process_id, thread_id, params)
+
+def read_trace(data):
+    magic, num_cores = data[:4], up('<I', data[4:8])[0]
+    if magic != KTRACE_HEADER_MAGIC:
+        raise ValueError('Not a KTrace buffer')
+
+    rings = []
+    for core_id in range(num_cores):
+        ofs = KTRACE_HEADER_SIZE + core_id * KTRACE_CORE_HEADER_SIZE
+        offset, index, count = up('<III', data[ofs:ofs + 0xC])
+        rings.append(read_core_records(data, offset, index, count))
+
+    # Each ring is ordered by tick, so a merge yields the global order.
+    return heapq.merge(*rings, key=lambda record: record[0])
+
+def main(argc, argv):
+    if argc != 2:
+        print('Usage: %s ktrace.bin' % argv[0])
+        return 1
+    with open(argv[1], 'rb') as f:
+        data = f.read()
+    for tick, core_id, type, process_id, thread_id, params in read_trace(data):
+        type_name = KTRACE_TYPE_NAMES.get(type, 'Type%d' % type)
+        print('%016X core=%d pid=%04X tid=%08X %-14s %s' % (tick, core_id, process_id, thread_id, type_name, ' '.join('%016X' % p for p in params)))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(len(sys.argv), sys.argv))
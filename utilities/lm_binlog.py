@@ -0,0 +1,114 @@
+#
+# Copyright (c) Atmosphère-NX
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms and conditions of the GNU General Public License,
+# version 2, as published by the Free Software Foundation.
+#
+# This program is distributed in the hope it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# lm_binlog.py: Converts compressed lm sd card logs back into plain .nxbinlog files.
+
+import sys
+from struct import unpack as up, pack as pk
+
+# NOTE: The log file magics are stored byte-reversed.
+LOG_FILE_HEADER_MAGIC            = b'hphp'
+LOG_FILE_HEADER_MAGIC_COMPRESSED = b'zphp'
+LOG_FILE_HEADER_SIZE             = 8
+
+LOG_SEGMENT_HEADER_MAGIC = b'LZ4S'
+LOG_SEGMENT_HEADER_SIZE  = 0x10
+
+def lz4_decompress_block(src, size):
+    dst = bytearray()
+    ofs = 0
+    while ofs < len(src):
+        token = src[ofs]
+        ofs += 1
+
+        # Copy literals.
+        literal_length = token >> 4
+        if literal_length == 15:
+            while True:
+                b = src[ofs]
+                ofs += 1
+                literal_length += b
+                if b != 255:
+                    break
+        dst += src[ofs:ofs + literal_length]
+        ofs += literal_length
+
+        # The last sequence has no match.
+        if ofs >= len(src):
+            break
+
+        # Copy the match, which may overlap the output.
+        match_offset = up('<H', src[ofs:ofs + 2])[0]
+        ofs += 2
+        if match_offset == 0 or match_offset > len(dst):
+            raise ValueError('Invalid LZ4 match offset')
+
+        match_length = token & 0xF
+        if match_length == 15:
+            while True:
+                b = src[ofs]
+                ofs += 1
+                match_length += b
+                if b != 255:
+                    break
+        match_length += 4
+
+        start = len(dst) - match_offset
+        for i in range(match_length):
+            dst.append(dst[start + i])
+
+    if len(dst) != size:
+        raise ValueError('Invalid LZ4 block size (expected 0x%X, got 0x%X)' % (size, len(dst)))
+    return bytes(dst)
+
+def decompress_log(data):
+    magic, version = data[:4], data[4]
+    if magic == LOG_FILE_HEADER_MAGIC:
+        return data
+    if magic != LOG_FILE_HEADER_MAGIC_COMPRESSED:
+        raise ValueError('Not an lm binary log')
+
+    out = bytearray(LOG_FILE_HEADER_MAGIC + pk('<B', version) + data[5:LOG_FILE_HEADER_SIZE])
+    ofs = LOG_FILE_HEADER_SIZE
+    while ofs + LOG_SEGMENT_HEADER_SIZE <= len(data):
+        seg_magic = data[ofs:ofs + 4]
+        size, compressed_size, _ = up('<III', data[ofs + 4:ofs + LOG_SEGMENT_HEADER_SIZE])
+        if seg_magic != LOG_SEGMENT_HEADER_MAGIC:
+            raise ValueError('Invalid segment magic at 0x%X' % ofs)
+        ofs += LOG_SEGMENT_HEADER_SIZE
+
+        # A zero compressed size means the segment is stored uncompressed.
+        stored_size = compressed_size if compressed_size != 0 else size
+        if ofs + stored_size > len(data):
+            # The log was cut off mid-segment, so we're done.
+            break
+        payload = data[ofs:ofs + stored_size]
+        ofs += stored_size
+
+        out += lz4_decompress_block(payload, size) if compressed_size != 0 else payload
+    return bytes(out)
+
+def main(argc, argv):
+    if argc != 3:
+        print('Usage: %s in.nxbinlog out.nxbinlog' % argv[0])
+        return 1
+    with open(argv[1], 'rb') as f:
+        data = f.read()
+    with open(argv[2], 'wb') as f:
+        f.write(decompress_log(data))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(len(sys.argv), sys.argv))